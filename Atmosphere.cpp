@@ -0,0 +1,358 @@
+#include "Atmosphere.h"
+#include "GLState.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+const float Atmosphere::kSkyViewRefreshAngle = 0.5f * 3.14159265f / 180.0f;
+
+namespace
+{
+    // Model atmosfery Ziemi w kilometrach (współczynniki jak w Bruneton 2017 / Hillaire 2020)
+    const float kPi = 3.14159265f;
+    const float kGroundRadius = 6360.0f;
+    const float kTopRadius = 6460.0f;
+    const glm::vec3 kRayleighScattering(5.802e-3f, 13.558e-3f, 33.1e-3f);
+    const float kRayleighScaleHeight = 8.0f;
+    const float kMieScattering = 3.996e-3f;
+    const float kMieExtinction = 4.440e-3f;
+    const float kMieScaleHeight = 1.2f;
+    const float kMieAsymmetry = 0.8f;
+    const glm::vec3 kOzoneAbsorption(0.650e-3f, 1.881e-3f, 0.085e-3f);
+    const float kOzoneCenterHeight = 25.0f;
+    const float kOzoneHalfWidth = 15.0f;
+    const glm::vec3 kGroundAlbedo(0.3f);
+    const float kViewerHeight = 0.2f;    // scena leży tuż nad poziomem gruntu
+    const float kSunIlluminance = 25.0f; // skala jasności - skybox.frag mapuje wynik przez 1 - exp(-L)
+
+    const int kTransmittanceSteps = 40;
+    const int kMultiScatteringSteps = 20;
+    const int kMultiScatteringDirections = 8; // 8 x 8 kierunków na sferze
+    const int kSkyViewSteps = 32;
+
+    struct MediumSample
+    {
+        glm::vec3 rayleighScattering;
+        float mieScattering;
+        glm::vec3 extinction;
+    };
+
+    MediumSample sampleMedium(float height)
+    {
+        const float rayleighDensity = std::exp(-height / kRayleighScaleHeight);
+        const float mieDensity = std::exp(-height / kMieScaleHeight);
+        const float ozoneDensity = std::max(0.0f, 1.0f - std::abs(height - kOzoneCenterHeight) / kOzoneHalfWidth);
+        MediumSample sample;
+        sample.rayleighScattering = kRayleighScattering * rayleighDensity;
+        sample.mieScattering = kMieScattering * mieDensity;
+        sample.extinction = sample.rayleighScattering + glm::vec3(kMieExtinction * mieDensity) + kOzoneAbsorption * ozoneDensity;
+        return sample;
+    }
+
+    float rayleighPhase(float cosTheta)
+    {
+        return 3.0f / (16.0f * kPi) * (1.0f + cosTheta * cosTheta);
+    }
+
+    // Cornette-Shanks
+    float miePhase(float cosTheta)
+    {
+        const float g = kMieAsymmetry;
+        const float denominator = std::max(1e-4f, 1.0f + g * g - 2.0f * g * cosTheta);
+        return 3.0f / (8.0f * kPi) * (1.0f - g * g) * (1.0f + cosTheta * cosTheta) / ((2.0f + g * g) * denominator * std::sqrt(denominator));
+    }
+
+    // Odległość od punktu na promieniu r (kierunek o cosinusie zenitu mu) do wyjścia ze sfery radius; < 0, gdy brak przecięcia
+    float distanceToTop(float r, float mu, float radius)
+    {
+        const float discriminant = r * r * (mu * mu - 1.0f) + radius * radius;
+        return discriminant < 0.0f ? -1.0f : -r * mu + std::sqrt(discriminant);
+    }
+
+    // Odległość do gruntu albo -1, gdy promień go nie trafia
+    float distanceToGround(float r, float mu)
+    {
+        if (mu >= 0.0f) return -1.0f;
+        const float discriminant = r * r * (mu * mu - 1.0f) + kGroundRadius * kGroundRadius;
+        return discriminant < 0.0f ? -1.0f : -r * mu - std::sqrt(discriminant);
+    }
+
+    // Parametryzacja tablicy transmitancji (Bruneton): x - odległość do górnej granicy, y - sqrt(r^2 - R^2)
+    // - rozdzielczość skupiona przy horyzoncie i przy gruncie, promienie poniżej horyzontu nie są potrzebne
+    const float kHorizonDistance = std::sqrt(kTopRadius * kTopRadius - kGroundRadius * kGroundRadius);
+
+    void transmittanceUvToRMu(float u, float v, float& r, float& mu)
+    {
+        const float rho = kHorizonDistance * v;
+        r = std::sqrt(rho * rho + kGroundRadius * kGroundRadius);
+        const float minDistance = kTopRadius - r;
+        const float maxDistance = rho + kHorizonDistance;
+        const float distance = minDistance + u * (maxDistance - minDistance);
+        mu = distance == 0.0f ? 1.0f : (kHorizonDistance * kHorizonDistance - rho * rho - distance * distance) / (2.0f * r * distance);
+        mu = std::min(1.0f, std::max(-1.0f, mu));
+    }
+
+    void transmittanceRMuToUv(float r, float mu, float& u, float& v)
+    {
+        const float rho = std::sqrt(std::max(0.0f, r * r - kGroundRadius * kGroundRadius));
+        const float distance = std::max(0.0f, distanceToTop(r, mu, kTopRadius));
+        const float minDistance = kTopRadius - r;
+        const float maxDistance = rho + kHorizonDistance;
+        u = maxDistance > minDistance ? (distance - minDistance) / (maxDistance - minDistance) : 0.0f;
+        v = rho / kHorizonDistance;
+    }
+
+    // Próbkowanie dwuliniowe tablicy size x height, u i v w [0, 1] na środki skrajnych tekseli
+    glm::vec3 sampleTable(const std::vector<glm::vec3>& table, int width, int height, float u, float v)
+    {
+        const float x = std::min(1.0f, std::max(0.0f, u)) * (width - 1);
+        const float y = std::min(1.0f, std::max(0.0f, v)) * (height - 1);
+        const int x0 = std::min((int)x, width - 2);
+        const int y0 = std::min((int)y, height - 2);
+        const float fx = x - x0;
+        const float fy = y - y0;
+        const glm::vec3 top = glm::mix(table[y0 * width + x0], table[y0 * width + x0 + 1], fx);
+        const glm::vec3 bottom = glm::mix(table[(y0 + 1) * width + x0], table[(y0 + 1) * width + x0 + 1], fx);
+        return glm::mix(top, bottom, fy);
+    }
+
+    // Transmitancja od punktu (r, cos zenitu słońca) do słońca; 0, gdy słońce jest pod horyzontem tego punktu
+    glm::vec3 sunTransmittance(const AtmosphereTables& tables, float r, float sunMu)
+    {
+        if (distanceToGround(r, sunMu) >= 0.0f) return glm::vec3(0.0f);
+        float u, v;
+        transmittanceRMuToUv(r, sunMu, u, v);
+        return sampleTable(tables.transmittance, Atmosphere::kTransmittanceWidth, Atmosphere::kTransmittanceHeight, u, v);
+    }
+
+    glm::vec3 multiScatteringAt(const AtmosphereTables& tables, float r, float sunMu)
+    {
+        const float u = sunMu * 0.5f + 0.5f;
+        const float v = (r - kGroundRadius) / (kTopRadius - kGroundRadius);
+        return sampleTable(tables.multiScattering, Atmosphere::kMultiScatteringSize, Atmosphere::kMultiScatteringSize, u, v);
+    }
+
+    // Całkowanie odcinka przy stałym współczynniku ekstynkcji: int_0^dt T(t) S dt = S (1 - exp(-e dt)) / e
+    glm::vec3 integrateStep(const glm::vec3& source, const glm::vec3& extinction, const glm::vec3& stepTransmittance)
+    {
+        glm::vec3 result;
+        for (int channel = 0; channel < 3; ++channel) {
+            result[channel] = extinction[channel] > 0.0f ? source[channel] * (1.0f - stepTransmittance[channel]) / extinction[channel] : 0.0f;
+        }
+        return result;
+    }
+
+    glm::vec3 exp3(const glm::vec3& value)
+    {
+        return glm::vec3(std::exp(value.x), std::exp(value.y), std::exp(value.z));
+    }
+
+    void buildTransmittance(ThreadPool& pool, AtmosphereTables& tables)
+    {
+        const int width = Atmosphere::kTransmittanceWidth;
+        const int height = Atmosphere::kTransmittanceHeight;
+        tables.transmittance.resize((size_t)width * height);
+        pool.ParallelFor(0, height, 4, [&](int rowBegin, int rowEnd) {
+            for (int y = rowBegin; y < rowEnd; ++y) {
+                for (int x = 0; x < width; ++x) {
+                    float r, mu;
+                    transmittanceUvToRMu((float)x / (width - 1), (float)y / (height - 1), r, mu);
+                    const float length = std::max(0.0f, distanceToTop(r, mu, kTopRadius));
+                    const float dt = length / kTransmittanceSteps;
+                    glm::vec3 opticalDepth(0.0f);
+                    for (int i = 0; i < kTransmittanceSteps; ++i) {
+                        const float t = (i + 0.5f) * dt;
+                        const float sampleRadius = std::sqrt(r * r + t * t + 2.0f * r * mu * t);
+                        opticalDepth += sampleMedium(sampleRadius - kGroundRadius).extinction * dt;
+                    }
+                    tables.transmittance[(size_t)y * width + x] = exp3(-opticalDepth);
+                }
+            }
+        });
+    }
+
+    // Rozpraszanie wielokrotne w przybliżeniu Hillaire'a: drugi rząd rozproszenia z fazą izotropową
+    // i szereg geometryczny 1 / (1 - f_ms) dla wyższych rzędów
+    void buildMultiScattering(ThreadPool& pool, AtmosphereTables& tables)
+    {
+        const int size = Atmosphere::kMultiScatteringSize;
+        const int directionCount = kMultiScatteringDirections * kMultiScatteringDirections;
+        const float isotropicPhase = 1.0f / (4.0f * kPi);
+        tables.multiScattering.resize((size_t)size * size);
+        pool.ParallelFor(0, size, 1, [&](int rowBegin, int rowEnd) {
+            for (int y = rowBegin; y < rowEnd; ++y) {
+                const float r = kGroundRadius + std::min(kTopRadius - kGroundRadius - 0.01f, std::max(0.01f, (float)y / (size - 1) * (kTopRadius - kGroundRadius)));
+                for (int x = 0; x < size; ++x) {
+                    const float sunMu = (float)x / (size - 1) * 2.0f - 1.0f;
+                    const glm::vec3 sunDirection(std::sqrt(std::max(0.0f, 1.0f - sunMu * sunMu)), sunMu, 0.0f);
+                    const glm::vec3 origin(0.0f, r, 0.0f);
+                    glm::vec3 secondOrder(0.0f);
+                    glm::vec3 transfer(0.0f);
+                    for (int d = 0; d < directionCount; ++d) {
+                        // Kierunki o równym kącie bryłowym: cos theta równomiernie w [-1, 1]
+                        const float cosTheta = 1.0f - 2.0f * ((d / kMultiScatteringDirections) + 0.5f) / kMultiScatteringDirections;
+                        const float phi = 2.0f * kPi * ((d % kMultiScatteringDirections) + 0.5f) / kMultiScatteringDirections;
+                        const float sinTheta = std::sqrt(std::max(0.0f, 1.0f - cosTheta * cosTheta));
+                        const glm::vec3 direction(sinTheta * std::cos(phi), cosTheta, sinTheta * std::sin(phi));
+
+                        const float groundDistance = distanceToGround(r, cosTheta);
+                        const float length = groundDistance >= 0.0f ? groundDistance : std::max(0.0f, distanceToTop(r, cosTheta, kTopRadius));
+                        const float dt = length / kMultiScatteringSteps;
+                        glm::vec3 throughput(1.0f);
+                        glm::vec3 radiance(0.0f);
+                        glm::vec3 scatteredFraction(0.0f);
+                        for (int i = 0; i < kMultiScatteringSteps; ++i) {
+                            const glm::vec3 position = origin + direction * ((i + 0.5f) * dt);
+                            const float sampleRadius = glm::length(position);
+                            const MediumSample medium = sampleMedium(sampleRadius - kGroundRadius);
+                            const glm::vec3 scattering = medium.rayleighScattering + glm::vec3(medium.mieScattering);
+                            const glm::vec3 stepTransmittance = exp3(-medium.extinction * dt);
+                            const float sampleSunMu = glm::dot(position / sampleRadius, sunDirection);
+                            const glm::vec3 source = sunTransmittance(tables, sampleRadius, sampleSunMu) * scattering * isotropicPhase;
+                            radiance += throughput * integrateStep(source, medium.extinction, stepTransmittance);
+                            scatteredFraction += throughput * integrateStep(scattering, medium.extinction, stepTransmittance);
+                            throughput *= stepTransmittance;
+                        }
+                        if (groundDistance >= 0.0f) {
+                            // Światło odbite od gruntu (lambertowsko) też wchodzi w rozpraszanie wielokrotne
+                            const glm::vec3 groundPoint = origin + direction * groundDistance;
+                            const glm::vec3 normal = glm::normalize(groundPoint);
+                            const float sunCos = glm::dot(normal, sunDirection);
+                            radiance += throughput * sunTransmittance(tables, kGroundRadius, sunCos) * std::max(0.0f, sunCos) * kGroundAlbedo / kPi;
+                        }
+                        secondOrder += radiance / (float)directionCount;
+                        transfer += scatteredFraction / (float)directionCount;
+                    }
+                    tables.multiScattering[(size_t)y * size + x] = secondOrder / (glm::vec3(1.0f) - transfer);
+                }
+            }
+        });
+    }
+
+    // Wysokość kątowa widoku dla wiersza tablicy widoku nieba: kwadratowo gęściej przy horyzoncie (v = 0.5)
+    float skyViewElevation(float v)
+    {
+        const float centered = v * 2.0f - 1.0f;
+        return (centered < 0.0f ? -1.0f : 1.0f) * centered * centered * (0.5f * kPi);
+    }
+
+    std::vector<float> buildSkyView(ThreadPool& pool, const AtmosphereTables& tables, float sunElevation)
+    {
+        const int width = Atmosphere::kSkyViewWidth;
+        const int height = Atmosphere::kSkyViewHeight;
+        std::vector<float> texels((size_t)width * height * 3);
+        const glm::vec3 sunDirection(std::cos(sunElevation), std::sin(sunElevation), 0.0f);
+        const float r = kGroundRadius + kViewerHeight;
+        const glm::vec3 origin(0.0f, r, 0.0f);
+        pool.ParallelFor(0, height, 4, [&](int rowBegin, int rowEnd) {
+            for (int y = rowBegin; y < rowEnd; ++y) {
+                const float elevation = skyViewElevation((float)y / (height - 1));
+                const float viewMu = std::sin(elevation);
+                const float groundDistance = distanceToGround(r, viewMu);
+                const float length = groundDistance >= 0.0f ? groundDistance : std::max(0.0f, distanceToTop(r, viewMu, kTopRadius));
+                for (int x = 0; x < width; ++x) {
+                    const float azimuth = (float)x / (width - 1) * kPi; // 0 - w stronę słońca
+                    const glm::vec3 direction(std::cos(elevation) * std::cos(azimuth), viewMu, std::cos(elevation) * std::sin(azimuth));
+                    const float cosTheta = glm::dot(direction, sunDirection);
+                    const float phaseRayleigh = rayleighPhase(cosTheta);
+                    const float phaseMie = miePhase(cosTheta);
+
+                    // Kroki rosnące kwadratowo - promienie przy horyzoncie mają setki kilometrów, większość rozpraszania jest blisko
+                    glm::vec3 throughput(1.0f);
+                    glm::vec3 radiance(0.0f);
+                    float previousT = 0.0f;
+                    for (int i = 0; i < kSkyViewSteps; ++i) {
+                        const float f = (float)(i + 1) / kSkyViewSteps;
+                        const float t = length * f * f;
+                        const float dt = t - previousT;
+                        const glm::vec3 position = origin + direction * (previousT + 0.5f * dt);
+                        previousT = t;
+                        const float sampleRadius = glm::length(position);
+                        const MediumSample medium = sampleMedium(sampleRadius - kGroundRadius);
+                        const glm::vec3 stepTransmittance = exp3(-medium.extinction * dt);
+                        const float sampleSunMu = glm::dot(position / sampleRadius, sunDirection);
+                        const glm::vec3 singleScattering = sunTransmittance(tables, sampleRadius, sampleSunMu)
+                            * (medium.rayleighScattering * phaseRayleigh + glm::vec3(medium.mieScattering * phaseMie));
+                        const glm::vec3 multipleScattering = multiScatteringAt(tables, sampleRadius, sampleSunMu)
+                            * (medium.rayleighScattering + glm::vec3(medium.mieScattering));
+                        radiance += throughput * integrateStep(singleScattering + multipleScattering, medium.extinction, stepTransmittance);
+                        throughput *= stepTransmittance;
+                    }
+                    radiance *= kSunIlluminance;
+                    float* texel = &texels[((size_t)y * width + x) * 3];
+                    texel[0] = radiance.r;
+                    texel[1] = radiance.g;
+                    texel[2] = radiance.b;
+                }
+            }
+        });
+        return texels;
+    }
+}
+
+Atmosphere::Atmosphere(ThreadPool& pool, GLuint slot)
+    : ID(0), unit(slot), pool(pool), pendingElevation(0.0f), uploadedElevation(0.0f), ready(false), refreshCount(0)
+{
+    ThreadPool* workers = &pool;
+    pendingTables = pool.Submit([workers]() {
+        std::shared_ptr<AtmosphereTables> built = std::make_shared<AtmosphereTables>();
+        buildTransmittance(*workers, *built);
+        buildMultiScattering(*workers, *built); // korzysta z gotowej transmitancji
+        return std::shared_ptr<const AtmosphereTables>(built);
+    });
+
+    glGenTextures(1, &ID);
+    GLState::BindTexture(unit, GL_TEXTURE_2D, ID);
+    GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, kSkyViewWidth, kSkyViewHeight, 0, GL_RGB, GL_FLOAT, nullptr);
+}
+
+void Atmosphere::Update(const glm::vec3& sunDirection, bool wait)
+{
+    if (!tables) {
+        if (!pendingTables.valid()) return;
+        if (!wait && pendingTables.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return;
+        tables = pendingTables.get();
+    }
+
+    if (pendingSkyView.valid()) {
+        if (!wait && pendingSkyView.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return;
+        std::vector<float> texels = pendingSkyView.get();
+        GLState::BindTexture(unit, GL_TEXTURE_2D, ID);
+        GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, kSkyViewWidth, kSkyViewHeight, GL_RGB, GL_FLOAT, texels.data());
+        uploadedElevation = pendingElevation;
+        ready = true;
+        ++refreshCount;
+    }
+
+    // Tablica zależy tylko od wysokości słońca (azymut liczy shader) - drobne ruchy słońca jej nie unieważniają
+    const glm::vec3 direction = glm::normalize(sunDirection);
+    const float elevation = std::asin(std::min(1.0f, std::max(-1.0f, direction.y)));
+    if (ready && std::abs(elevation - uploadedElevation) < kSkyViewRefreshAngle) return;
+
+    std::shared_ptr<const AtmosphereTables> sharedTables = tables;
+    ThreadPool* workers = &pool;
+    pendingElevation = elevation;
+    pendingSkyView = pool.Submit([workers, sharedTables, elevation]() {
+        return buildSkyView(*workers, *sharedTables, elevation);
+    });
+    if (wait) Update(sunDirection, true); // wysyła policzoną tablicę; drugie przejście nie zleca już niczego
+}
+
+void Atmosphere::Bind()
+{
+    if (ID == 0) return;
+    GLState::BindTexture(unit, GL_TEXTURE_2D, ID);
+}
+
+void Atmosphere::Delete()
+{
+    if (ID) GLState::DeleteTexture(ID);
+    ID = 0;
+    ready = false;
+}
@@ -0,0 +1,65 @@
+#ifndef ATMOSPHERE_CLASS_H
+#define ATMOSPHERE_CLASS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <future>
+#include <memory>
+#include "ThreadPool.h"
+
+// Tablice pomocnicze modelu atmosfery (Rayleigh, Mie, ozon) - liczone raz, potem tylko do odczytu
+struct AtmosphereTables
+{
+    std::vector<glm::vec3> transmittance;  // kTransmittanceWidth x kTransmittanceHeight: (cos zenitu, wysokość)
+    std::vector<glm::vec3> multiScattering; // kMultiScatteringSize^2: (cos zenitu słońca, wysokość)
+};
+
+// Niebo z fizycznego modelu rozpraszania w atmosferze, sprzężone z pozycją słońca w cyklu dnia i nocy.
+//  - tablice transmitancji i rozpraszania wielokrotnego: raz przy starcie, w zadaniu puli (ParallelFor po wierszach),
+//  - tablica widoku nieba (azymut względem słońca x wysokość kątowa, GL_RGB16F): przeliczana w puli tylko wtedy,
+//    gdy słońce przesunie się o więcej niż kSkyViewRefreshAngle od ostatniego przeliczenia,
+//  - skybox.frag robi jedno próbkowanie tablicy widoku na piksel (skyViewLut na jednostce unit).
+// Wszystkie wywołania GL odbywają się w konstruktorze, Update i Delete, na wątku z kontekstem.
+class Atmosphere
+{
+public:
+    static const int kTransmittanceWidth = 256;
+    static const int kTransmittanceHeight = 64;
+    static const int kMultiScatteringSize = 32;
+    static const int kSkyViewWidth = 192;   // azymut 0..pi (niebo jest symetryczne względem płaszczyzny słońca)
+    static const int kSkyViewHeight = 108;  // wysokość kątowa -pi/2..pi/2, gęściej przy horyzoncie
+    static const float kSkyViewRefreshAngle; // radiany
+
+    GLuint ID;   // tablica widoku nieba
+    GLuint unit;
+
+    Atmosphere(ThreadPool& pool, GLuint slot);
+
+    // Wołać raz na klatkę z kierunkiem do słońca: odbiera gotowe zadania, wysyła nową tablicę widoku
+    // i w razie potrzeby zleca następne przeliczenie
+    void Update(const glm::vec3& sunDirection) { Update(sunDirection, false); }
+    // Jak Update, ale czeka na tablice i na przeliczenie - niebo zawsze dla bieżącego słońca (benchmark, obrazy wzorcowe)
+    void Finish(const glm::vec3& sunDirection) { Update(sunDirection, true); }
+
+    // true, gdy ID zawiera policzone niebo (wcześniej Skybox rysuje samą cubemapę)
+    bool IsReady() const { return ready; }
+    int RefreshCount() const { return refreshCount; }
+
+    void Bind();
+    void Delete();
+
+private:
+    ThreadPool& pool;
+    std::future<std::shared_ptr<const AtmosphereTables>> pendingTables;
+    std::shared_ptr<const AtmosphereTables> tables;
+    std::future<std::vector<float>> pendingSkyView;
+    float pendingElevation;   // wysokość słońca zlecona w pendingSkyView
+    float uploadedElevation;  // wysokość słońca, dla której policzono ID
+    bool ready;
+    int refreshCount;
+
+    void Update(const glm::vec3& sunDirection, bool wait);
+};
+
+#endif
@@ -0,0 +1,276 @@
+#include "Benchmark.h"
+#include "GLState.h"
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+
+namespace
+{
+    struct Summary
+    {
+        double min = 0.0;
+        double mean = 0.0;
+        double max = 0.0;
+        double p50 = 0.0;
+        double p90 = 0.0;
+        double p95 = 0.0;
+        double p99 = 0.0;
+        double total = 0.0;
+    };
+
+    // Percentyle jako ranga najbliższa - ta sama definicja co w Profiler
+    template<class T>
+    Summary summarize(const std::vector<T>& values)
+    {
+        Summary summary;
+        if (values.empty()) return summary;
+        std::vector<double> sorted(values.begin(), values.end());
+        std::sort(sorted.begin(), sorted.end());
+        for (double value : sorted) summary.total += value;
+        auto percentile = [&](double p) {
+            const size_t rank = (size_t)std::ceil(p * sorted.size());
+            return sorted[std::max<size_t>(rank, 1) - 1];
+        };
+        summary.min = sorted.front();
+        summary.max = sorted.back();
+        summary.mean = summary.total / sorted.size();
+        summary.p50 = percentile(0.50);
+        summary.p90 = percentile(0.90);
+        summary.p95 = percentile(0.95);
+        summary.p99 = percentile(0.99);
+        return summary;
+    }
+
+    void writeJsonString(std::ostream& out, const std::string& text)
+    {
+        out << '"';
+        for (char c : text) {
+            if (c == '"' || c == '\\') out << '\\';
+            out << c;
+        }
+        out << '"';
+    }
+
+    void writeSummary(std::ostream& out, const char* name, const Summary& summary, bool withTotal)
+    {
+        out << "  \"" << name << "\": { \"min\": " << summary.min << ", \"mean\": " << summary.mean << ", \"p50\": " << summary.p50
+            << ", \"p90\": " << summary.p90 << ", \"p95\": " << summary.p95 << ", \"p99\": " << summary.p99 << ", \"max\": " << summary.max;
+        if (withTotal) out << ", \"total\": " << summary.total;
+        out << " }";
+    }
+
+    bool parseInt(const char* text, int minimum, int& value)
+    {
+        char* end = nullptr;
+        const long parsed = std::strtol(text, &end, 10);
+        if (end == text || *end != '\0' || parsed < minimum) return false;
+        value = (int)parsed;
+        return true;
+    }
+
+    bool parseDouble(const char* text, double minimum, double& value)
+    {
+        char* end = nullptr;
+        const double parsed = std::strtod(text, &end);
+        if (end == text || *end != '\0' || !(parsed >= minimum)) return false;
+        value = parsed;
+        return true;
+    }
+
+    // platform / contextApi == 0: domyślne GLFW
+    GLFWwindow* tryCreateContext(int platform, int contextApi, int width, int height)
+    {
+#ifdef GLFW_PLATFORM
+        glfwInitHint(GLFW_PLATFORM, platform != 0 ? platform : GLFW_ANY_PLATFORM);
+#endif
+        if (!glfwInit()) return nullptr;
+        glfwDefaultWindowHints();
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+#ifdef GLFW_CONTEXT_CREATION_API
+        if (contextApi != 0) glfwWindowHint(GLFW_CONTEXT_CREATION_API, contextApi);
+#endif
+        GLFWwindow* window = glfwCreateWindow(width, height, "gk2025 benchmark", NULL, NULL);
+        if (!window) glfwTerminate();
+        return window;
+    }
+}
+
+bool parseBenchmarkArguments(int argc, char** argv, BenchmarkSettings& settings, std::string& failure)
+{
+    bool framesGiven = false;
+    bool warmupGiven = false;
+    bool outputGiven = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (argument == "--benchmark" && hasValue) {
+            settings.enabled = true;
+            settings.cameraPathFile = argv[++i];
+        }
+        else if (argument == "--frames" && hasValue) {
+            if (!parseInt(argv[++i], 1, settings.frames)) { failure = "--frames: oczekiwano liczby klatek > 0"; return false; }
+            framesGiven = true;
+        }
+        else if (argument == "--warmup" && hasValue) {
+            if (!parseInt(argv[++i], 0, settings.warmupFrames)) { failure = "--warmup: oczekiwano liczby klatek >= 0"; return false; }
+            warmupGiven = true;
+        }
+        else if (argument == "--dt" && hasValue) {
+            double timeStep = 0.0;
+            if (!parseDouble(argv[++i], 0.0, timeStep) || !(timeStep > 0.0)) { failure = "--dt: oczekiwano kroku czasu > 0 (sekundy)"; return false; }
+            settings.timeStep = timeStep;
+        }
+        else if (argument == "--out" && hasValue) {
+            settings.outputFile = argv[++i];
+            outputGiven = true;
+        }
+        else if (argument == "--regress" && hasValue) {
+            settings.enabled = true;
+            settings.regressionPosesFile = argv[++i];
+        }
+        else if (argument == "--golden" && hasValue) {
+            settings.goldenDirectory = argv[++i];
+        }
+        else if (argument == "--diff-dir" && hasValue) {
+            settings.diffDirectory = argv[++i];
+        }
+        else if (argument == "--update-golden") {
+            settings.updateGolden = true;
+        }
+        else if (argument == "--max-slowdown" && hasValue) {
+            if (!parseDouble(argv[++i], 1.0, settings.maxSlowdown)) { failure = "--max-slowdown: oczekiwano stosunku >= 1"; return false; }
+        }
+        else if (argument == "--pixel-threshold" && hasValue) {
+            if (!parseDouble(argv[++i], 0.0, settings.pixelThreshold) || settings.pixelThreshold > 1.0) {
+                failure = "--pixel-threshold: oczekiwano wartości 0..1";
+                return false;
+            }
+        }
+        else if (argument == "--max-diff-pixels" && hasValue) {
+            if (!parseDouble(argv[++i], 0.0, settings.maxDifferentPixels) || settings.maxDifferentPixels > 1.0) {
+                failure = "--max-diff-pixels: oczekiwano ułamka 0..1";
+                return false;
+            }
+        }
+        else {
+            failure = "nieznany argument albo brak wartości: " + argument;
+            return false;
+        }
+    }
+    if (!settings.enabled && argc > 1) {
+        failure = "opcje benchmarku wymagają --benchmark <ścieżka kamery> albo --regress <ujęcia>";
+        return false;
+    }
+    if (!settings.cameraPathFile.empty() && !settings.regressionPosesFile.empty()) {
+        failure = "--benchmark i --regress wykluczają się";
+        return false;
+    }
+    if (!settings.regressionPosesFile.empty() && outputGiven) {
+        failure = "--out to plik JSON benchmarku; w trybie regresji katalog obrazów różnic ustawia --diff-dir";
+        return false;
+    }
+    if (!settings.regressionPosesFile.empty()) {
+        // Ujęcia są nieruchome - wystarczy krótszy pomiar na każde ujęcie i tryb
+        if (!framesGiven) settings.frames = BenchmarkSettings::kRegressionFrames;
+        if (!warmupGiven) settings.warmupFrames = BenchmarkSettings::kRegressionWarmupFrames;
+    }
+    return true;
+}
+
+GLFWwindow* createOffscreenContext(int width, int height, std::string& description)
+{
+    GLFWwindow* window = nullptr;
+#if defined(GLFW_PLATFORM_NULL)
+    window = tryCreateContext(GLFW_PLATFORM_NULL, GLFW_OSMESA_CONTEXT_API, width, height);
+    if (window) {
+        description = "GLFW null + OSMesa";
+        return window;
+    }
+    window = tryCreateContext(GLFW_PLATFORM_NULL, GLFW_EGL_CONTEXT_API, width, height);
+    if (window) {
+        description = "GLFW null + EGL";
+        return window;
+    }
+#endif
+    window = tryCreateContext(0, 0, width, height);
+    if (window) description = "ukryte okno";
+    return window;
+}
+
+BenchmarkRecorder::BenchmarkRecorder()
+    : drawCallsAtStart(0), trianglesAtStart(0)
+{
+}
+
+void BenchmarkRecorder::BeginFrame()
+{
+    frameStart = Clock::now();
+    drawCallsAtStart = GLState::DrawCalls();
+    trianglesAtStart = GLState::Triangles();
+}
+
+void BenchmarkRecorder::EndFrame()
+{
+    glFinish();
+    frameMilliseconds.push_back(std::chrono::duration<double, std::milli>(Clock::now() - frameStart).count());
+    drawCalls.push_back(GLState::DrawCalls() - drawCallsAtStart);
+    triangles.push_back(GLState::Triangles() - trianglesAtStart);
+}
+
+double BenchmarkRecorder::FrameTime(double percentile) const
+{
+    if (frameMilliseconds.empty()) return 0.0;
+    std::vector<double> sorted(frameMilliseconds);
+    std::sort(sorted.begin(), sorted.end());
+    const size_t rank = (size_t)std::ceil(percentile * sorted.size());
+    return sorted[std::min(std::max<size_t>(rank, 1), sorted.size()) - 1];
+}
+
+void BenchmarkRecorder::PrintSummary(std::ostream& out) const
+{
+    const Summary frame = summarize(frameMilliseconds);
+    const Summary draws = summarize(drawCalls);
+    const Summary tris = summarize(triangles);
+    const std::ios::fmtflags flags = out.flags();
+    const std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(3);
+    out << "Benchmark: " << frameMilliseconds.size() << " klatek, ms p50 " << frame.p50 << ", p90 " << frame.p90 << ", p99 " << frame.p99
+        << ", max " << frame.max << "; na klatkę " << draws.mean << " wywołań rysowania, " << tris.mean << " trójkątów" << std::endl;
+    out.flags(flags);
+    out.precision(precision);
+}
+
+bool BenchmarkRecorder::WriteJson(const std::string& path, const BenchmarkSettings& settings, const std::string& context,
+                                  int width, int height) const
+{
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) return false;
+    const char* renderer = (const char*)glGetString(GL_RENDERER);
+    const char* version = (const char*)glGetString(GL_VERSION);
+    file << std::fixed << std::setprecision(4);
+    file << "{\n  \"renderer\": ";
+    writeJsonString(file, renderer ? renderer : "");
+    file << ",\n  \"version\": ";
+    writeJsonString(file, version ? version : "");
+    file << ",\n  \"context\": ";
+    writeJsonString(file, context);
+    file << ",\n  \"camera_path\": ";
+    writeJsonString(file, settings.cameraPathFile);
+    file << ",\n  \"width\": " << width << ",\n  \"height\": " << height
+         << ",\n  \"frames\": " << frameMilliseconds.size() << ",\n  \"warmup_frames\": " << settings.warmupFrames
+         << ",\n  \"time_step\": " << settings.timeStep << ",\n";
+    writeSummary(file, "frame_ms", summarize(frameMilliseconds), true);
+    file << ",\n";
+    writeSummary(file, "draw_calls", summarize(drawCalls), true);
+    file << ",\n";
+    writeSummary(file, "triangles", summarize(triangles), true);
+    file << "\n}\n";
+    return (bool)file;
+}
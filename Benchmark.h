@@ -0,0 +1,78 @@
+#ifndef BENCHMARK_CLASS_H
+#define BENCHMARK_CLASS_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <ostream>
+
+struct GLFWwindow;
+
+// Tryb pomiarowy bez ekranu: kamera ze ścieżki (CameraPath), stały krok zegara symulacji, N klatek, wynik w JSON.
+//   gk2025 --benchmark sciezka.txt [--frames N] [--warmup N] [--dt sekundy] [--out wynik.json]
+// Bramka regresji (RegressionGate): stałe ujęcia x tryby oświetlenia, obrazy wzorcowe i bazowe czasy klatki.
+//   gk2025 --regress ujecia.txt [--golden katalog] [--update-golden] [--max-slowdown 1.25]
+//          [--pixel-threshold 0.1] [--max-diff-pixels 0.001] [--frames N] [--warmup N] [--diff-dir katalog]
+// Obrazy wzorcowe i czasy bazowe nie są w repozytorium (zależą od sterownika i maszyny): przed pierwszym użyciem
+// raz na maszynie wzorcowej (ten sam kontekst bez okna, np. Mesa llvmpipe)
+//   gk2025 --regress regression_poses.txt --update-golden
+// i zatwierdzić katalog golden/ - bez niego każdy przypadek kończy się błędem "brak pliku".
+struct BenchmarkSettings
+{
+    bool enabled = false;         // kontekst bez okna, stałe ziarno i zegar - także w trybie regresji
+    std::string cameraPathFile;
+    int frames = 600;             // w trybie regresji: na każde ujęcie i tryb (domyślnie kRegressionFrames)
+    int warmupFrames = 30;        // rysowane, ale nie mierzone (pierwsze użycie programów, cache sterownika)
+    double timeStep = 1.0 / 60.0; // sekundy symulacji na klatkę - niezależne od czasu rzeczywistego
+    std::string outputFile = "benchmark.json"; // tylko --benchmark
+
+    std::string regressionPosesFile;  // niepuste - tryb regresji
+    std::string goldenDirectory = "golden";
+    bool updateGolden = false;        // zapisuje obrazy wzorcowe i czasy bazowe zamiast porównywać
+    std::string diffDirectory = "regress"; // obrazy renderu i różnic przypadków z różnym obrazem
+    double maxSlowdown = 1.25;        // dopuszczalny stosunek czasu do bazowego
+    double pixelThreshold = 0.1;      // próg różnicy piksela jak w pixelmatch (0..1; 0.1 - szarość o ok. 27/255)
+    double maxDifferentPixels = 0.001; // dopuszczalny ułamek różniących się pikseli
+
+    static const int kRegressionFrames = 60;
+    static const int kRegressionWarmupFrames = 10;
+};
+
+// false i powód w failure przy błędnych argumentach; bez --benchmark zwraca true i enabled == false
+bool parseBenchmarkArguments(int argc, char** argv, BenchmarkSettings& settings, std::string& failure);
+
+// Kontekst GL 3.3 core bez widocznego okna. Kolejno: platforma "null" GLFW 3.4 z kontekstem OSMesa,
+// potem z EGL (oba bez serwera wyświetlania, np. Mesa llvmpipe), na końcu ukryte okno zwykłej platformy.
+// Woła glfwInit; description opisuje wybrany wariant. nullptr, gdy żaden się nie udał (GLFW zakończone).
+GLFWwindow* createOffscreenContext(int width, int height, std::string& description);
+
+// Czasy i liczniki mierzonych klatek. EndFrame czeka na GPU (glFinish), więc czas klatki obejmuje rysowanie -
+// przy programowym rasteryzatorze to czas CPU rasteryzacji. Wywołania rysowania i trójkąty z liczników GLState.
+class BenchmarkRecorder
+{
+public:
+    BenchmarkRecorder();
+
+    void BeginFrame();
+    void EndFrame();
+
+    int FrameCount() const { return (int)frameMilliseconds.size(); }
+    // Percentyl czasu klatki w ms (0.5 - mediana); 0 bez klatek
+    double FrameTime(double percentile) const;
+
+    void PrintSummary(std::ostream& out) const;
+    bool WriteJson(const std::string& path, const BenchmarkSettings& settings, const std::string& context,
+                   int width, int height) const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    Clock::time_point frameStart;
+    unsigned long long drawCallsAtStart;
+    unsigned long long trianglesAtStart;
+    std::vector<double> frameMilliseconds;
+    std::vector<unsigned long long> drawCalls;
+    std::vector<unsigned long long> triangles;
+};
+
+#endif
@@ -0,0 +1,266 @@
+#include "BlockCompression.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    // Blok 4x4 RGBA8 (64 B); teksele spoza obrazu powielają krawędź
+    void fetchBlock(const unsigned char* rgba, int width, int height, int blockX, int blockY, unsigned char block[64])
+    {
+        for (int y = 0; y < 4; ++y) {
+            const int sourceY = std::min(blockY * 4 + y, height - 1);
+            for (int x = 0; x < 4; ++x) {
+                const int sourceX = std::min(blockX * 4 + x, width - 1);
+                std::memcpy(block + (y * 4 + x) * 4, rgba + ((size_t)sourceY * width + sourceX) * 4, 4);
+            }
+        }
+    }
+
+    uint16_t packRGB565(const int rgb[3])
+    {
+        const int r = (rgb[0] * 31 + 127) / 255;
+        const int g = (rgb[1] * 63 + 127) / 255;
+        const int b = (rgb[2] * 31 + 127) / 255;
+        return (uint16_t)((r << 11) | (g << 5) | b);
+    }
+
+    void unpackRGB565(uint16_t color, int rgb[3])
+    {
+        const int r = (color >> 11) & 31;
+        const int g = (color >> 5) & 63;
+        const int b = color & 31;
+        rgb[0] = (r << 3) | (r >> 2);
+        rgb[1] = (g << 2) | (g >> 4);
+        rgb[2] = (b << 3) | (b >> 2);
+    }
+
+    void writeLittleEndian(unsigned char* out, uint64_t value, int bytes)
+    {
+        for (int i = 0; i < bytes; ++i) out[i] = (unsigned char)(value >> (8 * i));
+    }
+
+    // Końce odcinka koloru: teksele skrajne wzdłuż głównej osi rozrzutu (kilka iteracji potęgowych na macierzy kowariancji)
+    void findColorEndpoints(const unsigned char block[64], int first[3], int second[3])
+    {
+        float mean[3] = { 0.0f, 0.0f, 0.0f };
+        for (int i = 0; i < 16; ++i) {
+            for (int c = 0; c < 3; ++c) mean[c] += block[i * 4 + c];
+        }
+        for (int c = 0; c < 3; ++c) mean[c] /= 16.0f;
+
+        float covariance[3][3] = {};
+        for (int i = 0; i < 16; ++i) {
+            float d[3];
+            for (int c = 0; c < 3; ++c) d[c] = block[i * 4 + c] - mean[c];
+            for (int a = 0; a < 3; ++a) {
+                for (int b = 0; b < 3; ++b) covariance[a][b] += d[a] * d[b];
+            }
+        }
+
+        float axis[3] = { 1.0f, 1.0f, 1.0f };
+        for (int iteration = 0; iteration < 4; ++iteration) {
+            float next[3];
+            for (int a = 0; a < 3; ++a) {
+                next[a] = covariance[a][0] * axis[0] + covariance[a][1] * axis[1] + covariance[a][2] * axis[2];
+            }
+            const float length = std::max(std::fabs(next[0]), std::max(std::fabs(next[1]), std::fabs(next[2])));
+            if (length < 1e-6f) break; // blok jednolity - dowolna oś
+            for (int a = 0; a < 3; ++a) axis[a] = next[a] / length;
+        }
+
+        int minIndex = 0;
+        int maxIndex = 0;
+        float minProjection = 1e30f;
+        float maxProjection = -1e30f;
+        for (int i = 0; i < 16; ++i) {
+            const float projection = block[i * 4] * axis[0] + block[i * 4 + 1] * axis[1] + block[i * 4 + 2] * axis[2];
+            if (projection < minProjection) { minProjection = projection; minIndex = i; }
+            if (projection > maxProjection) { maxProjection = projection; maxIndex = i; }
+        }
+        for (int c = 0; c < 3; ++c) {
+            first[c] = block[maxIndex * 4 + c];
+            second[c] = block[minIndex * 4 + c];
+        }
+    }
+
+    // 8 B: dwa kolory 565 (color0 > color1 - tryb 4 kolorów) + 16 indeksów po 2 bity
+    void encodeColorBlock(const unsigned char block[64], unsigned char out[8])
+    {
+        int first[3];
+        int second[3];
+        findColorEndpoints(block, first, second);
+        uint16_t color0 = packRGB565(first);
+        uint16_t color1 = packRGB565(second);
+        if (color0 < color1) std::swap(color0, color1);
+
+        uint32_t indices = 0;
+        if (color0 != color1) {
+            int palette[4][3];
+            unpackRGB565(color0, palette[0]);
+            unpackRGB565(color1, palette[1]);
+            for (int c = 0; c < 3; ++c) {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+            for (int i = 0; i < 16; ++i) {
+                int best = 0;
+                int bestError = 1 << 30;
+                for (int p = 0; p < 4; ++p) {
+                    int error = 0;
+                    for (int c = 0; c < 3; ++c) {
+                        const int d = block[i * 4 + c] - palette[p][c];
+                        error += d * d;
+                    }
+                    if (error < bestError) { bestError = error; best = p; }
+                }
+                indices |= (uint32_t)best << (2 * i);
+            }
+        }
+        writeLittleEndian(out, color0, 2);
+        writeLittleEndian(out + 2, color1, 2);
+        writeLittleEndian(out + 4, indices, 4);
+    }
+
+    // 8 B: alfa0 > alfa1 (tryb 8 wartości) + 16 indeksów po 3 bity
+    void encodeAlphaBlock(const unsigned char block[64], unsigned char out[8])
+    {
+        int alpha0 = 0;
+        int alpha1 = 255;
+        for (int i = 0; i < 16; ++i) {
+            alpha0 = std::max(alpha0, (int)block[i * 4 + 3]);
+            alpha1 = std::min(alpha1, (int)block[i * 4 + 3]);
+        }
+
+        uint64_t indices = 0;
+        if (alpha0 != alpha1) {
+            int palette[8];
+            palette[0] = alpha0;
+            palette[1] = alpha1;
+            for (int p = 1; p < 7; ++p) palette[p + 1] = ((7 - p) * alpha0 + p * alpha1) / 7;
+            for (int i = 0; i < 16; ++i) {
+                int best = 0;
+                int bestError = 256;
+                for (int p = 0; p < 8; ++p) {
+                    const int error = std::abs(block[i * 4 + 3] - palette[p]);
+                    if (error < bestError) { bestError = error; best = p; }
+                }
+                indices |= (uint64_t)best << (3 * i);
+            }
+        }
+        out[0] = (unsigned char)alpha0;
+        out[1] = (unsigned char)alpha1;
+        writeLittleEndian(out + 2, indices, 6);
+    }
+}
+
+size_t compressedLevelSize(size_t blockBytes, int width, int height)
+{
+    const size_t blocksX = (size_t)std::max(1, (width + 3) / 4);
+    const size_t blocksY = (size_t)std::max(1, (height + 3) / 4);
+    return blocksX * blocksY * blockBytes;
+}
+
+void compressBC1(const unsigned char* rgba, int width, int height, unsigned char* out)
+{
+    const int blocksX = std::max(1, (width + 3) / 4);
+    const int blocksY = std::max(1, (height + 3) / 4);
+    unsigned char block[64];
+    for (int blockY = 0; blockY < blocksY; ++blockY) {
+        for (int blockX = 0; blockX < blocksX; ++blockX) {
+            fetchBlock(rgba, width, height, blockX, blockY, block);
+            encodeColorBlock(block, out);
+            out += kBC1BlockBytes;
+        }
+    }
+}
+
+void compressBC3(const unsigned char* rgba, int width, int height, unsigned char* out)
+{
+    const int blocksX = std::max(1, (width + 3) / 4);
+    const int blocksY = std::max(1, (height + 3) / 4);
+    unsigned char block[64];
+    for (int blockY = 0; blockY < blocksY; ++blockY) {
+        for (int blockX = 0; blockX < blocksX; ++blockX) {
+            fetchBlock(rgba, width, height, blockX, blockY, block);
+            encodeAlphaBlock(block, out);
+            encodeColorBlock(block, out + 8);
+            out += kBC3BlockBytes;
+        }
+    }
+}
+
+bool hasTranslucentTexels(const unsigned char* rgba, int width, int height)
+{
+    const size_t texelCount = (size_t)width * height;
+    for (size_t i = 0; i < texelCount; ++i) {
+        if (rgba[i * 4 + 3] != 255) return true;
+    }
+    return false;
+}
+
+void downsampleRGBA8(const unsigned char* src, int width, int height, std::vector<unsigned char>& dst)
+{
+    const int nextWidth = std::max(1, width / 2);
+    const int nextHeight = std::max(1, height / 2);
+    dst.resize((size_t)nextWidth * nextHeight * 4);
+    for (int y = 0; y < nextHeight; ++y) {
+        const int y0 = std::min(2 * y, height - 1);
+        const int y1 = std::min(2 * y + 1, height - 1);
+        for (int x = 0; x < nextWidth; ++x) {
+            const int x0 = std::min(2 * x, width - 1);
+            const int x1 = std::min(2 * x + 1, width - 1);
+            const unsigned char* a = src + ((size_t)y0 * width + x0) * 4;
+            const unsigned char* b = src + ((size_t)y0 * width + x1) * 4;
+            const unsigned char* c = src + ((size_t)y1 * width + x0) * 4;
+            const unsigned char* d = src + ((size_t)y1 * width + x1) * 4;
+            unsigned char* out = &dst[((size_t)y * nextWidth + x) * 4];
+            for (int channel = 0; channel < 4; ++channel) {
+                out[channel] = (unsigned char)((a[channel] + b[channel] + c[channel] + d[channel] + 2) / 4);
+            }
+        }
+    }
+}
+
+void resampleRGBA8(const unsigned char* src, int width, int height, int dstWidth, int dstHeight, std::vector<unsigned char>& dst)
+{
+    dst.resize((size_t)dstWidth * dstHeight * 4);
+    const float scaleX = (float)width / dstWidth;
+    const float scaleY = (float)height / dstHeight;
+    for (int y = 0; y < dstHeight; ++y) {
+        const float sourceY = std::max(0.0f, (y + 0.5f) * scaleY - 0.5f);
+        const int y0 = std::min((int)sourceY, height - 1);
+        const int y1 = std::min(y0 + 1, height - 1);
+        const float fy = sourceY - y0;
+        for (int x = 0; x < dstWidth; ++x) {
+            const float sourceX = std::max(0.0f, (x + 0.5f) * scaleX - 0.5f);
+            const int x0 = std::min((int)sourceX, width - 1);
+            const int x1 = std::min(x0 + 1, width - 1);
+            const float fx = sourceX - x0;
+            const unsigned char* a = src + ((size_t)y0 * width + x0) * 4;
+            const unsigned char* b = src + ((size_t)y0 * width + x1) * 4;
+            const unsigned char* c = src + ((size_t)y1 * width + x0) * 4;
+            const unsigned char* d = src + ((size_t)y1 * width + x1) * 4;
+            unsigned char* out = &dst[((size_t)y * dstWidth + x) * 4];
+            for (int channel = 0; channel < 4; ++channel) {
+                const float top = a[channel] + (b[channel] - a[channel]) * fx;
+                const float bottom = c[channel] + (d[channel] - c[channel]) * fx;
+                out[channel] = (unsigned char)(top + (bottom - top) * fy + 0.5f);
+            }
+        }
+    }
+}
+
+void convertBC1ToBC3(const unsigned char* bc1, size_t blockCount, unsigned char* out)
+{
+    // alfa0 = alfa1 = 255 i indeksy 0 - każdy teksel nieprzezroczysty
+    static const unsigned char opaqueAlpha[8] = { 255, 255, 0, 0, 0, 0, 0, 0 };
+    for (size_t i = 0; i < blockCount; ++i) {
+        std::memcpy(out, opaqueAlpha, sizeof(opaqueAlpha));
+        std::memcpy(out + 8, bc1, kBC1BlockBytes);
+        bc1 += kBC1BlockBytes;
+        out += kBC3BlockBytes;
+    }
+}
@@ -0,0 +1,36 @@
+#ifndef BLOCK_COMPRESSION_H
+#define BLOCK_COMPRESSION_H
+
+#include <vector>
+#include <cstddef>
+
+// Kompresja blokowa tekstur RGBA8 do formatów S3TC, dekodowanych sprzętowo przez GPU.
+// BC1 (DXT1): 8 B na blok 4x4 = 0.5 B/teksel (8x mniej niż RGBA8), bez kanału alfa.
+// BC3 (DXT5): 16 B na blok 4x4 = 1 B/teksel (4x mniej), kolor jak BC1 + alfa z interpolacją 8 wartości.
+// Wymiary niepodzielne przez 4 są dopełniane powieleniem krawędzi (jak oczekuje GL dla małych poziomów mip).
+
+const size_t kBC1BlockBytes = 8;
+const size_t kBC3BlockBytes = 16;
+
+// Rozmiar poziomu w bajtach (GL: imageSize dla glCompressedTexImage2D)
+size_t compressedLevelSize(size_t blockBytes, int width, int height);
+
+// rgba: width * height tekseli RGBA8, wiersz po wierszu; out: compressedLevelSize(...) bajtów
+void compressBC1(const unsigned char* rgba, int width, int height, unsigned char* out);
+void compressBC3(const unsigned char* rgba, int width, int height, unsigned char* out);
+
+// Czy którykolwiek teksel ma alfa < 255 (wtedy BC3, inaczej wystarczy BC1)
+bool hasTranslucentTexels(const unsigned char* rgba, int width, int height);
+
+// Następny poziom mip (filtr pudełkowy 2x2, wymiary max(1, n / 2)); dst nie może być src
+void downsampleRGBA8(const unsigned char* src, int width, int height, std::vector<unsigned char>& dst);
+
+// Próbkowanie dwuliniowe do dstWidth x dstHeight (warstwy tablicy tekstur mają wspólny rozmiar);
+// przy pomniejszaniu więcej niż 2x lepiej byłoby filtrować pudełkowo
+void resampleRGBA8(const unsigned char* src, int width, int height, int dstWidth, int dstHeight, std::vector<unsigned char>& dst);
+
+// BC1 -> BC3 bez ponownego kodowania: blok alfa 255 + ten sam blok koloru. Dokładne, bo koder BC1
+// zapisuje bloki w trybie 4 kolorów (color0 >= color1), tak jak interpretuje je BC3. out: blockCount * kBC3BlockBytes
+void convertBC1ToBC3(const unsigned char* bc1, size_t blockCount, unsigned char* out);
+
+#endif
@@ -1,7 +1,9 @@
 #include "Cactus.h"
+#include "GLState.h"
 #include <glm/gtc/matrix_transform.hpp> // Potrzebujemy tego do transformacji macierzy
 #include <glad/glad.h>                  // Potrzebujemy OpenGL do glDrawElements
 #include <vector>                       // Potrzebujemy wektora dla struktury części danych
+#include <algorithm>
 
 // Konstruktor klasy Cactus - ustawia pozycję i obrót instancji
 Cactus::Cactus(glm::vec3 pos, float rotationY)
@@ -13,44 +15,178 @@ Cactus::Cactus(glm::vec3 pos, float rotationY)
 // Metoda do rysowania pojedynczej instancji kaktusa
 // Przyjmuje shader, liczbę indeksów sfery i współdzielone dane o częściach kaktusa.
 // VAO sfery dla kaktusów (np. cactusSphereVAO z main.cpp) MUSI być zbindowane ZEWNĘTRZNIE przed wywołaniem tej metody.
-void Cactus::Draw(Shader& shader, GLsizei sphereIndexCount, const std::vector<CactusPart>& partsData) const
+void Cactus::Draw(Shader& shader, GLsizei sphereIndexCount, const std::vector<CactusPart>& partsData, GLenum indexType) const
 {
     // Shader i Tekstura kaktusa powinny być ZBINDOWANE ZEWNĘTRZNIE (w main)
     // VAO sfery dla kaktusów (np. cactusSphereVAO) powinno być ZBINDOWANE ZEWNĘTRZNIE (w main)
     // Uniformy kamery, światła, trybu oświetlenia, specular strength powinny być ustawione zewnętrznie.
 
+    // Lokalizacja "model" rozwiązywana raz na wywołanie, nie dla każdej części
+    UniformHandle<glm::mat4> modelUniform = shader.Uniform<glm::mat4>("model");
+
     // Pętla przez wszystkie części składowe standardowego kaktusa
     for (const auto& part : partsData)
     {
-        // 1. Oblicz macierz modelu dla tej konkretnej części, dla tej konkretnej instancji kaktusa.
-        // Zaczynamy od macierzy jednostkowej
-        glm::mat4 cactusPartModel = glm::mat4(1.0f);
+        // 1. Ustaw macierz modelu tej części w shaderze
+        modelUniform.Set(PartModelMatrix(part));
 
-        // Zastosuj GLOBALNĄ transformację instancji: Przesuń do jej pozycji, a następnie obróć wokół osi Y
-        cactusPartModel = glm::translate(cactusPartModel, Position); // Przesuń do pozycji instancji
-        cactusPartModel = glm::rotate(cactusPartModel, glm::radians(yRotation), glm::vec3(0.0f, 1.0f, 0.0f)); // Obróć instancję wokół Y
+        // 2. Rysuj bazową geometrię SFERY (VAO/VBO/EBO dla sfery muszą być zbindowane zewnętrznie w main)
+        // Używamy liczby indeksów sfery przekazanej jako argument
+        GLState::DrawElements(GL_TRIANGLES, sphereIndexCount, indexType, 0);
+    }
+}
 
-        
+// Oblicza macierz modelu dla konkretnej części, dla tej konkretnej instancji kaktusa.
+glm::mat4 Cactus::PartModelMatrix(const CactusPart& part) const
+{
+    // Zaczynamy od macierzy jednostkowej
+    glm::mat4 cactusPartModel = glm::mat4(1.0f);
 
-        glm::mat4 partTransformation = glm::mat4(1.0f);
-        // Najpierw skaluj
-        partTransformation = glm::scale(partTransformation, part.scale);
-        // Potem obróć relatywnie
-        partTransformation = glm::rotate(partTransformation, glm::radians(part.rotationAngle), part.rotationAxis);
-        // Na końcu przesuń środek do part.relativePosition (WAŻNE: relativePosition jest po skalowaniu i obrocie relatywnym)
-        partTransformation = glm::translate(partTransformation, part.relativePosition);
+    // Zastosuj GLOBALNĄ transformację instancji: Przesuń do jej pozycji, a następnie obróć wokół osi Y
+    cactusPartModel = glm::translate(cactusPartModel, Position); // Przesuń do pozycji instancji
+    cactusPartModel = glm::rotate(cactusPartModel, glm::radians(yRotation), glm::vec3(0.0f, 1.0f, 0.0f)); // Obróć instancję wokół Y
 
+    glm::mat4 partTransformation = glm::mat4(1.0f);
+    // Najpierw skaluj
+    partTransformation = glm::scale(partTransformation, part.scale);
+    // Potem obróć relatywnie
+    partTransformation = glm::rotate(partTransformation, glm::radians(part.rotationAngle), part.rotationAxis);
+    // Na końcu przesuń środek do part.relativePosition (WAŻNE: relativePosition jest po skalowaniu i obrocie relatywnym)
+    partTransformation = glm::translate(partTransformation, part.relativePosition);
 
-        // Połącz macierz instancji z macierzą części (w odpowiedniej kolejności mnożenia GLM)
-        // Macierz_Instancji * Macierz_Części
-        cactusPartModel = cactusPartModel * partTransformation;
+    // Połącz macierz instancji z macierzą części (w odpowiedniej kolejności mnożenia GLM)
+    // Macierz_Instancji * Macierz_Części
+    return cactusPartModel * partTransformation;
+}
 
 
-        // 2. Ustaw macierz modelu w shaderze
-        shader.setMat4("model", cactusPartModel);
+// --- CactusBatch ---
 
-        // 3. Rysuj bazową geometrię SFERY (VAO/VBO/EBO dla sfery muszą być zbindowane zewnętrznie w main)
-        // Używamy liczby indeksów sfery przekazanej jako argument
-        glDrawElements(GL_TRIANGLES, sphereIndexCount, GL_UNSIGNED_INT, 0);
+CactusBatch::CactusBatch(VAO& sphereVAO, const std::vector<CactusPart>& partsData)
+    : parts(partsData), instanceCount(0)
+{
+    for (int level = 0; level < SphereLODChain::kLevelCount; ++level)
+    {
+        levelStart[level] = 0;
+        levelCount[level] = 0;
     }
+    sphereVAO.Bind();
+    VBO instanceBuffer(nullptr, 0, GL_DYNAMIC_DRAW);
+    instanceVBO = instanceBuffer.ID;
+
+    // mat4 zajmuje cztery kolejne lokacje atrybutów (po jednej na kolumnę vec4)
+    for (GLuint column = 0; column < 4; ++column)
+    {
+        sphereVAO.LinkAttribInstanced(instanceBuffer, 4 + column, 4, GL_FLOAT, sizeof(glm::mat4), (void*)(column * sizeof(glm::vec4)), 1);
+    }
+    sphereVAO.Unbind();
+}
+
+void CactusBatch::Update(const std::vector<Cactus>& cacti, const SphereLODChain& spheres, const glm::mat4& camMatrix, float viewportHeight)
+{
+    const size_t partCount = parts.size();
+    const bool resized = uploadedPositions.size() != cacti.size();
+    if (resized)
+    {
+        uploadedPositions.resize(cacti.size());
+        uploadedRotations.resize(cacti.size());
+        instanceMatrices.resize(cacti.size() * partCount);
+        sortedMatrices.resize(instanceMatrices.size());
+        instanceLevels.resize(instanceMatrices.size());
+        instanceSlot.resize(instanceMatrices.size());
+        uploadedLevels.clear();
+    }
+
+    // Zakres [firstDirty, lastDirty] zmienionych kaktusów
+    bool anyDirty = false;
+    size_t firstDirty = 0;
+    size_t lastDirty = 0;
+    for (size_t i = 0; i < cacti.size(); ++i)
+    {
+        const Cactus& cactus = cacti[i];
+        if (!resized && uploadedPositions[i] == cactus.Position && uploadedRotations[i] == cactus.yRotation)
+            continue;
+
+        uploadedPositions[i] = cactus.Position;
+        uploadedRotations[i] = cactus.yRotation;
+        for (size_t p = 0; p < partCount; ++p)
+        {
+            instanceMatrices[i * partCount + p] = cactus.PartModelMatrix(parts[p]);
+        }
+        if (!anyDirty) firstDirty = i;
+        lastDirty = i;
+        anyDirty = true;
+    }
+    instanceCount = (GLsizei)instanceMatrices.size();
+
+    // Poziom LOD każdej części: środek sfery to translacja macierzy, promień skalowany największą osią
+    for (size_t i = 0; i < instanceMatrices.size(); ++i)
+    {
+        const glm::mat4& m = instanceMatrices[i];
+        float axisScale = std::max(glm::length(glm::vec3(m[0])), std::max(glm::length(glm::vec3(m[1])), glm::length(glm::vec3(m[2]))));
+        instanceLevels[i] = (unsigned char)spheres.SelectLevel(camMatrix, glm::vec3(m[3]), spheres.Radius() * axisScale, viewportHeight);
+    }
+
+    GLState::BindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    if (instanceLevels != uploadedLevels)
+    {
+        // Zmiana przydziału do poziomów: sortowanie kubełkowe i wysłanie całego bufora
+        for (int level = 0; level < SphereLODChain::kLevelCount; ++level) levelCount[level] = 0;
+        for (unsigned char level : instanceLevels) ++levelCount[level];
+        GLsizei start = 0;
+        for (int level = 0; level < SphereLODChain::kLevelCount; ++level)
+        {
+            levelStart[level] = start;
+            start += levelCount[level];
+        }
+        GLsizei fill[SphereLODChain::kLevelCount];
+        std::copy(levelStart, levelStart + SphereLODChain::kLevelCount, fill);
+        for (size_t i = 0; i < instanceMatrices.size(); ++i)
+        {
+            GLsizei slot = fill[instanceLevels[i]]++;
+            instanceSlot[i] = slot;
+            sortedMatrices[slot] = instanceMatrices[i];
+        }
+        if (resized)
+            glBufferData(GL_ARRAY_BUFFER, sortedMatrices.size() * sizeof(glm::mat4), sortedMatrices.data(), GL_DYNAMIC_DRAW);
+        else
+            glBufferSubData(GL_ARRAY_BUFFER, 0, sortedMatrices.size() * sizeof(glm::mat4), sortedMatrices.data());
+        uploadedLevels = instanceLevels;
+    }
+    else if (anyDirty)
+    {
+        // Te same poziomy - tylko zakres slotów zajętych przez zmienione macierze
+        GLsizei minSlot = instanceCount, maxSlot = -1;
+        for (size_t i = firstDirty * partCount; i < (lastDirty + 1) * partCount; ++i)
+        {
+            sortedMatrices[instanceSlot[i]] = instanceMatrices[i];
+            minSlot = std::min(minSlot, instanceSlot[i]);
+            maxSlot = std::max(maxSlot, instanceSlot[i]);
+        }
+        glBufferSubData(GL_ARRAY_BUFFER, minSlot * sizeof(glm::mat4), (maxSlot - minSlot + 1) * sizeof(glm::mat4), &sortedMatrices[minSlot]);
+    }
+    GLState::BindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void CactusBatch::Draw(const SphereLODChain& spheres) const
+{
+    if (instanceCount == 0) return;
+    // Bez glDrawElementsInstancedBaseInstance (GL 4.2) początek kubełka ustawia przesunięcie atrybutów instancji
+    GLState::BindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    for (int level = 0; level < SphereLODChain::kLevelCount; ++level)
+    {
+        if (levelCount[level] == 0) continue;
+        size_t bucketOffset = (size_t)levelStart[level] * sizeof(glm::mat4);
+        for (GLuint column = 0; column < 4; ++column)
+        {
+            glVertexAttribPointer(4 + column, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(bucketOffset + column * sizeof(glm::vec4)));
+        }
+        spheres.DrawInstanced(level, levelCount[level]);
+    }
+    GLState::BindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void CactusBatch::Delete()
+{
+    GLState::DeleteBuffer(instanceVBO);
 }
@@ -5,6 +5,7 @@
 #include <vector>
 #include "shaderClass.h"
 #include "VAO.h" 
+#include "SphereLOD.h"
 
 
 struct CactusPart {
@@ -25,9 +26,48 @@ public:
     Cactus(glm::vec3 pos, float rotationY = 0.0f); 
 
 
-    void Draw(Shader& shader, GLsizei sphereIndexCount, const std::vector<CactusPart>& partsData) const;
+    void Draw(Shader& shader, GLsizei sphereIndexCount, const std::vector<CactusPart>& partsData, GLenum indexType = GL_UNSIGNED_INT) const;
 
+    // Macierz modelu jednej części tej instancji kaktusa (wspólna dla Draw i CactusBatch)
+    glm::mat4 PartModelMatrix(const CactusPart& part) const;
  
 };
 
+
+// Instancjonowane rysowanie wszystkich kaktusów: macierze modeli (kaktus x część) trzymane są
+// w VBO instancji podpiętym do VAO sfery (lokacje 4-7). Instancje są grupowane wg poziomu LOD sfery
+// (rzutowany promień na ekranie) - jedno glDrawElementsInstancedBaseVertex na niepusty poziom.
+class CactusBatch
+{
+public:
+    GLuint instanceVBO;
+
+    // sphereVAO: VAO sfery kaktusów (np. cactusSphereVAO), do którego zostaną dopięte atrybuty instancji
+    CactusBatch(VAO& sphereVAO, const std::vector<CactusPart>& partsData);
+
+    // Przelicza macierze kaktusów, których Position/yRotation się zmieniły, i poziomy LOD wszystkich części.
+    // Bufor instancji jest przesyłany w całości tylko przy zmianie przydziału do poziomów,
+    // w pozostałych przypadkach tylko zakres zmienionych macierzy.
+    void Update(const std::vector<Cactus>& cacti, const SphereLODChain& spheres, const glm::mat4& camMatrix, float viewportHeight);
+    // Rysuje wszystkie instancje (shader, tekstura i VAO sfery muszą być zbindowane zewnętrznie)
+    void Draw(const SphereLODChain& spheres) const;
+    void Delete();
+
+    // Liczba instancji na danym poziomie LOD w ostatnim Update (do statystyk)
+    GLsizei LevelInstanceCount(int level) const { return levelCount[level]; }
+
+private:
+    std::vector<CactusPart> parts;
+    std::vector<glm::mat4> instanceMatrices;   // kolejność: kaktus x część
+    std::vector<glm::mat4> sortedMatrices;     // kolejność w VBO: pogrupowane wg poziomu
+    std::vector<unsigned char> instanceLevels;
+    std::vector<unsigned char> uploadedLevels;
+    std::vector<GLsizei> instanceSlot;         // pozycja instancji w sortedMatrices
+    std::vector<glm::vec3> uploadedPositions;
+    std::vector<float> uploadedRotations;
+    GLsizei levelStart[SphereLODChain::kLevelCount];
+    GLsizei levelCount[SphereLODChain::kLevelCount];
+    GLsizei instanceCount;
+};
+
 #endif 
@@ -9,7 +9,7 @@ Camera::Camera(int width, int height, glm::vec3 position)
 void Camera::Matrix(Shader& shader, const char* uniform)
 {
 	//eksportowanie macierzy kamery
-	glUniformMatrix4fv(glGetUniformLocation(shader.ID, uniform), 1, GL_FALSE, glm::value_ptr(cameraMatrix));
+	glUniformMatrix4fv(shader.UniformLocation(uniform), 1, GL_FALSE, glm::value_ptr(cameraMatrix));
 }
 
 void Camera::updateMatrix(float FOVdeg, float nearPlane, float farPlane)
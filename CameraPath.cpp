@@ -0,0 +1,81 @@
+#include "CameraPath.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+    // Catmull-Rom dla nierównych odstępów czasu: styczne z różnic sąsiednich węzłów dzielonych przez ich odstęp
+    glm::vec3 catmullRom(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3,
+                         float t0, float t1, float t2, float t3, float t)
+    {
+        const float span = t2 - t1;
+        const glm::vec3 m1 = (p2 - p0) * (span / std::max(1e-6f, t2 - t0));
+        const glm::vec3 m2 = (p3 - p1) * (span / std::max(1e-6f, t3 - t1));
+        const float s = span > 0.0f ? (t - t1) / span : 0.0f;
+        const float s2 = s * s;
+        const float s3 = s2 * s;
+        return p1 * (2.0f * s3 - 3.0f * s2 + 1.0f) + m1 * (s3 - 2.0f * s2 + s)
+             + p2 * (-2.0f * s3 + 3.0f * s2) + m2 * (s3 - s2);
+    }
+}
+
+bool CameraPath::Load(const std::string& path, std::string& failure)
+{
+    std::ifstream file(path);
+    if (!file) {
+        failure = "nie można otworzyć pliku " + path;
+        return false;
+    }
+    keys.clear();
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        const size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+        std::istringstream fields(line);
+        Key key;
+        if (!(fields >> key.time)) continue; // pusty wiersz albo sam komentarz
+        if (!(fields >> key.position.x >> key.position.y >> key.position.z >> key.target.x >> key.target.y >> key.target.z)) {
+            failure = path + ":" + std::to_string(lineNumber) + ": oczekiwano 7 liczb (czas, pozycja, cel)";
+            return false;
+        }
+        if (!keys.empty() && key.time <= keys.back().time) {
+            failure = path + ":" + std::to_string(lineNumber) + ": czasy węzłów muszą rosnąć";
+            return false;
+        }
+        keys.push_back(key);
+    }
+    if (keys.size() < 2) {
+        failure = path + ": ścieżka potrzebuje co najmniej 2 węzłów";
+        return false;
+    }
+    return true;
+}
+
+void CameraPath::Evaluate(float time, glm::vec3& position, glm::vec3& orientation) const
+{
+    if (keys.empty()) return;
+    size_t segment = 0;
+    while (segment + 2 < keys.size() && time >= keys[segment + 1].time) ++segment;
+    time = std::min(std::max(time, keys.front().time), keys.back().time);
+
+    // Skrajne segmenty: brakujący sąsiad odbity względem węzła końcowego
+    const Key& k1 = keys[segment];
+    const Key& k2 = keys[segment + 1];
+    const bool hasPrevious = segment > 0;
+    const bool hasNext = segment + 2 < keys.size();
+    const glm::vec3 p0 = hasPrevious ? keys[segment - 1].position : k1.position * 2.0f - k2.position;
+    const glm::vec3 p3 = hasNext ? keys[segment + 2].position : k2.position * 2.0f - k1.position;
+    const glm::vec3 c0 = hasPrevious ? keys[segment - 1].target : k1.target * 2.0f - k2.target;
+    const glm::vec3 c3 = hasNext ? keys[segment + 2].target : k2.target * 2.0f - k1.target;
+    const float t0 = hasPrevious ? keys[segment - 1].time : 2.0f * k1.time - k2.time;
+    const float t3 = hasNext ? keys[segment + 2].time : 2.0f * k2.time - k1.time;
+
+    position = catmullRom(p0, k1.position, k2.position, p3, t0, k1.time, k2.time, t3, time);
+    const glm::vec3 target = catmullRom(c0, k1.target, k2.target, c3, t0, k1.time, k2.time, t3, time);
+    const glm::vec3 forward = target - position;
+    const float length = glm::length(forward);
+    if (length > 1e-5f) orientation = forward / length;
+}
@@ -0,0 +1,36 @@
+#ifndef CAMERA_PATH_CLASS_H
+#define CAMERA_PATH_CLASS_H
+
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+
+// Ścieżka kamery z pliku tekstowego - jeden węzeł na wiersz, '#' zaczyna komentarz:
+//   czas  pozycja.x pozycja.y pozycja.z  cel.x cel.y cel.z
+// Czasy rosnące (sekundy). Pozycja i punkt, na który patrzy kamera, interpolowane są splajnem Catmulla-Roma
+// (przechodzi przez węzły); poza zakresem czasu kamera stoi w pierwszym / ostatnim węźle.
+class CameraPath
+{
+public:
+    struct Key
+    {
+        float time;
+        glm::vec3 position;
+        glm::vec3 target;
+    };
+
+    // false i powód w failure, gdy pliku nie da się wczytać albo ma mniej niż 2 węzły
+    bool Load(const std::string& path, std::string& failure);
+
+    // position i orientation (wektor jednostkowy) w chwili time
+    void Evaluate(float time, glm::vec3& position, glm::vec3& orientation) const;
+
+    float Duration() const { return keys.empty() ? 0.0f : keys.back().time - keys.front().time; }
+    float StartTime() const { return keys.empty() ? 0.0f : keys.front().time; }
+    size_t KeyCount() const { return keys.size(); }
+
+private:
+    std::vector<Key> keys;
+};
+
+#endif
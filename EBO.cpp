@@ -1,23 +1,38 @@
 #include"EBO.h"
+#include "GLState.h"
 
 EBO::EBO(GLuint* indices, GLsizeiptr size)
 {
 	glGenBuffers(1, &ID);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ID);
+	GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, ID);
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, indices, GL_STATIC_DRAW);
 }
 
+EBO::EBO(GLushort* indices, GLsizeiptr size)
+{
+	glGenBuffers(1, &ID);
+	GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, ID);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, indices, GL_STATIC_DRAW);
+}
+
+EBO::EBO(const void* indices, GLsizeiptr size, GLenum usage)
+{
+	glGenBuffers(1, &ID);
+	GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, ID);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, indices, usage);
+}
+
 void EBO::Bind()
 {
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ID);
+	GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, ID);
 }
 
 void EBO::Unbind()
 {
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
 void EBO::Delete()
 {
-	glDeleteBuffers(1, &ID);
+	GLState::DeleteBuffer(ID);
 }
\ No newline at end of file
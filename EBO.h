@@ -8,6 +8,8 @@ class EBO
 public:
 	GLuint ID;
 	EBO(GLuint* indices, GLsizeiptr size);
+	EBO(GLushort* indices, GLsizeiptr size);
+	EBO(const void* indices, GLsizeiptr size, GLenum usage);
 
 	void Bind();
 	void Unbind();
@@ -0,0 +1,18 @@
+#ifndef FILE_UTILS_H
+#define FILE_UTILS_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// Wspólne dla plików cache (MeshCache, ProgramBinaryCache, TextureCache) i bramki regresji
+
+// FNV-1a 64-bit: klucze i sumy kontrolne plików cache - szybki, bez zależności, nie kryptograficzny
+const uint64_t kFnvOffset = 14695981039346656037ull;
+const uint64_t kFnvPrime = 1099511628211ull;
+uint64_t fnv1a(uint64_t hash, const void* bytes, size_t count);
+
+// Tworzy jeden poziom katalogu; true także wtedy, gdy katalog już istnieje
+bool makeDirectory(const std::string& path);
+
+#endif
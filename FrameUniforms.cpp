@@ -0,0 +1,71 @@
+#include "FrameUniforms.h"
+#include "GLState.h"
+#include <cstring>
+
+FrameUniformBuffer::FrameUniformBuffer()
+    : buffer(0), segmentStride(0), segment(0), stallCount(0)
+{
+    for (int i = 0; i < kRingSize; ++i) fences[i] = 0;
+
+    GLint alignment = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    if (alignment <= 0) alignment = 256;
+    segmentStride = ((GLsizeiptr)sizeof(FrameData) + alignment - 1) / alignment * alignment;
+
+    glGenBuffers(1, &buffer);
+    GLState::BindBuffer(GL_UNIFORM_BUFFER, buffer);
+    glBufferData(GL_UNIFORM_BUFFER, segmentStride * kRingSize, nullptr, GL_DYNAMIC_DRAW);
+    GLState::BindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void FrameUniformBuffer::Update(const FrameData& data)
+{
+    if (buffer == 0) return;
+
+    segment = (segment + 1) % kRingSize;
+    GLsync& fence = fences[segment];
+    if (fence) {
+        // Zwykle fence jest już zasygnalizowany (segment czytała klatka sprzed kRingSize klatek)
+        GLenum status = glClientWaitSync(fence, 0, 0);
+        if (status == GL_TIMEOUT_EXPIRED) {
+            ++stallCount;
+            do {
+                status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); // 1 ms
+            } while (status == GL_TIMEOUT_EXPIRED);
+        }
+        glDeleteSync(fence);
+        fence = 0;
+    }
+
+    const GLintptr offset = segment * segmentStride;
+    GLState::BindBuffer(GL_UNIFORM_BUFFER, buffer);
+    // Bez synchronizacji sterownika - o to, że GPU nie czyta już tego segmentu, dba fence powyżej
+    void* mapped = glMapBufferRange(GL_UNIFORM_BUFFER, offset, sizeof(FrameData),
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    if (mapped) {
+        std::memcpy(mapped, &data, sizeof(FrameData));
+        glUnmapBuffer(GL_UNIFORM_BUFFER);
+    }
+    else {
+        glBufferSubData(GL_UNIFORM_BUFFER, offset, sizeof(FrameData), &data);
+    }
+    GLState::BindBuffer(GL_UNIFORM_BUFFER, 0);
+    GLState::BindBufferRange(GL_UNIFORM_BUFFER, kFrameDataBinding, buffer, offset, sizeof(FrameData));
+}
+
+void FrameUniformBuffer::EndFrame()
+{
+    if (buffer == 0) return;
+    if (fences[segment]) glDeleteSync(fences[segment]);
+    fences[segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void FrameUniformBuffer::Delete()
+{
+    for (int i = 0; i < kRingSize; ++i) {
+        if (fences[i]) glDeleteSync(fences[i]);
+        fences[i] = 0;
+    }
+    if (buffer) GLState::DeleteBuffer(buffer);
+    buffer = 0;
+}
@@ -0,0 +1,72 @@
+#ifndef FRAME_UNIFORMS_CLASS_H
+#define FRAME_UNIFORMS_CLASS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+
+// Nazwa bloku i stały punkt wiązania - ten sam we wszystkich shaderach (Shader::BindUniformBlock)
+const char* const kFrameDataBlockName = "FrameData";
+const GLuint kFrameDataBinding = 0;
+
+// Jedyna definicja bloku w GLSL - inject_defines wstawia ją za #version każdego shadera,
+// więc pliki .vert/.frag używają camMatrix, lightPos itd. bez własnej deklaracji
+const char* const kFrameDataBlock =
+    "layout(std140) uniform FrameData\n"
+    "{\n"
+    "    mat4 camMatrix;\n"     // projekcja * widok
+    "    mat4 view;\n"
+    "    mat4 projection;\n"
+    "    vec4 lightColor;\n"
+    "    vec3 lightPos;\n"
+    "    float u_time;\n"
+    "    vec3 camPos;\n"
+    "    int u_reserved;\n"     // wolne - tryb oświetlenia wybiera wariant programu
+    "};\n";
+
+// Dane wspólne dla całej klatki - układ std140 bloku kFrameDataBlock
+struct FrameData
+{
+    glm::mat4 camMatrix;   // projekcja * widok
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::vec4 lightColor;
+    glm::vec3 lightPos;
+    float time;            // w std140 float wypełnia ostatnie 4 B po vec3
+    glm::vec3 camPos;
+    GLint reserved;        // wolne (tryb oświetlenia wybiera wariant programu, nie uniform)
+};
+static_assert(offsetof(FrameData, lightColor) == 192, "FrameData: niezgodny układ std140");
+static_assert(offsetof(FrameData, time) == 220, "FrameData: niezgodny układ std140");
+static_assert(offsetof(FrameData, reserved) == 236, "FrameData: niezgodny układ std140");
+static_assert(sizeof(FrameData) == 240, "FrameData: niezgodny rozmiar std140");
+
+// UBO z danymi klatki jako pierścień kRingSize segmentów w jednym buforze.
+// Klatka N pisze do segmentu N % kRingSize (mapowanie bez synchronizacji), a fence postawiony w EndFrame
+// pilnuje, żeby segment nie został nadpisany, zanim GPU skończy klatkę, która go czyta.
+// Przy trzech segmentach CPU czeka tylko wtedy, gdy GPU jest więcej niż dwie klatki z tyłu.
+class FrameUniformBuffer
+{
+public:
+    static const int kRingSize = 3;
+
+    FrameUniformBuffer();
+
+    // Zapisuje dane do następnego segmentu i podpina go pod kFrameDataBinding - raz na klatkę, przed rysowaniem
+    void Update(const FrameData& data);
+    // Po ostatnim wywołaniu rysowania klatki
+    void EndFrame();
+    void Delete();
+
+    // Ile razy Update musiał czekać na GPU (do statystyk)
+    unsigned long long StallCount() const { return stallCount; }
+
+private:
+    GLuint buffer;
+    GLsizeiptr segmentStride;   // sizeof(FrameData) zaokrąglone do GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+    GLsync fences[kRingSize];
+    int segment;
+    unsigned long long stallCount;
+};
+
+#endif
@@ -0,0 +1,71 @@
+#include "GLExtensions.h"
+#include <cstring>
+#include <iostream>
+
+GLExtensions glExtensions;
+
+namespace
+{
+    bool versionAtLeast(int major, int minor)
+    {
+        return glExtensions.majorVersion > major || (glExtensions.majorVersion == major && glExtensions.minorVersion >= minor);
+    }
+}
+
+bool hasGLExtension(const char* name)
+{
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; ++i) {
+        const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, (GLuint)i));
+        if (extension && std::strcmp(extension, name) == 0) return true;
+    }
+    return false;
+}
+
+void loadGLExtensions(GLADloadproc load)
+{
+    glGetIntegerv(GL_MAJOR_VERSION, &glExtensions.majorVersion);
+    glGetIntegerv(GL_MINOR_VERSION, &glExtensions.minorVersion);
+
+    if (versionAtLeast(4, 1) || hasGLExtension("GL_ARB_get_program_binary")) {
+        glExtensions.GetProgramBinary = reinterpret_cast<GkGetProgramBinaryProc>(load("glGetProgramBinary"));
+        glExtensions.ProgramBinary = reinterpret_cast<GkProgramBinaryProc>(load("glProgramBinary"));
+        glExtensions.ProgramParameteri = reinterpret_cast<GkProgramParameteriProc>(load("glProgramParameteri"));
+        GLint formatCount = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+        // Sterowniki zgłaszające zero formatów mają funkcje, ale nie potrafią zapisać binariów
+        glExtensions.programBinary = glExtensions.GetProgramBinary && glExtensions.ProgramBinary
+            && glExtensions.ProgramParameteri && formatCount > 0;
+    }
+
+    if (hasGLExtension("GL_KHR_parallel_shader_compile")) {
+        glExtensions.MaxShaderCompilerThreads = reinterpret_cast<GkMaxShaderCompilerThreadsProc>(load("glMaxShaderCompilerThreadsKHR"));
+    }
+    else if (hasGLExtension("GL_ARB_parallel_shader_compile")) {
+        glExtensions.MaxShaderCompilerThreads = reinterpret_cast<GkMaxShaderCompilerThreadsProc>(load("glMaxShaderCompilerThreadsARB"));
+    }
+    glExtensions.parallelShaderCompile = glExtensions.MaxShaderCompilerThreads != nullptr;
+    if (glExtensions.parallelShaderCompile) {
+        glExtensions.MaxShaderCompilerThreads(0xFFFFFFFFu); // liczba wątków według uznania sterownika
+    }
+
+    if (versionAtLeast(4, 4) || hasGLExtension("GL_ARB_buffer_storage")) {
+        glExtensions.BufferStorage = reinterpret_cast<GkBufferStorageProc>(load("glBufferStorage"));
+    }
+    glExtensions.bufferStorage = glExtensions.BufferStorage != nullptr;
+
+    if (versionAtLeast(4, 2) || hasGLExtension("GL_ARB_texture_storage")) {
+        glExtensions.TexStorage2D = reinterpret_cast<GkTexStorage2DProc>(load("glTexStorage2D"));
+        glExtensions.TexStorage3D = reinterpret_cast<GkTexStorage3DProc>(load("glTexStorage3D"));
+    }
+    glExtensions.textureStorage = glExtensions.TexStorage2D != nullptr && glExtensions.TexStorage3D != nullptr;
+
+    glExtensions.textureCompressionS3TC = hasGLExtension("GL_EXT_texture_compression_s3tc");
+
+    std::cout << "OpenGL " << glExtensions.majorVersion << "." << glExtensions.minorVersion
+              << ", binaria programów: " << (glExtensions.programBinary ? "tak" : "nie")
+              << ", równoległa kompilacja shaderów: " << (glExtensions.parallelShaderCompile ? "tak" : "nie")
+              << ", trwale mapowane bufory: " << (glExtensions.bufferStorage ? "tak" : "nie")
+              << ", tekstury BC1/BC3: " << (glExtensions.textureCompressionS3TC ? "tak" : "nie") << std::endl;
+}
@@ -0,0 +1,90 @@
+#ifndef GL_EXTENSIONS_CLASS_H
+#define GL_EXTENSIONS_CLASS_H
+
+#include <glad/glad.h>
+
+// glad jest wygenerowany dla czystego GL 3.3 core bez rozszerzeń - funkcje i stałe z nowszych wersji
+// (albo z rozszerzeń ARB/KHR) ładujemy tu ręcznie tym samym loaderem co glad.
+
+// GL 4.1 / ARB_get_program_binary
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+#ifndef GL_PROGRAM_BINARY_FORMATS
+#define GL_PROGRAM_BINARY_FORMATS 0x87FF
+#endif
+
+// KHR_parallel_shader_compile / ARB_parallel_shader_compile
+#ifndef GL_MAX_SHADER_COMPILER_THREADS_KHR
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#endif
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+// GL 4.4 / ARB_buffer_storage
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+
+// EXT_texture_compression_s3tc - bloki BC1 (DXT1) i BC3 (DXT5)
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+typedef void (APIENTRYP GkGetProgramBinaryProc)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+typedef void (APIENTRYP GkProgramBinaryProc)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+typedef void (APIENTRYP GkProgramParameteriProc)(GLuint program, GLenum pname, GLint value);
+typedef void (APIENTRYP GkMaxShaderCompilerThreadsProc)(GLuint count);
+typedef void (APIENTRYP GkBufferStorageProc)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+typedef void (APIENTRYP GkTexStorage2DProc)(GLenum target, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height);
+typedef void (APIENTRYP GkTexStorage3DProc)(GLenum target, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height, GLsizei depth);
+
+struct GLExtensions
+{
+    int majorVersion = 3;
+    int minorVersion = 3;
+
+    // Binaria programów (GL 4.1 albo ARB_get_program_binary) i co najmniej jeden format binarny sterownika
+    bool programBinary = false;
+    GkGetProgramBinaryProc GetProgramBinary = nullptr;
+    GkProgramBinaryProc ProgramBinary = nullptr;
+    GkProgramParameteriProc ProgramParameteri = nullptr;
+
+    // Kompilacja na wątkach sterownika i nieblokujące GL_COMPLETION_STATUS_KHR (KHR/ARB_parallel_shader_compile)
+    bool parallelShaderCompile = false;
+    GkMaxShaderCompilerThreadsProc MaxShaderCompilerThreads = nullptr;
+
+    // Niezmienny magazyn bufora i trwałe mapowanie (GL 4.4 albo ARB_buffer_storage)
+    bool bufferStorage = false;
+    GkBufferStorageProc BufferStorage = nullptr;
+
+    // Niezmienny magazyn tekstur (GL 4.2 albo ARB_texture_storage)
+    bool textureStorage = false;
+    GkTexStorage2DProc TexStorage2D = nullptr;
+    GkTexStorage3DProc TexStorage3D = nullptr;
+
+    // Tekstury BC1/BC3 (EXT_texture_compression_s3tc) - same stałe, bez nowych funkcji
+    bool textureCompressionS3TC = false;
+};
+
+extern GLExtensions glExtensions;
+
+// Wołać raz, zaraz po gladLoadGLLoader, z tym samym loaderem (np. glfwGetProcAddress)
+void loadGLExtensions(GLADloadproc load);
+// Czy kontekst zgłasza rozszerzenie (lista z glGetStringi(GL_EXTENSIONS, i))
+bool hasGLExtension(const char* name);
+
+#endif
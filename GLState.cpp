@@ -0,0 +1,295 @@
+#include "GLState.h"
+
+namespace
+{
+    const GLuint kUnknown = 0xFFFFFFFFu;   // stan nieznany - następne wywołanie zawsze trafia do sterownika
+
+    // Śledzone cele; pozostałe przechodzą bez pamięci podręcznej
+    const GLenum kBufferTargets[] = { GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER, GL_UNIFORM_BUFFER, GL_PIXEL_UNPACK_BUFFER, GL_PIXEL_PACK_BUFFER };
+    const int kBufferTargetCount = sizeof(kBufferTargets) / sizeof(kBufferTargets[0]);
+    const GLenum kTextureTargets[] = { GL_TEXTURE_2D, GL_TEXTURE_CUBE_MAP, GL_TEXTURE_2D_ARRAY, GL_TEXTURE_3D };
+    const int kTextureTargetCount = sizeof(kTextureTargets) / sizeof(kTextureTargets[0]);
+    const GLenum kCapabilities[] = { GL_DEPTH_TEST, GL_CULL_FACE, GL_BLEND, GL_SCISSOR_TEST, GL_STENCIL_TEST };
+    const int kCapabilityCount = sizeof(kCapabilities) / sizeof(kCapabilities[0]);
+    const int kMaxTextureUnits = 32;
+    const int kMaxUniformBindings = 16;
+
+    struct IndexedBinding
+    {
+        GLuint buffer;
+        GLintptr offset;
+        GLsizeiptr size;
+    };
+
+    struct StateShadow
+    {
+        GLuint program;
+        GLuint vertexArray;
+        GLuint buffers[kBufferTargetCount];
+        IndexedBinding uniformBindings[kMaxUniformBindings];
+        GLuint activeUnit;
+        GLuint textures[kMaxTextureUnits][kTextureTargetCount];
+        GLenum depthFunc;
+        GLuint capabilities[kCapabilityCount];   // 0 / 1 / kUnknown
+        unsigned long long issued;
+        unsigned long long skipped;
+        unsigned long long drawCalls;
+        unsigned long long triangles;
+    };
+
+    StateShadow state;
+    bool stateInitialized = false;
+
+    void resetShadow()
+    {
+        state.program = kUnknown;
+        state.vertexArray = kUnknown;
+        for (int i = 0; i < kBufferTargetCount; ++i) state.buffers[i] = kUnknown;
+        for (int i = 0; i < kMaxUniformBindings; ++i) state.uniformBindings[i].buffer = kUnknown;
+        state.activeUnit = kUnknown;
+        for (int unit = 0; unit < kMaxTextureUnits; ++unit) {
+            for (int i = 0; i < kTextureTargetCount; ++i) state.textures[unit][i] = kUnknown;
+        }
+        state.depthFunc = kUnknown;
+        for (int i = 0; i < kCapabilityCount; ++i) state.capabilities[i] = kUnknown;
+    }
+
+    StateShadow& shadow()
+    {
+        if (!stateInitialized) {
+            resetShadow();
+            state.issued = 0;
+            state.skipped = 0;
+            state.drawCalls = 0;
+            state.triangles = 0;
+            stateInitialized = true;
+        }
+        return state;
+    }
+
+    template<class T>
+    int indexOf(const T* values, int count, T value)
+    {
+        for (int i = 0; i < count; ++i) {
+            if (values[i] == value) return i;
+        }
+        return -1;
+    }
+
+    // true: wartość się zmienia (zapisuje nową i liczy wywołanie), false: pominięte
+    template<class T>
+    bool change(T& current, T value)
+    {
+        StateShadow& s = shadow();
+        if (current == value) {
+            ++s.skipped;
+            return false;
+        }
+        current = value;
+        ++s.issued;
+        return true;
+    }
+
+    void countDraw(GLenum mode, GLsizei count, GLsizei instanceCount)
+    {
+        StateShadow& s = shadow();
+        ++s.drawCalls;
+        if (mode == GL_TRIANGLES) s.triangles += (unsigned long long)(count / 3) * instanceCount;
+        else if (mode == GL_TRIANGLE_STRIP || mode == GL_TRIANGLE_FAN) s.triangles += (unsigned long long)(count > 2 ? count - 2 : 0) * instanceCount;
+    }
+}
+
+void GLState::UseProgram(GLuint program)
+{
+    if (change(shadow().program, program)) glUseProgram(program);
+}
+
+void GLState::BindVertexArray(GLuint vertexArray)
+{
+    StateShadow& s = shadow();
+    if (change(s.vertexArray, vertexArray)) {
+        glBindVertexArray(vertexArray);
+        s.buffers[indexOf(kBufferTargets, kBufferTargetCount, (GLenum)GL_ELEMENT_ARRAY_BUFFER)] = kUnknown;
+    }
+}
+
+void GLState::BindBuffer(GLenum target, GLuint buffer)
+{
+    StateShadow& s = shadow();
+    int index = indexOf(kBufferTargets, kBufferTargetCount, target);
+    if (index < 0) {
+        ++s.issued;
+        glBindBuffer(target, buffer);
+        return;
+    }
+    if (change(s.buffers[index], buffer)) glBindBuffer(target, buffer);
+}
+
+void GLState::BindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+    StateShadow& s = shadow();
+    int targetIndex = indexOf(kBufferTargets, kBufferTargetCount, target);
+    if (target == GL_UNIFORM_BUFFER && index < (GLuint)kMaxUniformBindings) {
+        IndexedBinding& binding = s.uniformBindings[index];
+        if (binding.buffer == buffer && binding.offset == offset && binding.size == size) {
+            ++s.skipped;
+            return;
+        }
+        binding.buffer = buffer;
+        binding.offset = offset;
+        binding.size = size;
+    }
+    ++s.issued;
+    glBindBufferRange(target, index, buffer, offset, size);
+    if (targetIndex >= 0) s.buffers[targetIndex] = buffer;
+}
+
+void GLState::ActiveTexture(GLuint unit)
+{
+    if (change(shadow().activeUnit, unit)) glActiveTexture(GL_TEXTURE0 + unit);
+}
+
+void GLState::BindTexture(GLuint unit, GLenum target, GLuint texture)
+{
+    StateShadow& s = shadow();
+    int targetIndex = indexOf(kTextureTargets, kTextureTargetCount, target);
+    if (targetIndex < 0 || unit >= (GLuint)kMaxTextureUnits) {
+        ActiveTexture(unit);
+        ++s.issued;
+        glBindTexture(target, texture);
+        return;
+    }
+    if (s.textures[unit][targetIndex] == texture) {
+        ++s.skipped;
+        return;
+    }
+    ActiveTexture(unit);
+    s.textures[unit][targetIndex] = texture;
+    ++s.issued;
+    glBindTexture(target, texture);
+}
+
+void GLState::DepthFunc(GLenum func)
+{
+    if (change(shadow().depthFunc, func)) glDepthFunc(func);
+}
+
+void GLState::SetCapability(GLenum capability, bool enabled)
+{
+    StateShadow& s = shadow();
+    int index = indexOf(kCapabilities, kCapabilityCount, capability);
+    if (index >= 0 && !change(s.capabilities[index], (GLuint)(enabled ? 1 : 0))) return;
+    if (index < 0) ++s.issued;
+    if (enabled) glEnable(capability);
+    else glDisable(capability);
+}
+
+void GLState::DeleteProgram(GLuint program)
+{
+    if (program == 0) return;
+    StateShadow& s = shadow();
+    glDeleteProgram(program);
+    // Program aktywny zostaje w użyciu do czasu zmiany - cień nie może go uznać za "0"
+    if (s.program == program) s.program = kUnknown;
+}
+
+void GLState::DeleteVertexArray(GLuint vertexArray)
+{
+    if (vertexArray == 0) return;
+    StateShadow& s = shadow();
+    glDeleteVertexArrays(1, &vertexArray);
+    if (s.vertexArray == vertexArray) {
+        s.vertexArray = 0;
+        s.buffers[indexOf(kBufferTargets, kBufferTargetCount, (GLenum)GL_ELEMENT_ARRAY_BUFFER)] = kUnknown;
+    }
+}
+
+void GLState::DeleteBuffer(GLuint buffer)
+{
+    if (buffer == 0) return;
+    StateShadow& s = shadow();
+    glDeleteBuffers(1, &buffer);
+    for (int i = 0; i < kBufferTargetCount; ++i) {
+        if (s.buffers[i] == buffer) s.buffers[i] = 0;
+    }
+    for (int i = 0; i < kMaxUniformBindings; ++i) {
+        if (s.uniformBindings[i].buffer == buffer) s.uniformBindings[i].buffer = kUnknown;
+    }
+}
+
+void GLState::DeleteTexture(GLuint texture)
+{
+    if (texture == 0) return;
+    StateShadow& s = shadow();
+    glDeleteTextures(1, &texture);
+    for (int unit = 0; unit < kMaxTextureUnits; ++unit) {
+        for (int i = 0; i < kTextureTargetCount; ++i) {
+            if (s.textures[unit][i] == texture) s.textures[unit][i] = 0;
+        }
+    }
+}
+
+void GLState::DrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+    countDraw(mode, count, 1);
+    glDrawArrays(mode, first, count);
+}
+
+void GLState::DrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+{
+    countDraw(mode, count, 1);
+    glDrawElements(mode, count, type, indices);
+}
+
+void GLState::DrawElementsBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* indices, GLint baseVertex)
+{
+    countDraw(mode, count, 1);
+    glDrawElementsBaseVertex(mode, count, type, indices, baseVertex);
+}
+
+void GLState::DrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instanceCount)
+{
+    countDraw(mode, count, instanceCount);
+    glDrawElementsInstanced(mode, count, type, indices, instanceCount);
+}
+
+void GLState::DrawElementsInstancedBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instanceCount, GLint baseVertex)
+{
+    countDraw(mode, count, instanceCount);
+    glDrawElementsInstancedBaseVertex(mode, count, type, indices, instanceCount, baseVertex);
+}
+
+void GLState::Invalidate()
+{
+    shadow();
+    resetShadow();
+}
+
+unsigned long long GLState::IssuedCalls()
+{
+    return shadow().issued;
+}
+
+unsigned long long GLState::SkippedCalls()
+{
+    return shadow().skipped;
+}
+
+unsigned long long GLState::DrawCalls()
+{
+    return shadow().drawCalls;
+}
+
+unsigned long long GLState::Triangles()
+{
+    return shadow().triangles;
+}
+
+void GLState::ResetCounters()
+{
+    StateShadow& s = shadow();
+    s.issued = 0;
+    s.skipped = 0;
+    s.drawCalls = 0;
+    s.triangles = 0;
+}
@@ -0,0 +1,50 @@
+#ifndef GL_STATE_CLASS_H
+#define GL_STATE_CLASS_H
+
+#include <glad/glad.h>
+
+// Cień stanu GL (jeden kontekst, wątek renderujący): bieżący program, VAO, bindingi buforów, aktywna jednostka
+// i tekstury na jednostkach, funkcja głębi i włączone możliwości (glEnable). Wywołanie, które nie zmieniłoby
+// stanu, jest pomijane i liczone. Wszystkie bindingi i usunięcia obiektów w programie muszą iść przez tę klasę -
+// bezpośrednie wywołanie gl* rozsynchronizuje cień (wtedy Invalidate()).
+class GLState
+{
+public:
+    static void UseProgram(GLuint program);
+    // Zmiana VAO unieważnia cień GL_ELEMENT_ARRAY_BUFFER (EBO jest częścią stanu VAO)
+    static void BindVertexArray(GLuint vertexArray);
+    static void BindBuffer(GLenum target, GLuint buffer);
+    // Indeksowany binding (np. UBO pod punktem wiązania); ustawia też zwykły binding target
+    static void BindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+    // unit: numer jednostki (0, 1, ...), nie GL_TEXTURE0 + n
+    static void ActiveTexture(GLuint unit);
+    // Binduje teksturę na jednostce, przełączając aktywną jednostkę tylko wtedy, gdy trzeba
+    static void BindTexture(GLuint unit, GLenum target, GLuint texture);
+    static void DepthFunc(GLenum func);
+    // glEnable / glDisable
+    static void SetCapability(GLenum capability, bool enabled);
+
+    // Rysowanie - przekazywane bez zmian, liczone wywołania i trójkąty (statystyki, benchmark)
+    static void DrawArrays(GLenum mode, GLint first, GLsizei count);
+    static void DrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices);
+    static void DrawElementsBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* indices, GLint baseVertex);
+    static void DrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instanceCount);
+    static void DrawElementsInstancedBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instanceCount, GLint baseVertex);
+
+    // Usunięcie obiektu zeruje jego bindingi (w GL i w cieniu) - identyfikator może zostać użyty ponownie
+    static void DeleteProgram(GLuint program);
+    static void DeleteVertexArray(GLuint vertexArray);
+    static void DeleteBuffer(GLuint buffer);
+    static void DeleteTexture(GLuint texture);
+
+    // Po kodzie, który zmienia stan z pominięciem GLState - każde kolejne wywołanie trafi do sterownika
+    static void Invalidate();
+
+    static unsigned long long IssuedCalls();
+    static unsigned long long SkippedCalls();
+    static unsigned long long DrawCalls();
+    static unsigned long long Triangles();
+    static void ResetCounters();
+};
+
+#endif
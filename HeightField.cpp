@@ -0,0 +1,242 @@
+#include "HeightField.h"
+#include "Terrain.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define HEIGHTFIELD_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+// Jak w Terrain.cpp: GCC/Clang wymagają atrybutu target dla intrynsyk AVX2
+#if defined(HEIGHTFIELD_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define HEIGHTFIELD_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define HEIGHTFIELD_TARGET_AVX2
+#endif
+
+// Rozsuwa 16 młodszych bitów co drugą pozycję (0b1011 -> 0b1000101)
+static unsigned int mortonPart1By1(unsigned int v)
+{
+    v &= 0x0000FFFFu;
+    v = (v | (v << 8)) & 0x00FF00FFu;
+    v = (v | (v << 4)) & 0x0F0F0F0Fu;
+    v = (v | (v << 2)) & 0x33333333u;
+    v = (v | (v << 1)) & 0x55555555u;
+    return v;
+}
+
+static int nextPowerOfTwo(int v)
+{
+    int p = 1;
+    while (p < v) p <<= 1;
+    return p;
+}
+
+HeightField::HeightField(const glm::vec2& origin, float size, int pointsPerSide, float amplitude, float frequency,
+    HeightFieldLayout layout, ThreadPool* pool)
+    : origin(origin), size(size), amplitude(amplitude), frequency(frequency), layout(layout)
+{
+    pointsPerSide = std::max(2, pointsPerSide);
+    if (layout == HeightFieldLayout::Morton) pointsPerSide = nextPowerOfTwo(pointsPerSide);
+    this->pointsPerSide = pointsPerSide;
+    spacing = size / (pointsPerSide - 1);
+    invSpacing = 1.0f / spacing;
+
+    glm::vec2 curvature = heightCurvatureBound(amplitude, frequency);
+    errorBound = spacing * spacing / 8.0f * (curvature.x + curvature.y);
+
+    heights.resize((size_t)pointsPerSide * pointsPerSide);
+    const int n = pointsPerSide;
+    auto bakeRows = [this, n](int rowBegin, int rowEnd) {
+        std::vector<float> row(n);
+        for (int iz = rowBegin; iz < rowEnd; ++iz) {
+            float z = this->origin.y + (float)iz * spacing;
+            getHeightRow(this->origin.x, spacing, z, n, this->amplitude, this->frequency, row.data(), nullptr);
+            if (this->layout == HeightFieldLayout::RowMajor) {
+                std::copy(row.begin(), row.end(), heights.begin() + (size_t)iz * n);
+            }
+            else {
+                for (int ix = 0; ix < n; ++ix) heights[Index(ix, iz)] = row[ix];
+            }
+        }
+    };
+    if (pool) {
+        pool->ParallelFor(0, n, 16, bakeRows);
+    }
+    else {
+        bakeRows(0, n);
+    }
+}
+
+size_t HeightField::Index(int ix, int iz) const
+{
+    if (layout == HeightFieldLayout::Morton) {
+        return mortonPart1By1((unsigned int)ix) | (mortonPart1By1((unsigned int)iz) << 1);
+    }
+    return (size_t)iz * pointsPerSide + ix;
+}
+
+float HeightField::SampleWithGradient(float x, float z, float& dhdx, float& dhdz) const
+{
+    const float maxCoord = (float)(pointsPerSide - 1);
+    float gx = std::min(std::max((x - origin.x) * invSpacing, 0.0f), maxCoord);
+    float gz = std::min(std::max((z - origin.y) * invSpacing, 0.0f), maxCoord);
+    int ix = std::min((int)gx, pointsPerSide - 2);
+    int iz = std::min((int)gz, pointsPerSide - 2);
+    float fx = gx - (float)ix;
+    float fz = gz - (float)iz;
+
+    float h00 = heights[Index(ix, iz)];
+    float h10 = heights[Index(ix + 1, iz)];
+    float h01 = heights[Index(ix, iz + 1)];
+    float h11 = heights[Index(ix + 1, iz + 1)];
+
+    float h0 = h00 + (h10 - h00) * fx;
+    float h1 = h01 + (h11 - h01) * fx;
+    dhdx = ((h10 - h00) + ((h11 - h01) - (h10 - h00)) * fz) * invSpacing;
+    dhdz = (h1 - h0) * invSpacing;
+    return h0 + (h1 - h0) * fz;
+}
+
+float HeightField::Sample(float x, float z) const
+{
+    float dhdx, dhdz;
+    return SampleWithGradient(x, z, dhdx, dhdz);
+}
+
+glm::vec3 HeightField::SampleNormal(float x, float z) const
+{
+    float dhdx, dhdz;
+    SampleWithGradient(x, z, dhdx, dhdz);
+    float invLength = 1.0f / std::sqrt(dhdx * dhdx + 1.0f + dhdz * dhdz);
+    return glm::vec3(-dhdx * invLength, invLength, -dhdz * invLength);
+}
+
+#ifdef HEIGHTFIELD_SIMD_X86
+
+HEIGHTFIELD_TARGET_AVX2
+static __m256i mortonPart1By1AVX2(__m256i v)
+{
+    v = _mm256_and_si256(v, _mm256_set1_epi32(0x0000FFFF));
+    v = _mm256_and_si256(_mm256_or_si256(v, _mm256_slli_epi32(v, 8)), _mm256_set1_epi32(0x00FF00FF));
+    v = _mm256_and_si256(_mm256_or_si256(v, _mm256_slli_epi32(v, 4)), _mm256_set1_epi32(0x0F0F0F0F));
+    v = _mm256_and_si256(_mm256_or_si256(v, _mm256_slli_epi32(v, 2)), _mm256_set1_epi32(0x33333333));
+    v = _mm256_and_si256(_mm256_or_si256(v, _mm256_slli_epi32(v, 1)), _mm256_set1_epi32(0x55555555));
+    return v;
+}
+
+// Osiem punktów naraz: indeksy komórek w rejestrach, cztery narożniki pobierane przez _mm256_i32gather_ps.
+// Kolejność działań jak w SampleWithGradient, więc wynik jest bitowo zgodny ze ścieżką skalarną.
+// Zwraca liczbę przetworzonych punktów (wielokrotność 8).
+HEIGHTFIELD_TARGET_AVX2
+static int sampleBatchAVX2(const float* heights, int pointsPerSide, bool morton, float originX, float originZ, float invSpacing,
+    const float* xs, const float* zs, int count, float* outHeights, float* outNormals)
+{
+    const __m256 vOriginX = _mm256_set1_ps(originX);
+    const __m256 vOriginZ = _mm256_set1_ps(originZ);
+    const __m256 vInvSpacing = _mm256_set1_ps(invSpacing);
+    const __m256 vZero = _mm256_setzero_ps();
+    const __m256 vOne = _mm256_set1_ps(1.0f);
+    const __m256 vMaxCoord = _mm256_set1_ps((float)(pointsPerSide - 1));
+    const __m256i vMaxCell = _mm256_set1_epi32(pointsPerSide - 2);
+    const __m256i vOneI = _mm256_set1_epi32(1);
+    const __m256i vRow = _mm256_set1_epi32(pointsPerSide);
+    alignas(32) float nx[8], ny[8], nz[8];
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 gx = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(xs + i), vOriginX), vInvSpacing), vZero), vMaxCoord);
+        __m256 gz = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(zs + i), vOriginZ), vInvSpacing), vZero), vMaxCoord);
+        __m256i ix = _mm256_min_epi32(_mm256_cvttps_epi32(gx), vMaxCell);
+        __m256i iz = _mm256_min_epi32(_mm256_cvttps_epi32(gz), vMaxCell);
+        __m256 fx = _mm256_sub_ps(gx, _mm256_cvtepi32_ps(ix));
+        __m256 fz = _mm256_sub_ps(gz, _mm256_cvtepi32_ps(iz));
+
+        __m256i i00, i10, i01, i11;
+        if (morton) {
+            __m256i px0 = mortonPart1By1AVX2(ix);
+            __m256i px1 = mortonPart1By1AVX2(_mm256_add_epi32(ix, vOneI));
+            __m256i pz0 = _mm256_slli_epi32(mortonPart1By1AVX2(iz), 1);
+            __m256i pz1 = _mm256_slli_epi32(mortonPart1By1AVX2(_mm256_add_epi32(iz, vOneI)), 1);
+            i00 = _mm256_or_si256(px0, pz0);
+            i10 = _mm256_or_si256(px1, pz0);
+            i01 = _mm256_or_si256(px0, pz1);
+            i11 = _mm256_or_si256(px1, pz1);
+        }
+        else {
+            i00 = _mm256_add_epi32(_mm256_mullo_epi32(iz, vRow), ix);
+            i10 = _mm256_add_epi32(i00, vOneI);
+            i01 = _mm256_add_epi32(i00, vRow);
+            i11 = _mm256_add_epi32(i01, vOneI);
+        }
+        __m256 h00 = _mm256_i32gather_ps(heights, i00, 4);
+        __m256 h10 = _mm256_i32gather_ps(heights, i10, 4);
+        __m256 h01 = _mm256_i32gather_ps(heights, i01, 4);
+        __m256 h11 = _mm256_i32gather_ps(heights, i11, 4);
+
+        __m256 d0 = _mm256_sub_ps(h10, h00);
+        __m256 d1 = _mm256_sub_ps(h11, h01);
+        __m256 h0 = _mm256_add_ps(h00, _mm256_mul_ps(d0, fx));
+        __m256 h1 = _mm256_add_ps(h01, _mm256_mul_ps(d1, fx));
+        __m256 dh = _mm256_sub_ps(h1, h0);
+        _mm256_storeu_ps(outHeights + i, _mm256_add_ps(h0, _mm256_mul_ps(dh, fz)));
+
+        if (outNormals) {
+            __m256 dhdx = _mm256_mul_ps(_mm256_add_ps(d0, _mm256_mul_ps(_mm256_sub_ps(d1, d0), fz)), vInvSpacing);
+            __m256 dhdz = _mm256_mul_ps(dh, vInvSpacing);
+            __m256 lengthSq = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dhdx, dhdx), vOne), _mm256_mul_ps(dhdz, dhdz));
+            __m256 invLength = _mm256_div_ps(vOne, _mm256_sqrt_ps(lengthSq));
+            _mm256_store_ps(nx, _mm256_mul_ps(_mm256_sub_ps(vZero, dhdx), invLength));
+            _mm256_store_ps(ny, invLength);
+            _mm256_store_ps(nz, _mm256_mul_ps(_mm256_sub_ps(vZero, dhdz), invLength));
+            for (int k = 0; k < 8; ++k) {
+                outNormals[(i + k) * 3] = nx[k];
+                outNormals[(i + k) * 3 + 1] = ny[k];
+                outNormals[(i + k) * 3 + 2] = nz[k];
+            }
+        }
+    }
+    return i;
+}
+
+#endif // HEIGHTFIELD_SIMD_X86
+
+void HeightField::SampleBatch(const float* xs, const float* zs, int count, float* outHeights, float* outNormals) const
+{
+    int done = 0;
+#ifdef HEIGHTFIELD_SIMD_X86
+    if (getHeightSimdLevel() == HeightSimdLevel::AVX2) {
+        done = sampleBatchAVX2(heights.data(), pointsPerSide, layout == HeightFieldLayout::Morton, origin.x, origin.y, invSpacing,
+            xs, zs, count, outHeights, outNormals);
+    }
+#endif
+    for (int i = done; i < count; ++i) {
+        float dhdx, dhdz;
+        outHeights[i] = SampleWithGradient(xs[i], zs[i], dhdx, dhdz);
+        if (outNormals) {
+            float invLength = 1.0f / std::sqrt(dhdx * dhdx + 1.0f + dhdz * dhdz);
+            outNormals[i * 3] = -dhdx * invLength;
+            outNormals[i * 3 + 1] = invLength;
+            outNormals[i * 3 + 2] = -dhdz * invLength;
+        }
+    }
+}
+
+float HeightField::MeasureMaxError(int sampleCount) const
+{
+    // Prosty generator LCG - powtarzalne punkty bez zależności od <random>
+    unsigned int state = 12345u;
+    auto next01 = [&state]() {
+        state = state * 1664525u + 1013904223u;
+        return (float)(state >> 8) / 16777216.0f;
+    };
+    float maxError = 0.0f;
+    for (int i = 0; i < sampleCount; ++i) {
+        float x = origin.x + next01() * size;
+        float z = origin.y + next01() * size;
+        maxError = std::max(maxError, std::fabs(Sample(x, z) - getHeight(x, z, amplitude, frequency)));
+    }
+    return maxError;
+}
@@ -0,0 +1,58 @@
+#ifndef HEIGHT_FIELD_CLASS_H
+#define HEIGHT_FIELD_CLASS_H
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstddef>
+
+class ThreadPool;
+
+// Kolejność próbek w pamięci: wierszami albo krzywą Mortona (Z-order) - sąsiednie komórki
+// w obu osiach leżą wtedy blisko siebie, co pomaga przy zapytaniach rozrzuconych po obszarze.
+enum class HeightFieldLayout { RowMajor, Morton };
+
+// Wysokości getHeight wypieczone do regularnej siatki N x N punktów nad kwadratem [origin, origin + size].
+// Zapytania to interpolacja dwuliniowa (4 odczyty zamiast czterech oktaw sin/cos);
+// punkty poza obszarem są przycinane do krawędzi.
+class HeightField
+{
+public:
+    // pointsPerSide >= 2; w układzie Morton zaokrąglane w górę do potęgi dwójki.
+    // Z pulą wątków wiersze wypiekane są równolegle.
+    HeightField(const glm::vec2& origin, float size, int pointsPerSide, float amplitude, float frequency,
+        HeightFieldLayout layout = HeightFieldLayout::RowMajor, ThreadPool* pool = nullptr);
+
+    float Sample(float x, float z) const;
+    // Normalna powierzchni dwuliniowej (ta sama, na której stoją obiekty osadzone przez Sample)
+    glm::vec3 SampleNormal(float x, float z) const;
+
+    // Wsadowo dla count punktów; outNormals: count*3 floatów (nx, ny, nz) lub nullptr.
+    // Ścieżka AVX2 (gather) lub skalarna, wg getHeightSimdLevel(); wyniki są identyczne z Sample/SampleNormal.
+    void SampleBatch(const float* xs, const float* zs, int count, float* outHeights, float* outNormals) const;
+
+    // Gwarantowane ograniczenie |Sample - getHeight| dla interpolacji dwuliniowej:
+    // (h²/8) * (max|h_xx| + max|h_zz|), h - odstęp siatki.
+    float ErrorBound() const { return errorBound; }
+    // Zmierzony maksymalny błąd względem getHeight na sampleCount pseudolosowych punktach
+    float MeasureMaxError(int sampleCount) const;
+
+    int PointsPerSide() const { return pointsPerSide; }
+    float Spacing() const { return spacing; }
+    size_t Bytes() const { return heights.size() * sizeof(float); }
+
+private:
+    glm::vec2 origin;
+    float size;
+    int pointsPerSide;
+    float spacing, invSpacing;
+    float amplitude, frequency;
+    float errorBound;
+    HeightFieldLayout layout;
+    std::vector<float> heights;
+
+    size_t Index(int ix, int iz) const;
+    // Wspólna część Sample/SampleNormal: wysokość i gradient (dh/dx, dh/dz)
+    float SampleWithGradient(float x, float z, float& dhdx, float& dhdz) const;
+};
+
+#endif
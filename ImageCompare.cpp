@@ -0,0 +1,118 @@
+#include "ImageCompare.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+namespace
+{
+    // Kwadrat różnicy YIQ największy możliwy dla RGB8 (czarny - biały w pixelmatch)
+    const double kMaxYiqDelta = 35215.0;
+
+    double yiqDelta(const unsigned char* a, const unsigned char* b)
+    {
+        const double y = (a[0] - b[0]) * 0.29889531 + (a[1] - b[1]) * 0.58662247 + (a[2] - b[2]) * 0.11448223;
+        const double i = (a[0] - b[0]) * 0.59597799 - (a[1] - b[1]) * 0.27417610 - (a[2] - b[2]) * 0.32180189;
+        const double q = (a[0] - b[0]) * 0.21147017 - (a[1] - b[1]) * 0.52261711 + (a[2] - b[2]) * 0.31114694;
+        return (0.5053 * y * y + 0.299 * i * i + 0.1957 * q * q) / kMaxYiqDelta;
+    }
+
+    // Pomija białe znaki i komentarze nagłówka PPM
+    bool readHeaderValue(std::istream& file, int& value)
+    {
+        while (true) {
+            const int c = file.peek();
+            if (c == '#') {
+                std::string comment;
+                std::getline(file, comment);
+            }
+            else if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+                file.get();
+            }
+            else {
+                break;
+            }
+        }
+        return (bool)(file >> value);
+    }
+}
+
+bool writePPM(const std::string& path, int width, int height, const std::vector<unsigned char>& rgb)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+    file << "P6\n" << width << " " << height << "\n255\n";
+    file.write(reinterpret_cast<const char*>(rgb.data()), (std::streamsize)((size_t)width * height * 3));
+    return (bool)file;
+}
+
+bool readPPM(const std::string& path, int& width, int& height, std::vector<unsigned char>& rgb, std::string& failure)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        failure = "brak pliku " + path;
+        return false;
+    }
+    char magic[2] = { 0, 0 };
+    file.read(magic, 2);
+    int maxValue = 0;
+    if (magic[0] != 'P' || magic[1] != '6' || !readHeaderValue(file, width) || !readHeaderValue(file, height)
+        || !readHeaderValue(file, maxValue) || width <= 0 || height <= 0 || maxValue != 255) {
+        failure = path + ": oczekiwano PPM P6 (RGB8)";
+        return false;
+    }
+    file.get(); // jeden biały znak po maxval
+    rgb.resize((size_t)width * height * 3);
+    file.read(reinterpret_cast<char*>(rgb.data()), (std::streamsize)rgb.size());
+    if (file.gcount() != (std::streamsize)rgb.size()) {
+        failure = path + ": plik ucięty";
+        return false;
+    }
+    return true;
+}
+
+ImageDifference compareImages(const std::vector<unsigned char>& expected, const std::vector<unsigned char>& actual,
+                              int width, int height, double threshold, std::vector<unsigned char>& diff)
+{
+    ImageDifference result;
+    const size_t pixelCount = (size_t)width * height;
+    diff.resize(pixelCount * 3);
+    for (size_t i = 0; i < pixelCount; ++i) {
+        const unsigned char* a = &expected[i * 3];
+        const unsigned char* b = &actual[i * 3];
+        const double delta = yiqDelta(a, b);
+        result.maxDelta = std::max(result.maxDelta, delta);
+        unsigned char* out = &diff[i * 3];
+        if (delta > threshold * threshold) {
+            ++result.differentPixels;
+            out[0] = 255;
+            out[1] = 0;
+            out[2] = 0;
+        }
+        else {
+            const unsigned char grey = (unsigned char)(160 + (a[0] * 0.299 + a[1] * 0.587 + a[2] * 0.114) * 0.35);
+            out[0] = out[1] = out[2] = grey;
+        }
+    }
+    result.maxDelta = std::sqrt(result.maxDelta);
+    result.differentFraction = pixelCount > 0 ? (double)result.differentPixels / pixelCount : 0.0;
+    return result;
+}
+
+bool checkImageCompareThreshold(std::string& failure)
+{
+    // Szare przesunięcie s: dy = s, di = dq ~ 0, więc różni się, gdy 0.5053 * s^2 / 35215 > 0.1^2, czyli s > 26.4
+    struct Case { int shift; bool different; };
+    const Case cases[] = { { 0, false }, { 26, false }, { 27, true }, { 80, true } };
+    const std::vector<unsigned char> expected(3, 100);
+    std::vector<unsigned char> diff;
+    for (const Case& c : cases) {
+        const std::vector<unsigned char> actual(3, (unsigned char)(100 + c.shift));
+        const bool different = compareImages(expected, actual, 1, 1, 0.1, diff).differentPixels > 0;
+        if (different != c.different) {
+            failure = "compareImages: przesunięcie szarości o " + std::to_string(c.shift) + "/255 przy progu 0.1 "
+                    + (c.different ? "uznane za identyczne" : "uznane za różne");
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,29 @@
+#ifndef IMAGE_COMPARE_CLASS_H
+#define IMAGE_COMPARE_CLASS_H
+
+#include <string>
+#include <vector>
+
+// Obrazy RGB8 (wiersze od góry) w formacie PPM P6 i porównanie percepcyjne do bramki regresji.
+bool writePPM(const std::string& path, int width, int height, const std::vector<unsigned char>& rgb);
+// false i powód w failure, gdy plik nie istnieje albo nie jest PPM P6 z maxval 255
+bool readPPM(const std::string& path, int& width, int& height, std::vector<unsigned char>& rgb, std::string& failure);
+
+struct ImageDifference
+{
+    int differentPixels = 0;
+    double differentFraction = 0.0;
+    double maxDelta = 0.0;   // największa różnica piksela w jednostkach threshold, 0..1
+};
+
+// Różnica piksela w przestrzeni YIQ jak w pixelmatch: kwadrat różnicy ważony (jasność, chrominancja), znormalizowany
+// do 0..1 i porównywany z threshold^2 - przy threshold 0.1 różni się już szare przesunięcie o ok. 27/255.
+// diff: obraz oczekiwany przygaszony do szarości, różniące się piksele na czerwono.
+ImageDifference compareImages(const std::vector<unsigned char>& expected, const std::vector<unsigned char>& actual,
+                              int width, int height, double threshold, std::vector<unsigned char>& diff);
+
+// Sprawdzenie progu na obrazach testowych (szare przesunięcie tuż poniżej i tuż powyżej progu pixelmatch 0.1);
+// false i opis w failure, gdy compareImages nie zgadza się z pixelmatch - bramka nie powinna wtedy nic oceniać
+bool checkImageCompareThreshold(std::string& failure);
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef MAPPED_FILE_CLASS_H
+#define MAPPED_FILE_CLASS_H
+
+#include <string>
+#include <cstddef>
+
+// Plik tylko do odczytu zmapowany w pamięć (MapViewOfFile na Windows, mmap na POSIX).
+// Dane czytane są bezpośrednio ze stron pliku - bez kopiowania do własnych buforów.
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    // Zwraca false, gdy pliku nie ma, jest pusty albo mapowanie się nie powiodło
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const { return data != nullptr; }
+    const unsigned char* Data() const { return data; }
+    size_t Size() const { return size; }
+
+private:
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+    const unsigned char* data;
+    size_t size;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#else
+    int fileDescriptor;
+#endif
+};
+
+#endif
@@ -0,0 +1,216 @@
+#include "MeshCache.h"
+#include "FileUtils.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+    // Zmiana układu PackedVertex, nagłówka albo generatorów wymaga podbicia wersji - stare pliki zostaną odrzucone
+    const uint32_t kMeshCacheVersion = 2;
+    const char kMeshCacheMagic[4] = { 'G', 'K', 'M', 'C' };
+
+    // Nagłówek ma rozmiar wielokrotności 16 B, więc blok wierzchołków jest wyrównany w zmapowanym pliku
+    struct MeshCacheHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint64_t key;
+        uint32_t vertexStride;
+        uint32_t vertexCount;
+        uint32_t indexType;
+        uint32_t indexCount;
+        uint64_t vertexOffset;
+        uint64_t vertexBytes;
+        uint64_t indexOffset;
+        uint64_t indexBytes;
+        uint64_t sectionOffset;
+        uint64_t payloadChecksum; // wierzchołki, indeksy i sekcje - od vertexOffset do końca pliku
+        float texCoordScale;
+        uint32_t sectionCount;
+        uint64_t reserved;
+    };
+    static_assert(sizeof(MeshCacheHeader) % 16 == 0, "MeshCacheHeader musi mieć rozmiar wielokrotności 16 B");
+}
+
+MeshCacheKey::MeshCacheKey(const char* generatorName)
+    : name(generatorName), hash(kFnvOffset)
+{
+    hash = fnv1a(hash, &kMeshCacheVersion, sizeof(kMeshCacheVersion));
+    hash = fnv1a(hash, name.data(), name.size());
+}
+
+MeshCacheKey& MeshCacheKey::Add(int value)
+{
+    return Add(&value, sizeof(value));
+}
+
+MeshCacheKey& MeshCacheKey::Add(float value)
+{
+    return Add(&value, sizeof(value));
+}
+
+MeshCacheKey& MeshCacheKey::Add(const void* bytes, size_t count)
+{
+    hash = fnv1a(hash, bytes, count);
+    return *this;
+}
+
+void CachedMesh::Release()
+{
+    file.Close();
+    builtVertices.vertices.clear();
+    builtVertices.vertices.shrink_to_fit();
+    builtIndices.indices16.clear();
+    builtIndices.indices16.shrink_to_fit();
+    builtIndices.indices32.clear();
+    builtIndices.indices32.shrink_to_fit();
+    vertexData = nullptr;
+    indexData = nullptr;
+}
+
+MeshCache::MeshCache(const std::string& cacheDirectory)
+    : directory(cacheDirectory), directoryReady(false)
+{
+    directoryReady = makeDirectory(directory);
+    if (!directoryReady) {
+        std::cerr << "MeshCache: nie można utworzyć katalogu " << directory << " - siatki będą generowane przy każdym starcie" << std::endl;
+    }
+}
+
+std::string MeshCache::PathFor(const MeshCacheKey& key) const
+{
+    char hex[17];
+    for (int i = 0; i < 16; ++i) {
+        hex[i] = "0123456789abcdef"[(key.Hash() >> (60 - i * 4)) & 0xF];
+    }
+    hex[16] = '\0';
+    return directory + "/" + key.Name() + "_" + hex + ".mesh";
+}
+
+bool MeshCache::Load(const MeshCacheKey& key, CachedMesh& out)
+{
+    std::string path = PathFor(key);
+    if (!out.file.Open(path)) return false;
+
+    const unsigned char* bytes = out.file.Data();
+    const size_t fileSize = out.file.Size();
+    MeshCacheHeader header;
+    bool valid = fileSize >= sizeof(header);
+    if (valid) {
+        std::memcpy(&header, bytes, sizeof(header));
+        size_t indexSize = header.indexType == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint);
+        valid = std::memcmp(header.magic, kMeshCacheMagic, sizeof(kMeshCacheMagic)) == 0
+            && header.version == kMeshCacheVersion
+            && header.key == key.Hash()
+            && header.vertexStride == sizeof(PackedVertex)
+            && (header.indexType == GL_UNSIGNED_SHORT || header.indexType == GL_UNSIGNED_INT)
+            && header.vertexBytes == (uint64_t)header.vertexCount * header.vertexStride
+            && header.indexBytes == (uint64_t)header.indexCount * indexSize
+            && header.vertexOffset == sizeof(header)
+            && header.indexOffset == header.vertexOffset + header.vertexBytes
+            && header.sectionOffset == header.indexOffset + header.indexBytes
+            && header.sectionCount > 0
+            && header.sectionOffset + (uint64_t)header.sectionCount * sizeof(MeshSection) == fileSize;
+    }
+    if (valid) {
+        // Suma kontrolna całego bloku danych wykrywa obcięte lub nadpisane pliki
+        valid = fnv1a(kFnvOffset, bytes + header.vertexOffset, (size_t)(fileSize - header.vertexOffset)) == header.payloadChecksum;
+    }
+    if (!valid) {
+        out.file.Close();
+        std::remove(path.c_str());
+        std::cout << "MeshCache: odrzucono uszkodzony lub nieaktualny plik " << path << std::endl;
+        return false;
+    }
+
+    out.vertexData = bytes + header.vertexOffset;
+    out.vertexBytes = (GLsizeiptr)header.vertexBytes;
+    out.vertexCount = (GLsizei)header.vertexCount;
+    out.indexData = bytes + header.indexOffset;
+    out.indexBytes = (GLsizeiptr)header.indexBytes;
+    out.indexType = (GLenum)header.indexType;
+    out.indexCount = (GLsizei)header.indexCount;
+    out.texCoordScale = header.texCoordScale;
+    out.sections.resize(header.sectionCount);
+    std::memcpy(out.sections.data(), bytes + header.sectionOffset, header.sectionCount * sizeof(MeshSection)); // blok może nie być wyrównany
+    out.fromCache = true;
+    return true;
+}
+
+bool MeshCache::Store(const MeshCacheKey& key, const PackedMesh& vertices, const IndexData& indices, const std::vector<MeshSection>& sections)
+{
+    if (!directoryReady) return false;
+
+    MeshCacheHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMeshCacheMagic, sizeof(kMeshCacheMagic));
+    header.version = kMeshCacheVersion;
+    header.key = key.Hash();
+    header.vertexStride = sizeof(PackedVertex);
+    header.vertexCount = (uint32_t)vertices.vertices.size();
+    header.indexType = indices.type;
+    header.indexCount = (uint32_t)indices.count;
+    header.vertexOffset = sizeof(header);
+    header.vertexBytes = vertices.vertices.size() * sizeof(PackedVertex);
+    header.indexOffset = header.vertexOffset + header.vertexBytes;
+    header.indexBytes = (uint64_t)indices.Bytes();
+    header.sectionOffset = header.indexOffset + header.indexBytes;
+    header.sectionCount = (uint32_t)sections.size();
+    const uint64_t sectionBytes = sections.size() * sizeof(MeshSection);
+    uint64_t checksum = fnv1a(kFnvOffset, vertices.vertices.data(), (size_t)header.vertexBytes);
+    checksum = fnv1a(checksum, indices.Data(), (size_t)header.indexBytes);
+    header.payloadChecksum = fnv1a(checksum, sections.data(), (size_t)sectionBytes);
+    header.texCoordScale = vertices.texCoordScale;
+
+    // Zapis do pliku tymczasowego i podmiana - przerwany zapis nie zostawi pliku z poprawną nazwą
+    std::string path = PathFor(key);
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file) return false;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(vertices.vertices.data()), (std::streamsize)header.vertexBytes);
+        file.write(reinterpret_cast<const char*>(indices.Data()), (std::streamsize)header.indexBytes);
+        file.write(reinterpret_cast<const char*>(sections.data()), (std::streamsize)sectionBytes);
+        if (!file) {
+            file.close();
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+    std::remove(path.c_str()); // rename na Windows nie nadpisuje istniejącego pliku
+    if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+void MeshCache::LoadOrBuild(const MeshCacheKey& key, const BuildFunction& build, CachedMesh& out)
+{
+    if (Load(key, out)) {
+        std::cout << "MeshCache: " << key.Name() << " wczytana z " << PathFor(key) << std::endl;
+        return;
+    }
+
+    out.sections.clear();
+    build(out.builtVertices, out.builtIndices, out.sections);
+    if (out.sections.empty()) {
+        MeshSection whole = { 0, (uint32_t)out.builtIndices.count, 0, (uint32_t)out.builtVertices.vertices.size() };
+        out.sections.push_back(whole);
+    }
+    if (!Store(key, out.builtVertices, out.builtIndices, out.sections)) {
+        std::cerr << "MeshCache: nie udało się zapisać " << PathFor(key) << std::endl;
+    }
+    out.vertexData = out.builtVertices.vertices.data();
+    out.vertexBytes = (GLsizeiptr)(out.builtVertices.vertices.size() * sizeof(PackedVertex));
+    out.vertexCount = (GLsizei)out.builtVertices.vertices.size();
+    out.indexData = out.builtIndices.Data();
+    out.indexBytes = out.builtIndices.Bytes();
+    out.indexType = out.builtIndices.type;
+    out.indexCount = out.builtIndices.count;
+    out.texCoordScale = out.builtVertices.texCoordScale;
+    out.fromCache = false;
+}
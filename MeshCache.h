@@ -0,0 +1,86 @@
+#ifndef MESH_CACHE_CLASS_H
+#define MESH_CACHE_CLASS_H
+
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include "MappedFile.h"
+#include "VertexPacking.h"
+#include "MeshOptimizer.h"
+
+// Klucz wpisu: FNV-1a (64 bit) z nazwy generatora i wszystkich jego parametrów
+class MeshCacheKey
+{
+public:
+    explicit MeshCacheKey(const char* generatorName);
+
+    MeshCacheKey& Add(int value);
+    MeshCacheKey& Add(float value);
+    MeshCacheKey& Add(const void* bytes, size_t count);
+
+    uint64_t Hash() const { return hash; }
+    const std::string& Name() const { return name; }
+
+private:
+    std::string name;
+    uint64_t hash;
+};
+
+// Podzakres wspólnego VBO/EBO (np. jeden poziom LOD): indeksy [firstIndex, firstIndex + indexCount) względem baseVertex
+struct MeshSection
+{
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    int32_t baseVertex;
+    uint32_t vertexCount;
+};
+
+// Siatka gotowa do wysłania na GPU: wskaźniki do zmapowanego pliku cache albo do świeżo zbudowanych tablic
+struct CachedMesh
+{
+    const void* vertexData = nullptr;
+    GLsizeiptr vertexBytes = 0;
+    GLsizei vertexCount = 0;
+    const void* indexData = nullptr;
+    GLsizeiptr indexBytes = 0;
+    GLenum indexType = GL_UNSIGNED_INT;
+    GLsizei indexCount = 0;
+    float texCoordScale = 1.0f;
+    bool fromCache = false;
+    std::vector<MeshSection> sections; // co najmniej jedna sekcja (cała siatka)
+
+    // Zwalnia mapowanie / tablice - wołać po wysłaniu danych do VBO/EBO
+    void Release();
+
+    MappedFile file;
+    PackedMesh builtVertices;
+    IndexData builtIndices;
+};
+
+// Dyskowa pamięć podręczna siatek (PackedVertex + indeksy po optymalizacji) w katalogu cacheDirectory.
+// Plik: nagłówek (magia, wersja formatu, klucz, rozmiary, suma kontrolna) + surowe bloki wierzchołków, indeksów i sekcji.
+// Odczyt to mmap i wskaźniki prosto do danych - bez parsowania elementów.
+// Uszkodzone lub nieaktualne pliki są usuwane i budowane od nowa.
+class MeshCache
+{
+public:
+    explicit MeshCache(const std::string& cacheDirectory);
+
+    // sections może zostać puste - zapisana zostanie wtedy jedna sekcja obejmująca całą siatkę
+    typedef std::function<void(PackedMesh& vertices, IndexData& indices, std::vector<MeshSection>& sections)> BuildFunction;
+
+    // Wypełnia out z cache albo woła build, zapisuje wynik i wypełnia out zbudowanymi danymi
+    void LoadOrBuild(const MeshCacheKey& key, const BuildFunction& build, CachedMesh& out);
+
+private:
+    std::string directory;
+    bool directoryReady;
+
+    std::string PathFor(const MeshCacheKey& key) const;
+    bool Load(const MeshCacheKey& key, CachedMesh& out);
+    bool Store(const MeshCacheKey& key, const PackedMesh& vertices, const IndexData& indices, const std::vector<MeshSection>& sections);
+};
+
+#endif
@@ -0,0 +1,200 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+float computeACMR(const std::vector<GLuint>& indices, size_t vertexCount, int cacheSize)
+{
+    if (indices.size() < 3) return 0.0f;
+    // FIFO: wierzchołek trafia do cache tylko przy chybieniu, więc "wiek" liczymy od chwili wstawienia
+    std::vector<size_t> insertedAt(vertexCount, 0);
+    std::vector<bool> everInserted(vertexCount, false);
+    size_t misses = 0;
+    for (GLuint index : indices) {
+        if (!everInserted[index] || misses - insertedAt[index] >= (size_t)cacheSize) {
+            insertedAt[index] = misses;
+            everInserted[index] = true;
+            ++misses;
+        }
+    }
+    return (float)misses / (float)(indices.size() / 3);
+}
+
+// Parametry oceny wierzchołka wg Forsytha
+namespace
+{
+    const float kCacheDecayPower = 1.5f;
+    const float kLastTriScore = 0.75f;
+    const float kValenceBoostScale = 2.0f;
+    const float kValenceBoostPower = 0.5f;
+    const int kMaxValenceScore = 32;
+
+    struct ScoreTables
+    {
+        float cache[kVertexCacheSize];
+        float valence[kMaxValenceScore];
+
+        ScoreTables()
+        {
+            for (int i = 0; i < kVertexCacheSize; ++i) {
+                if (i < 3) {
+                    cache[i] = kLastTriScore; // trzy wierzchołki ostatniego trójkąta - celowo niżej, żeby nie wracać do pasa
+                }
+                else {
+                    float scaler = 1.0f / (kVertexCacheSize - 3);
+                    cache[i] = std::pow(1.0f - (i - 3) * scaler, kCacheDecayPower);
+                }
+            }
+            valence[0] = 0.0f;
+            for (int i = 1; i < kMaxValenceScore; ++i) {
+                valence[i] = kValenceBoostScale * std::pow((float)i, -kValenceBoostPower);
+            }
+        }
+    };
+
+    float vertexScore(const ScoreTables& tables, int cachePosition, int remainingTriangles)
+    {
+        if (remainingTriangles == 0) return -1.0f; // wierzchołek już niepotrzebny
+        float score = cachePosition >= 0 ? tables.cache[cachePosition] : 0.0f;
+        score += tables.valence[std::min(remainingTriangles, kMaxValenceScore - 1)];
+        return score;
+    }
+}
+
+void optimizeVertexCache(std::vector<GLuint>& indices, size_t vertexCount)
+{
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) return;
+    static const ScoreTables tables;
+
+    // Listy trójkątów każdego wierzchołka; pierwsze liveCount[v] pozycji to trójkąty jeszcze nie wyemitowane
+    std::vector<int> liveCount(vertexCount, 0);
+    for (GLuint index : indices) ++liveCount[index];
+    std::vector<size_t> adjacencyOffset(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v) adjacencyOffset[v + 1] = adjacencyOffset[v] + liveCount[v];
+    std::vector<int> adjacency(indices.size());
+    {
+        std::vector<size_t> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+        for (size_t i = 0; i < indices.size(); ++i) adjacency[fill[indices[i]]++] = (int)(i / 3);
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> score(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) score[v] = vertexScore(tables, -1, liveCount[v]);
+
+    std::vector<float> triangleScore(triangleCount);
+    std::vector<bool> emitted(triangleCount, false);
+    int bestTriangle = -1;
+    float bestScore = -1.0f;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        triangleScore[t] = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+        if (triangleScore[t] > bestScore) { bestScore = triangleScore[t]; bestTriangle = (int)t; }
+    }
+
+    std::vector<GLuint> output;
+    output.reserve(indices.size());
+    std::vector<GLuint> cache, newCache;
+    cache.reserve(kVertexCacheSize + 3);
+    newCache.reserve(kVertexCacheSize + 3);
+    size_t scanCursor = 0;
+
+    for (size_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount) {
+        if (bestTriangle < 0) {
+            // Żaden trójkąt z cache nie jest dostępny - bierzemy pierwszy niewyemitowany (kursor rośnie monotonicznie)
+            while (emitted[scanCursor]) ++scanCursor;
+            bestTriangle = (int)scanCursor;
+        }
+        const GLuint* tri = &indices[(size_t)bestTriangle * 3];
+        output.push_back(tri[0]); output.push_back(tri[1]); output.push_back(tri[2]);
+        emitted[bestTriangle] = true;
+
+        // Usuń trójkąt z list wierzchołków
+        for (int k = 0; k < 3; ++k) {
+            GLuint v = tri[k];
+            int* list = &adjacency[adjacencyOffset[v]];
+            int last = --liveCount[v];
+            for (int i = 0; i <= last; ++i) {
+                if (list[i] == bestTriangle) { std::swap(list[i], list[last]); break; }
+            }
+        }
+
+        // Nowy stan cache: wierzchołki trójkąta na początku, reszta przesunięta (LRU)
+        newCache.clear();
+        newCache.push_back(tri[0]); newCache.push_back(tri[1]); newCache.push_back(tri[2]);
+        for (GLuint v : cache) {
+            if (v != tri[0] && v != tri[1] && v != tri[2]) newCache.push_back(v);
+        }
+
+        // Przelicz oceny wierzchołków (także wypchniętych poza cache) i zaktualizuj oceny ich trójkątów
+        for (size_t i = 0; i < newCache.size(); ++i) {
+            GLuint v = newCache[i];
+            cachePosition[v] = i < (size_t)kVertexCacheSize ? (int)i : -1;
+            float newScore = vertexScore(tables, cachePosition[v], liveCount[v]);
+            float delta = newScore - score[v];
+            score[v] = newScore;
+            const int* list = &adjacency[adjacencyOffset[v]];
+            for (int j = 0; j < liveCount[v]; ++j) triangleScore[list[j]] += delta;
+        }
+        if (newCache.size() > (size_t)kVertexCacheSize) newCache.resize(kVertexCacheSize);
+        cache.swap(newCache);
+
+        // Najlepszy kandydat spośród trójkątów wierzchołków w cache
+        bestTriangle = -1;
+        bestScore = -1.0f;
+        for (GLuint v : cache) {
+            const int* list = &adjacency[adjacencyOffset[v]];
+            for (int j = 0; j < liveCount[v]; ++j) {
+                if (triangleScore[list[j]] > bestScore) { bestScore = triangleScore[list[j]]; bestTriangle = list[j]; }
+            }
+        }
+    }
+    indices.swap(output);
+}
+
+size_t optimizeVertexFetch(std::vector<GLuint>& indices, void* vertices, size_t vertexCount, size_t vertexSize)
+{
+    const GLuint unassigned = 0xFFFFFFFFu;
+    std::vector<GLuint> remap(vertexCount, unassigned);
+    GLuint nextVertex = 0;
+    for (GLuint& index : indices) {
+        if (remap[index] == unassigned) remap[index] = nextVertex++;
+        index = remap[index];
+    }
+
+    unsigned char* bytes = static_cast<unsigned char*>(vertices);
+    std::vector<unsigned char> reordered((size_t)nextVertex * vertexSize);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        if (remap[v] != unassigned) std::memcpy(&reordered[remap[v] * vertexSize], bytes + v * vertexSize, vertexSize);
+    }
+    std::memcpy(bytes, reordered.data(), reordered.size());
+    return nextVertex;
+}
+
+IndexData makeIndexData(const std::vector<GLuint>& indices, size_t vertexCount)
+{
+    IndexData data;
+    data.count = (GLsizei)indices.size();
+    if (vertexCount <= 65536) {
+        data.type = GL_UNSIGNED_SHORT;
+        data.indices16.resize(indices.size());
+        for (size_t i = 0; i < indices.size(); ++i) data.indices16[i] = (GLushort)indices[i];
+    }
+    else {
+        data.type = GL_UNSIGNED_INT;
+        data.indices32 = indices;
+    }
+    return data;
+}
+
+IndexData optimizeMesh(const char* name, std::vector<GLuint>& indices, GLfloat* vertices, size_t& vertexCount, int strideFloats)
+{
+    float acmrBefore = computeACMR(indices, vertexCount);
+    optimizeVertexCache(indices, vertexCount);
+    vertexCount = optimizeVertexFetch(indices, vertices, vertexCount, strideFloats * sizeof(GLfloat));
+    float acmrAfter = computeACMR(indices, vertexCount);
+    IndexData data = makeIndexData(indices, vertexCount);
+    std::cout << "Siatka " << name << ": ACMR " << acmrBefore << " -> " << acmrAfter
+              << " (cache " << kVertexCacheSize << "), indeksy " << (data.type == GL_UNSIGNED_SHORT ? 16 : 32) << "-bitowe" << std::endl;
+    return data;
+}
@@ -0,0 +1,44 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <glad/glad.h>
+#include <vector>
+#include <cstddef>
+
+// Optymalizacja siatek indeksowanych pod cache wierzchołków po transformacji (post-transform cache).
+
+// Rozmiar symulowanej pamięci podręcznej (FIFO) - typowy rząd wielkości dla współczesnych GPU
+const int kVertexCacheSize = 32;
+
+// ACMR = chybienia cache / liczba trójkątów (1 wywołanie vertex shadera na chybienie).
+// Dla siatki regularnej optimum to ~0.5, kolejność wierszowa daje ~1 dla szerokich siatek.
+float computeACMR(const std::vector<GLuint>& indices, size_t vertexCount, int cacheSize = kVertexCacheSize);
+
+// Przestawia trójkąty algorytmem Forsytha (linear-speed vertex cache optimisation):
+// zachłannie emituje trójkąt o najwyższej sumie ocen wierzchołków (pozycja w cache + liczba pozostałych trójkątów).
+void optimizeVertexCache(std::vector<GLuint>& indices, size_t vertexCount);
+
+// Porządkuje wierzchołki w kolejności pierwszego użycia przez indeksy (sekwencyjny odczyt VBO),
+// przepisuje indeksy i usuwa wierzchołki nieużywane. vertices: vertexCount elementów po vertexSize bajtów.
+// Zwraca nową liczbę wierzchołków.
+size_t optimizeVertexFetch(std::vector<GLuint>& indices, void* vertices, size_t vertexCount, size_t vertexSize);
+
+// Bufor indeksów w najmniejszym wystarczającym typie (GL_UNSIGNED_SHORT, gdy vertexCount <= 65536)
+struct IndexData
+{
+    std::vector<GLushort> indices16;
+    std::vector<GLuint> indices32;
+    GLenum type;
+    GLsizei count;
+
+    const void* Data() const { return type == GL_UNSIGNED_SHORT ? (const void*)indices16.data() : (const void*)indices32.data(); }
+    GLsizeiptr Bytes() const { return (GLsizeiptr)count * (type == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint)); }
+};
+
+IndexData makeIndexData(const std::vector<GLuint>& indices, size_t vertexCount);
+
+// Pełny potok dla siatki z wierzchołkami po strideFloats floatów: kolejność trójkątów, kolejność wierzchołków,
+// wybór typu indeksów. Wypisuje ACMR przed i po; vertexCount jest aktualizowany (usunięte nieużywane wierzchołki).
+IndexData optimizeMesh(const char* name, std::vector<GLuint>& indices, GLfloat* vertices, size_t& vertexCount, int strideFloats);
+
+#endif
@@ -0,0 +1,283 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+namespace
+{
+    void writeJsonString(std::ostream& out, const std::string& text)
+    {
+        out << '"';
+        for (char c : text) {
+            if (c == '"' || c == '\\') out << '\\';
+            out << c;
+        }
+        out << '"';
+    }
+
+    void printStats(std::ostream& out, const Profiler::Stats& stats)
+    {
+        if (stats.samples == 0) {
+            out << std::setw(26) << "-";
+            return;
+        }
+        out << std::setw(8) << stats.min << std::setw(9) << stats.avg << std::setw(9) << stats.p99;
+    }
+}
+
+void Profiler::History::Add(double value)
+{
+    if (samples.size() < (size_t)kStatsWindow) {
+        samples.push_back(value);
+        return;
+    }
+    samples[next] = value;
+    next = (next + 1) % samples.size();
+}
+
+Profiler::Stats Profiler::History::Compute() const
+{
+    Stats stats;
+    if (samples.empty()) return stats;
+    std::vector<double> sorted(samples);
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0.0;
+    for (double value : sorted) sum += value;
+    stats.samples = (int)sorted.size();
+    stats.min = sorted.front();
+    stats.avg = sum / sorted.size();
+    // p99 jako ranga najbliższa: najmniejsza wartość, od której nie większe jest 99% próbek
+    const size_t rank = (size_t)std::ceil(0.99 * sorted.size());
+    stats.p99 = sorted[std::max<size_t>(rank, 1) - 1];
+    return stats;
+}
+
+Profiler::Profiler()
+    : origin(Clock::now()), gpuQueryActive(false), frameNumber(0), resolvedFrames(0), droppedFrames(0)
+{
+}
+
+double Profiler::Now() const
+{
+    return std::chrono::duration<double, std::micro>(Clock::now() - origin).count();
+}
+
+int Profiler::PassIndex(const char* name)
+{
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (std::strcmp(names[i].c_str(), name) == 0) return (int)i;
+    }
+    names.push_back(name);
+    cpuHistory.push_back(History());
+    gpuHistory.push_back(History());
+    return (int)names.size() - 1;
+}
+
+int Profiler::FindPass(const std::string& name) const
+{
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (names[i] == name) return (int)i;
+    }
+    return -1;
+}
+
+void Profiler::BeginFrame()
+{
+    FrameSlot& slot = slots[frameNumber % kFrameLatency];
+    if (slot.pending) Resolve(slot, false);
+    slot.frame = frameNumber;
+    slot.records.clear();
+    slot.usedQueries = 0;
+    slot.frameStart = Now();
+    openRecords.clear();
+}
+
+void Profiler::EndFrame()
+{
+    while (!openRecords.empty()) End(); // niezamknięte przebiegi kończą się z klatką
+    FrameSlot& slot = slots[frameNumber % kFrameLatency];
+    slot.frameDuration = Now() - slot.frameStart;
+    slot.pending = true;
+    ++frameNumber;
+}
+
+void Profiler::Begin(const char* name)
+{
+    FrameSlot& slot = slots[frameNumber % kFrameLatency];
+    PassRecord record;
+    record.pass = PassIndex(name);
+    record.depth = (int)openRecords.size();
+    record.query = -1;
+    record.cpuDuration = 0.0;
+    if (!gpuQueryActive) {
+        if (slot.usedQueries == (int)slot.queries.size()) {
+            GLuint query = 0;
+            glGenQueries(1, &query);
+            slot.queries.push_back(query);
+        }
+        record.query = slot.usedQueries++;
+        glBeginQuery(GL_TIME_ELAPSED, slot.queries[record.query]);
+        gpuQueryActive = true;
+    }
+    record.cpuStart = Now(); // po glBeginQuery - koszt zapytania nie wchodzi w czas przebiegu
+    openRecords.push_back((int)slot.records.size());
+    slot.records.push_back(record);
+}
+
+void Profiler::End()
+{
+    if (openRecords.empty()) return;
+    FrameSlot& slot = slots[frameNumber % kFrameLatency];
+    PassRecord& record = slot.records[openRecords.back()];
+    openRecords.pop_back();
+    record.cpuDuration = Now() - record.cpuStart;
+    if (record.query >= 0) {
+        glEndQuery(GL_TIME_ELAPSED);
+        gpuQueryActive = false;
+    }
+}
+
+void Profiler::Resolve(FrameSlot& slot, bool wait)
+{
+    slot.pending = false;
+    // Zapytania kończą się w kolejności zgłoszenia - wystarczy sprawdzić ostatnie (wait: GL_QUERY_RESULT czeka sam)
+    bool gpuAvailable = true;
+    if (slot.usedQueries > 0 && !wait) {
+        GLint available = 0;
+        glGetQueryObjectiv(slot.queries[slot.usedQueries - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+        gpuAvailable = available != 0;
+    }
+    if (!gpuAvailable) ++droppedFrames; // GPU ponad kFrameLatency klatek z tyłu - czasy CPU zostają, GPU przepada
+    else ++resolvedFrames;
+
+    frameHistory.Add(slot.frameDuration / 1000.0);
+    if (trace.size() < kMaxTraceEvents) {
+        TraceEvent frameEvent = { slot.frame, -1, 0, slot.frameStart, slot.frameDuration, -1.0 };
+        trace.push_back(frameEvent);
+    }
+    for (const PassRecord& record : slot.records) {
+        cpuHistory[record.pass].Add(record.cpuDuration / 1000.0);
+        double gpuDuration = -1.0;
+        if (record.query >= 0 && gpuAvailable) {
+            GLuint64 elapsed = 0;
+            glGetQueryObjectui64v(slot.queries[record.query], GL_QUERY_RESULT, &elapsed);
+            gpuDuration = elapsed / 1000.0; // ns -> us
+            gpuHistory[record.pass].Add(gpuDuration / 1000.0);
+        }
+        if (trace.size() < kMaxTraceEvents) {
+            TraceEvent event = { slot.frame, record.pass, record.depth + 1, record.cpuStart, record.cpuDuration, gpuDuration };
+            trace.push_back(event);
+        }
+    }
+}
+
+void Profiler::Flush()
+{
+    // Od najstarszej klatki - kolejność zdarzeń w eksporcie zostaje chronologiczna
+    for (int age = kFrameLatency; age >= 1; --age) {
+        if (frameNumber < (unsigned long long)age) continue;
+        FrameSlot& slot = slots[(frameNumber - age) % kFrameLatency];
+        if (slot.pending) Resolve(slot, true);
+    }
+}
+
+void Profiler::ResetStats()
+{
+    for (History& history : cpuHistory) history = History();
+    for (History& history : gpuHistory) history = History();
+    frameHistory = History();
+}
+
+Profiler::Stats Profiler::CpuStats(const std::string& pass) const
+{
+    const int index = FindPass(pass);
+    return index < 0 ? Stats() : cpuHistory[index].Compute();
+}
+
+Profiler::Stats Profiler::GpuStats(const std::string& pass) const
+{
+    const int index = FindPass(pass);
+    return index < 0 ? Stats() : gpuHistory[index].Compute();
+}
+
+Profiler::Stats Profiler::FrameStats() const
+{
+    return frameHistory.Compute();
+}
+
+void Profiler::PrintSummary(std::ostream& out) const
+{
+    const std::ios::fmtflags flags = out.flags();
+    const std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(3);
+    out << "Profiler: " << resolvedFrames << " klatek z czasami GPU, " << droppedFrames << " bez (okno statystyk: " << kStatsWindow << " klatek)" << std::endl;
+    out << std::left << std::setw(14) << "przebieg" << std::right << std::setw(26) << "CPU ms min/sr/p99" << std::setw(26) << "GPU ms min/sr/p99" << std::endl;
+    out << std::left << std::setw(14) << "klatka" << std::right;
+    printStats(out, frameHistory.Compute());
+    out << std::endl;
+    for (size_t i = 0; i < names.size(); ++i) {
+        out << std::left << std::setw(14) << names[i] << std::right;
+        printStats(out, cpuHistory[i].Compute());
+        printStats(out, gpuHistory[i].Compute());
+        out << std::endl;
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
+
+bool Profiler::WriteCsv(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) return false;
+    file << "frame,pass,depth,cpu_start_us,cpu_ms,gpu_ms\n";
+    file << std::fixed << std::setprecision(4);
+    for (const TraceEvent& event : trace) {
+        file << event.frame << ',' << (event.pass < 0 ? "frame" : names[event.pass]) << ',' << event.depth << ','
+             << event.cpuStart << ',' << event.cpuDuration / 1000.0 << ',';
+        if (event.gpuDuration >= 0.0) file << event.gpuDuration / 1000.0;
+        file << '\n';
+    }
+    return (bool)file;
+}
+
+bool Profiler::WriteChromeTrace(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) return false;
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}},\n";
+    file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}";
+    double gpuCursor = 0.0; // GPU wykonuje przebiegi po kolei - kolejny nie zaczyna się przed końcem poprzedniego
+    for (const TraceEvent& event : trace) {
+        const std::string name = event.pass < 0 ? "frame" : names[event.pass];
+        file << ",\n{\"name\":";
+        writeJsonString(file, name);
+        file << ",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" << event.cpuStart << ",\"dur\":" << event.cpuDuration
+             << ",\"args\":{\"frame\":" << event.frame << "}}";
+        if (event.gpuDuration >= 0.0) {
+            const double start = std::max(event.cpuStart, gpuCursor);
+            gpuCursor = start + event.gpuDuration;
+            file << ",\n{\"name\":";
+            writeJsonString(file, name);
+            file << ",\"cat\":\"gpu\",\"ph\":\"X\",\"pid\":1,\"tid\":2,\"ts\":" << start << ",\"dur\":" << event.gpuDuration
+                 << ",\"args\":{\"frame\":" << event.frame << "}}";
+        }
+    }
+    file << "\n]}\n";
+    return (bool)file;
+}
+
+void Profiler::Delete()
+{
+    if (gpuQueryActive) glEndQuery(GL_TIME_ELAPSED);
+    gpuQueryActive = false;
+    for (FrameSlot& slot : slots) {
+        if (!slot.queries.empty()) glDeleteQueries((GLsizei)slot.queries.size(), slot.queries.data());
+        slot.queries.clear();
+        slot.usedQueries = 0;
+        slot.pending = false;
+    }
+}
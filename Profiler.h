@@ -0,0 +1,136 @@
+#ifndef PROFILER_CLASS_H
+#define PROFILER_CLASS_H
+
+#include <glad/glad.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <ostream>
+
+// Profiler klatki: czas CPU nazwanych przebiegów (zagnieżdżanych) i czas GPU przebiegów najwyższego poziomu
+// (zapytania GL_TIME_ELAPSED - jedno aktywne naraz, więc przebiegi zagnieżdżone mierzą tylko CPU).
+//  - zapytania klatki trafiają do pierścienia kFrameLatency slotów; wyniki czytane są, gdy slot wraca do użycia
+//    (kFrameLatency - 1 klatek później), i tylko jeśli są już dostępne - brak wyniku porzuca klatkę zamiast czekać na GPU,
+//  - statystyki min/średnia/p99 z ostatnich kStatsWindow klatek każdego przebiegu,
+//  - zdarzenia (do kMaxTraceEvents) eksportowane do CSV i do formatu trace-event Chrome (chrome://tracing, Perfetto).
+// Wszystkie metody wołać na wątku z kontekstem GL, między BeginFrame a EndFrame.
+class Profiler
+{
+public:
+    static const int kFrameLatency = 4;
+    static const int kStatsWindow = 240;
+    static const size_t kMaxTraceEvents = 1 << 18;
+
+    struct Stats
+    {
+        double min = 0.0;  // milisekundy
+        double avg = 0.0;
+        double p99 = 0.0;
+        int samples = 0;
+    };
+
+    Profiler();
+
+    void BeginFrame();
+    void EndFrame();
+
+    // Przebieg o danej nazwie (literał - nazwa porównywana przy każdym wywołaniu); End zamyka ostatnio otwarty
+    void Begin(const char* name);
+    void End();
+
+    // Zakres CPU/GPU zamykany w destruktorze
+    class Scope
+    {
+    public:
+        Scope(Profiler& profiler, const char* name) : profiler(profiler) { profiler.Begin(name); }
+        ~Scope() { profiler.End(); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        Profiler& profiler;
+    };
+
+    Stats CpuStats(const std::string& pass) const;
+    Stats GpuStats(const std::string& pass) const;  // samples == 0, gdy przebieg nie ma pomiaru GPU
+    Stats FrameStats() const;                        // czas CPU całej klatki
+    const std::vector<std::string>& PassNames() const { return names; }
+
+    // Odczytuje wyniki wszystkich zakończonych klatek, czekając na GPU - tylko poza mierzonymi klatkami
+    void Flush();
+    // Czyści okna statystyk (zdarzenia do eksportu zostają) - np. między pomiarami różnych ujęć
+    void ResetStats();
+
+    // Tabela przebiegów (CPU i GPU: min/śr/p99)
+    void PrintSummary(std::ostream& out) const;
+    // Jeden wiersz na zdarzenie: frame,pass,depth,cpu_start_us,cpu_ms,gpu_ms (gpu_ms puste bez pomiaru)
+    bool WriteCsv(const std::string& path) const;
+    // Zdarzenia "X" na dwóch ścieżkach: CPU i GPU. GL_TIME_ELAPSED daje tylko czas trwania, więc przebieg GPU
+    // umieszczany jest w chwili zgłoszenia na CPU (albo po końcu poprzedniego przebiegu GPU tej klatki)
+    bool WriteChromeTrace(const std::string& path) const;
+
+    unsigned long long ResolvedFrames() const { return resolvedFrames; }
+    unsigned long long DroppedFrames() const { return droppedFrames; }
+
+    void Delete();
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct PassRecord
+    {
+        int pass;
+        int depth;
+        double cpuStart;   // mikrosekundy od startu profilera
+        double cpuDuration;
+        int query;         // indeks w FrameSlot::queries albo -1
+    };
+
+    struct FrameSlot
+    {
+        unsigned long long frame = 0;
+        bool pending = false;
+        double frameStart = 0.0;
+        double frameDuration = 0.0;
+        std::vector<PassRecord> records;
+        std::vector<GLuint> queries;  // obiekty zapytań tego slotu, używane ponownie co kFrameLatency klatek
+        int usedQueries = 0;
+    };
+
+    struct History
+    {
+        std::vector<double> samples;  // pierścień kStatsWindow wartości (ms)
+        size_t next = 0;
+        void Add(double value);
+        Stats Compute() const;
+    };
+
+    struct TraceEvent
+    {
+        unsigned long long frame;
+        int pass;
+        int depth;
+        double cpuStart;
+        double cpuDuration;
+        double gpuDuration;  // < 0 - brak pomiaru GPU
+    };
+
+    Clock::time_point origin;
+    std::vector<std::string> names;
+    std::vector<History> cpuHistory;
+    std::vector<History> gpuHistory;
+    History frameHistory;
+    FrameSlot slots[kFrameLatency];
+    std::vector<int> openRecords;  // indeksy rekordów bieżącego slotu
+    bool gpuQueryActive;
+    unsigned long long frameNumber;
+    unsigned long long resolvedFrames;
+    unsigned long long droppedFrames;
+    std::vector<TraceEvent> trace;
+
+    double Now() const;
+    int PassIndex(const char* name);
+    int FindPass(const std::string& name) const;
+    void Resolve(FrameSlot& slot, bool wait);
+};
+
+#endif
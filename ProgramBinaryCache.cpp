@@ -0,0 +1,157 @@
+#include "ProgramBinaryCache.h"
+#include "FileUtils.h"
+#include "GLExtensions.h"
+#include "MappedFile.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    // Zmiana nagłówka wymaga podbicia wersji - stare pliki zostaną odrzucone
+    const uint32_t kProgramCacheVersion = 1;
+    const char kProgramCacheMagic[4] = { 'G', 'K', 'P', 'B' };
+
+    // Długość przed napisem - "ab"+"c" i "a"+"bc" dają różne klucze
+    uint64_t fnv1aString(uint64_t hash, const char* text)
+    {
+        const uint64_t length = text ? std::strlen(text) : 0;
+        hash = fnv1a(hash, &length, sizeof(length));
+        return fnv1a(hash, text, (size_t)length);
+    }
+
+    struct ProgramCacheHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint64_t key;
+        uint32_t binaryFormat;
+        uint32_t binaryLength;
+        uint64_t binaryChecksum;
+    };
+}
+
+ProgramBinaryCache::ProgramBinaryCache(const std::string& cacheDirectory)
+    : directory(cacheDirectory), available(false), driverHash(kFnvOffset), hits(0), misses(0)
+{
+    if (!glExtensions.programBinary) return;
+    if (!makeDirectory(directory)) {
+        std::cerr << "ProgramBinaryCache: nie można utworzyć katalogu " << directory << " - programy będą kompilowane przy każdym starcie" << std::endl;
+        return;
+    }
+
+    driverHash = fnv1a(driverHash, &kProgramCacheVersion, sizeof(kProgramCacheVersion));
+    driverHash = fnv1aString(driverHash, reinterpret_cast<const char*>(glGetString(GL_VENDOR)));
+    driverHash = fnv1aString(driverHash, reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+    driverHash = fnv1aString(driverHash, reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+    GLint formatCount = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    std::vector<GLint> formats(formatCount > 0 ? formatCount : 0);
+    if (!formats.empty()) glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, formats.data());
+    driverHash = fnv1a(driverHash, formats.data(), formats.size() * sizeof(GLint));
+    available = true;
+}
+
+uint64_t ProgramBinaryCache::MakeKey(const std::string& vertexSource, const std::string& fragmentSource) const
+{
+    uint64_t hash = driverHash;
+    hash = fnv1aString(hash, vertexSource.c_str());
+    hash = fnv1aString(hash, fragmentSource.c_str());
+    return hash;
+}
+
+std::string ProgramBinaryCache::PathFor(uint64_t key) const
+{
+    char hex[17];
+    for (int i = 0; i < 16; ++i) {
+        hex[i] = "0123456789abcdef"[(key >> (60 - i * 4)) & 0xF];
+    }
+    hex[16] = '\0';
+    return directory + "/program_" + hex + ".bin";
+}
+
+bool ProgramBinaryCache::Load(uint64_t key, GLuint program)
+{
+    if (!available) return false;
+
+    std::string path = PathFor(key);
+    MappedFile file;
+    if (!file.Open(path)) {
+        ++misses;
+        return false;
+    }
+
+    ProgramCacheHeader header;
+    bool valid = file.Size() >= sizeof(header);
+    if (valid) {
+        std::memcpy(&header, file.Data(), sizeof(header));
+        valid = std::memcmp(header.magic, kProgramCacheMagic, sizeof(kProgramCacheMagic)) == 0
+            && header.version == kProgramCacheVersion
+            && header.key == key
+            && header.binaryLength > 0
+            && sizeof(header) + (uint64_t)header.binaryLength == file.Size()
+            && fnv1a(kFnvOffset, file.Data() + sizeof(header), header.binaryLength) == header.binaryChecksum;
+    }
+    GLint linked = GL_FALSE;
+    if (valid) {
+        glExtensions.ProgramBinary(program, (GLenum)header.binaryFormat, file.Data() + sizeof(header), (GLsizei)header.binaryLength);
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    }
+    file.Close();
+
+    if (linked == GL_FALSE) {
+        // Uszkodzony plik albo sterownik nie przyjął binarium (np. po aktualizacji z tym samym napisem wersji)
+        std::remove(path.c_str());
+        std::cout << "ProgramBinaryCache: odrzucono " << path << " - kompilacja ze źródeł" << std::endl;
+        ++misses;
+        return false;
+    }
+    ++hits;
+    return true;
+}
+
+bool ProgramBinaryCache::Store(uint64_t key, GLuint program)
+{
+    if (!available) return false;
+
+    GLint binaryLength = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+    if (binaryLength <= 0) return false;
+    std::vector<char> binary((size_t)binaryLength);
+    GLsizei written = 0;
+    GLenum binaryFormat = 0;
+    glExtensions.GetProgramBinary(program, binaryLength, &written, &binaryFormat, binary.data());
+    if (written <= 0) return false;
+
+    ProgramCacheHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kProgramCacheMagic, sizeof(kProgramCacheMagic));
+    header.version = kProgramCacheVersion;
+    header.key = key;
+    header.binaryFormat = binaryFormat;
+    header.binaryLength = (uint32_t)written;
+    header.binaryChecksum = fnv1a(kFnvOffset, binary.data(), (size_t)written);
+
+    // Zapis do pliku tymczasowego i podmiana - jak w MeshCache
+    std::string path = PathFor(key);
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file) return false;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(binary.data(), written);
+        if (!file) {
+            file.close();
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+    std::remove(path.c_str());
+    if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
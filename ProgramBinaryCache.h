@@ -0,0 +1,41 @@
+#ifndef PROGRAM_BINARY_CACHE_CLASS_H
+#define PROGRAM_BINARY_CACHE_CLASS_H
+
+#include <glad/glad.h>
+#include <string>
+#include <cstdint>
+
+// Dyskowa pamięć podręczna zlinkowanych programów (glGetProgramBinary / glProgramBinary).
+// Klucz: FNV-1a ze źródeł shaderów, napisów GL_VENDOR / GL_RENDERER / GL_VERSION i listy formatów binarnych
+// sterownika - nowy sterownik albo zmieniony plik .vert/.frag daje nowy klucz.
+// Plik: nagłówek (magia, wersja, klucz, format binarny, długość, suma kontrolna) + binarium.
+// Binarium odrzucone przez sterownik (status linkowania GL_FALSE) jest usuwane - Shader kompiluje wtedy ze źródeł.
+class ProgramBinaryCache
+{
+public:
+    explicit ProgramBinaryCache(const std::string& cacheDirectory);
+
+    // false, gdy kontekst nie obsługuje binariów programów (wtedy Load/Store nic nie robią)
+    bool IsAvailable() const { return available; }
+
+    uint64_t MakeKey(const std::string& vertexSource, const std::string& fragmentSource) const;
+    // Wczytuje binarium do istniejącego programu; true, gdy program jest zlinkowany i gotowy
+    bool Load(uint64_t key, GLuint program);
+    // Zapisuje binarium zlinkowanego programu (utworzonego z GL_PROGRAM_BINARY_RETRIEVABLE_HINT)
+    bool Store(uint64_t key, GLuint program);
+
+    // Statystyki do logu przy zamknięciu
+    int Hits() const { return hits; }
+    int Misses() const { return misses; }
+
+private:
+    std::string directory;
+    bool available;
+    uint64_t driverHash;   // vendor/renderer/version + formaty binarne
+    int hits;
+    int misses;
+
+    std::string PathFor(uint64_t key) const;
+};
+
+#endif
@@ -0,0 +1,286 @@
+#include "RegressionGate.h"
+#include "FileUtils.h"
+#include "ImageCompare.h"
+#include "Profiler.h"
+#include "RenderTarget.h"
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+    const char* kFramePass = "klatka";
+
+    // Czas porównywany dla przebiegu: GPU, gdy obie strony go mają (CPU przebiegu to głównie zgłaszanie poleceń)
+    bool comparableTime(double baseCpu, double baseGpu, double cpu, double gpu, double& base, double& current)
+    {
+        const bool useGpu = baseGpu >= 0.0 && gpu >= 0.0;
+        base = useGpu ? baseGpu : baseCpu;
+        current = useGpu ? gpu : cpu;
+        return useGpu;
+    }
+}
+
+const double RegressionGate::kTimingNoiseFloor = 0.25;
+
+RegressionGate::RegressionGate(const BenchmarkSettings& settings)
+    : settings(settings), caseIndex(0), caseFrame(0)
+{
+}
+
+std::string RegressionGate::CaseName() const
+{
+    return Pose().name + "_mode" + std::to_string(LightingMode());
+}
+
+std::string RegressionGate::BaselinePath() const
+{
+    return settings.goldenDirectory + "/baseline.txt";
+}
+
+bool RegressionGate::Load(std::string& failure)
+{
+    if (!checkImageCompareThreshold(failure)) return false;
+    const std::string& path = settings.regressionPosesFile;
+    std::ifstream file(path);
+    if (!file) {
+        failure = "nie można otworzyć pliku " + path;
+        return false;
+    }
+    poses.clear();
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        const size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+        std::istringstream fields(line);
+        RegressionPose pose;
+        if (!(fields >> pose.name)) continue; // pusty wiersz albo sam komentarz
+        if (!(fields >> pose.time >> pose.position.x >> pose.position.y >> pose.position.z >> pose.target.x >> pose.target.y >> pose.target.z)) {
+            failure = path + ":" + std::to_string(lineNumber) + ": oczekiwano nazwy i 7 liczb (czas, pozycja, cel)";
+            return false;
+        }
+        if (glm::length(pose.target - pose.position) < 1e-5f) {
+            failure = path + ":" + std::to_string(lineNumber) + ": cel kamery w jej pozycji";
+            return false;
+        }
+        for (const RegressionPose& other : poses) {
+            if (other.name == pose.name) {
+                failure = path + ":" + std::to_string(lineNumber) + ": powtórzona nazwa ujęcia " + pose.name;
+                return false;
+            }
+        }
+        poses.push_back(pose);
+    }
+    if (poses.empty()) {
+        failure = path + ": brak ujęć";
+        return false;
+    }
+    return settings.updateGolden || LoadBaseline(failure);
+}
+
+bool RegressionGate::LoadBaseline(std::string& failure)
+{
+    baseline.clear();
+    std::ifstream file(BaselinePath());
+    if (!file) return true; // bez pliku czasy nie są sprawdzane - Finish o tym informuje
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        const size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+        std::istringstream fields(line);
+        std::string name;
+        PassTiming timing;
+        if (!(fields >> name)) continue;
+        if (!(fields >> timing.pass >> timing.cpu >> timing.gpu)) {
+            failure = BaselinePath() + ":" + std::to_string(lineNumber) + ": oczekiwano \"przypadek przebieg cpu_ms gpu_ms\"";
+            return false;
+        }
+        baseline[name].push_back(timing);
+    }
+    return true;
+}
+
+void RegressionGate::CompleteCase(RenderTarget& target, const Profiler& profiler)
+{
+    CaseResult result;
+    result.name = CaseName();
+
+    PassTiming frame;
+    frame.pass = kFramePass;
+    frame.cpu = recorder.FrameTime(0.5);
+    result.timings.push_back(frame);
+    for (const std::string& pass : profiler.PassNames()) {
+        PassTiming timing;
+        timing.pass = pass;
+        timing.cpu = profiler.CpuStats(pass).avg;
+        const Profiler::Stats gpu = profiler.GpuStats(pass);
+        if (gpu.samples > 0) timing.gpu = gpu.avg;
+        result.timings.push_back(timing);
+    }
+
+    CompareImage(result, target);
+    if (!settings.updateGolden) CompareTimings(result, std::cout);
+
+    const std::ios::fmtflags flags = std::cout.flags();
+    const std::streamsize precision = std::cout.precision();
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << (result.imagePassed && result.timingPassed ? "[ OK ] " : "[BŁĄD] ") << std::left << std::setw(20) << result.name << std::right
+              << " " << frame.cpu << " ms/klatkę";
+    if (!result.imageMessage.empty()) std::cout << " - " << result.imageMessage;
+    std::cout << std::endl;
+    std::cout.flags(flags);
+    std::cout.precision(precision);
+
+    results.push_back(result);
+    recorder = BenchmarkRecorder();
+}
+
+void RegressionGate::CompareImage(CaseResult& result, RenderTarget& target)
+{
+    std::vector<unsigned char> actual;
+    target.ReadPixels(actual);
+    const std::string goldenPath = settings.goldenDirectory + "/" + result.name + ".ppm";
+
+    if (settings.updateGolden) {
+        if (!makeDirectory(settings.goldenDirectory) || !writePPM(goldenPath, target.Width(), target.Height(), actual)) {
+            result.imagePassed = false;
+            result.imageMessage = "nie można zapisać " + goldenPath;
+        }
+        else {
+            result.imageMessage = "zapisano " + goldenPath;
+        }
+        return;
+    }
+
+    int width = 0;
+    int height = 0;
+    std::vector<unsigned char> expected;
+    std::string failure;
+    if (!readPPM(goldenPath, width, height, expected, failure)) {
+        result.imagePassed = false;
+        result.imageMessage = failure + " (obrazy wzorcowe tworzy --update-golden)";
+    }
+    else if (width != target.Width() || height != target.Height()) {
+        result.imagePassed = false;
+        result.imageMessage = "obraz wzorcowy " + std::to_string(width) + "x" + std::to_string(height) + ", render "
+                            + std::to_string(target.Width()) + "x" + std::to_string(target.Height());
+    }
+    else {
+        std::vector<unsigned char> diff;
+        const ImageDifference difference = compareImages(expected, actual, width, height, settings.pixelThreshold, diff);
+        if (difference.differentFraction <= settings.maxDifferentPixels) return;
+        result.imagePassed = false;
+        std::ostringstream message;
+        message << difference.differentPixels << " pikseli różni się (" << std::fixed << std::setprecision(3)
+                << difference.differentFraction * 100.0 << "%, dopuszczalne " << settings.maxDifferentPixels * 100.0
+                << "%, największa różnica " << difference.maxDelta << ")";
+        result.imageMessage = message.str();
+        const std::string diffPath = settings.diffDirectory + "/" + result.name + "_diff.ppm";
+        if (!makeDirectory(settings.diffDirectory) || !writePPM(diffPath, width, height, diff)) {
+            result.imageMessage += "; nie można zapisać " + diffPath;
+            return;
+        }
+    }
+    const std::string actualPath = settings.diffDirectory + "/" + result.name + "_actual.ppm";
+    if (!makeDirectory(settings.diffDirectory) || !writePPM(actualPath, target.Width(), target.Height(), actual)) {
+        result.imageMessage += "; nie można zapisać " + actualPath;
+        return;
+    }
+    result.imagesSaved = true;
+}
+
+void RegressionGate::CompareTimings(CaseResult& result, std::ostream& out) const
+{
+    const auto entry = baseline.find(result.name);
+    if (entry == baseline.end()) return; // brak czasu bazowego - Finish liczy takie przypadki
+
+    auto findBase = [&](const std::string& pass) -> const PassTiming* {
+        for (const PassTiming& timing : entry->second) {
+            if (timing.pass == pass) return &timing;
+        }
+        return nullptr;
+    };
+    auto isSlower = [&](double base, double current) {
+        return current > base * settings.maxSlowdown && current - base > kTimingNoiseFloor;
+    };
+
+    const PassTiming* baseFrame = findBase(kFramePass);
+    if (!baseFrame || !isSlower(baseFrame->cpu, result.timings.front().cpu)) return;
+    result.timingPassed = false;
+
+    const std::ios::fmtflags flags = out.flags();
+    const std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(3);
+    out << result.name << ": klatka wolniejsza niż bazowa ponad " << settings.maxSlowdown << "x" << std::endl;
+    out << "  " << std::left << std::setw(14) << "przebieg" << std::right << std::setw(10) << "bazowy ms" << std::setw(10) << "teraz ms"
+        << std::setw(8) << "x" << std::endl;
+    for (const PassTiming& timing : result.timings) {
+        const PassTiming* base = findBase(timing.pass);
+        out << "  " << std::left << std::setw(14) << timing.pass << std::right;
+        if (!base) {
+            out << std::setw(10) << "-" << std::setw(10) << timing.cpu << std::endl;
+            continue;
+        }
+        double baseTime = 0.0;
+        double currentTime = 0.0;
+        const bool gpu = comparableTime(base->cpu, base->gpu, timing.cpu, timing.gpu, baseTime, currentTime);
+        out << std::setw(10) << baseTime << std::setw(10) << currentTime << std::setw(8)
+            << (baseTime > 0.0 ? currentTime / baseTime : 0.0) << (gpu ? " GPU" : " CPU")
+            << (isSlower(baseTime, currentTime) ? "  <--" : "") << std::endl;
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
+
+void RegressionGate::Advance()
+{
+    if (Done()) return;
+    if (++caseFrame < settings.warmupFrames + settings.frames) return;
+    caseFrame = 0;
+    ++caseIndex;
+}
+
+bool RegressionGate::Finish(std::ostream& out)
+{
+    int imageFailures = 0;
+    int timingFailures = 0;
+    int withoutBaseline = 0;
+    int savedImages = 0;
+    for (const CaseResult& result : results) {
+        if (!result.imagePassed) ++imageFailures;
+        if (result.imagesSaved) ++savedImages;
+        if (!result.timingPassed) ++timingFailures;
+        if (!settings.updateGolden && baseline.find(result.name) == baseline.end()) ++withoutBaseline;
+    }
+
+    if (settings.updateGolden) {
+        std::ofstream file(BaselinePath(), std::ios::trunc);
+        if (file) {
+            file << "# przypadek przebieg cpu_ms gpu_ms (gpu_ms -1: brak pomiaru GPU); \"klatka\" - mediana czasu klatki\n";
+            file << std::fixed << std::setprecision(4);
+            for (const CaseResult& result : results) {
+                for (const PassTiming& timing : result.timings) {
+                    file << result.name << ' ' << timing.pass << ' ' << timing.cpu << ' ' << timing.gpu << '\n';
+                }
+            }
+        }
+        if (!file) {
+            out << "Nie udało się zapisać " << BaselinePath() << std::endl;
+            return false;
+        }
+        out << "Regresja: zapisano " << results.size() << " obrazów wzorcowych i czasy bazowe w " << settings.goldenDirectory << std::endl;
+        return imageFailures == 0;
+    }
+
+    out << "Regresja: " << results.size() << " przypadków, obraz różny w " << imageFailures << ", wolniej w " << timingFailures;
+    if (withoutBaseline > 0) out << ", bez czasu bazowego (nie sprawdzane): " << withoutBaseline;
+    out << std::endl;
+    if (savedImages > 0) out << "Obrazy renderu i różnic (" << savedImages << " przypadków) w katalogu " << settings.diffDirectory << std::endl;
+    if (savedImages < imageFailures) out << "Dla " << imageFailures - savedImages << " przypadków obrazów nie zapisano - patrz komunikaty wyżej" << std::endl;
+    return (int)results.size() == CaseCount() && imageFailures == 0 && timingFailures == 0;
+}
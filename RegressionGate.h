@@ -0,0 +1,95 @@
+#ifndef REGRESSION_GATE_CLASS_H
+#define REGRESSION_GATE_CLASS_H
+
+#include <glm/glm.hpp>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Benchmark.h"
+
+class Profiler;
+class RenderTarget;
+
+// Nieruchome ujęcie bramki regresji: nazwa, czas symulacji (położenie słońca) i kamera
+struct RegressionPose
+{
+    std::string name;
+    float time = 0.0f;
+    glm::vec3 position;
+    glm::vec3 target;
+};
+
+// Bramka regresji renderera, zbudowana na trybie benchmarku. Każde ujęcie z pliku rysowane jest w każdym
+// z kLightingModes trybów oświetlenia (przypadek "<ujęcie>_mode<k>"): warmupFrames klatek rozgrzewki,
+// potem frames mierzonych. Po ostatniej klatce przypadku:
+//  - obraz porównywany z <golden>/<przypadek>.ppm (compareImages); przy różnicy zapisywane są
+//    <diffDirectory>/<przypadek>_actual.ppm i <przypadek>_diff.ppm (nieudany zapis trafia do komunikatu przypadku),
+//  - mediana czasu klatki porównywana z <golden>/baseline.txt; spowolnienie ponad maxSlowdown
+//    (i ponad kTimingNoiseFloor ms) oblewa przypadek i wypisuje porównanie czasów przebiegów z profilera.
+// --update-golden zapisuje obrazy wzorcowe i czasy bazowe zamiast porównywać - katalog golden/ tworzy się tak
+// raz na maszynie wzorcowej i zatwierdza (patrz BenchmarkSettings).
+// Plik ujęć: wiersze "nazwa czas[s] pozycja x y z cel x y z", '#' zaczyna komentarz.
+class RegressionGate
+{
+public:
+    static const int kLightingModes = 4;
+    static const double kTimingNoiseFloor; // ms - różnice poniżej to szum pomiaru, nie regresja
+
+    explicit RegressionGate(const BenchmarkSettings& settings);
+
+    // Wczytuje ujęcia i (bez --update-golden) czasy bazowe; false i powód w failure
+    bool Load(std::string& failure);
+
+    int CaseCount() const { return (int)poses.size() * kLightingModes; }
+    bool Done() const { return caseIndex >= CaseCount(); }
+    const RegressionPose& Pose() const { return poses[caseIndex / kLightingModes]; }
+    int LightingMode() const { return caseIndex % kLightingModes; }
+    std::string CaseName() const;
+
+    bool IsFirstMeasuredFrame() const { return caseFrame == settings.warmupFrames; }
+    bool IsMeasuredFrame() const { return caseFrame >= settings.warmupFrames; }
+    bool IsLastFrame() const { return caseFrame + 1 == settings.warmupFrames + settings.frames; }
+    BenchmarkRecorder& Recorder() { return recorder; }
+
+    // Po ostatniej klatce przypadku, z profilerem po Flush: porównanie obrazu i czasów
+    void CompleteCase(RenderTarget& target, const Profiler& profiler);
+    // Następna klatka; po ostatniej przechodzi do kolejnego przypadku
+    void Advance();
+
+    // Podsumowanie (i zapis czasów bazowych przy --update-golden); true, gdy wszystkie przypadki przeszły
+    bool Finish(std::ostream& out);
+
+private:
+    struct PassTiming
+    {
+        std::string pass;   // "klatka" - mediana czasu całej klatki z BenchmarkRecorder
+        double cpu = 0.0;   // ms, średnia z profilera
+        double gpu = -1.0;  // ms; < 0 - brak pomiaru GPU
+    };
+
+    struct CaseResult
+    {
+        std::string name;
+        bool imagePassed = true;
+        bool timingPassed = true;
+        std::string imageMessage;
+        bool imagesSaved = false;   // obrazy renderu (i różnic) zapisane w diffDirectory
+        std::vector<PassTiming> timings;
+    };
+
+    BenchmarkSettings settings;
+    std::vector<RegressionPose> poses;
+    std::map<std::string, std::vector<PassTiming>> baseline;
+    std::vector<CaseResult> results;
+    BenchmarkRecorder recorder;
+    int caseIndex;
+    int caseFrame;
+
+    std::string BaselinePath() const;
+    bool LoadBaseline(std::string& failure);
+    void CompareImage(CaseResult& result, RenderTarget& target);
+    void CompareTimings(CaseResult& result, std::ostream& out) const;
+};
+
+#endif
@@ -0,0 +1,61 @@
+#include "RenderTarget.h"
+#include "GLState.h"
+#include <algorithm>
+
+RenderTarget::RenderTarget(int width, int height)
+    : ID(0), colorBuffer(0), depthBuffer(0), width(width), height(height), complete(false)
+{
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &ID);
+    glBindFramebuffer(GL_FRAMEBUFFER, ID);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+    complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void RenderTarget::Bind()
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, ID);
+    glViewport(0, 0, width, height);
+}
+
+void RenderTarget::Unbind()
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void RenderTarget::ReadPixels(std::vector<unsigned char>& rgb)
+{
+    const size_t rowBytes = (size_t)width * 3;
+    rgb.resize(rowBytes * height);
+    // Framebuffer do odczytu i wyrównanie wierszy tylko na czas odczytu - potem poprzednie wartości
+    GLint previousReadFramebuffer = 0;
+    GLint previousPackAlignment = 4;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousReadFramebuffer);
+    glGetIntegerv(GL_PACK_ALIGNMENT, &previousPackAlignment);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, ID);
+    GLState::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1); // wiersze RGB8 bez wyrównania do 4 B
+    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, rgb.data());
+    glPixelStorei(GL_PACK_ALIGNMENT, previousPackAlignment);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, (GLuint)previousReadFramebuffer);
+    for (int y = 0; y < height / 2; ++y) {
+        std::swap_ranges(rgb.begin() + y * rowBytes, rgb.begin() + (y + 1) * rowBytes, rgb.begin() + (height - 1 - y) * rowBytes);
+    }
+}
+
+void RenderTarget::Delete()
+{
+    if (ID) glDeleteFramebuffers(1, &ID);
+    if (colorBuffer) glDeleteRenderbuffers(1, &colorBuffer);
+    if (depthBuffer) glDeleteRenderbuffers(1, &depthBuffer);
+    ID = colorBuffer = depthBuffer = 0;
+}
@@ -0,0 +1,37 @@
+#ifndef RENDER_TARGET_CLASS_H
+#define RENDER_TARGET_CLASS_H
+
+#include <glad/glad.h>
+#include <vector>
+
+// Framebuffer poza ekranem (kolor RGBA8 + głębia/stencil w renderbufferach) - tryb benchmarku rysuje do niego
+// zamiast do domyślnego framebuffera ukrytego okna, którego zawartość nie jest gwarantowana.
+class RenderTarget
+{
+public:
+    GLuint ID;
+
+    RenderTarget(int width, int height);
+
+    // false, gdy framebuffer nie jest kompletny
+    bool IsComplete() const { return complete; }
+    int Width() const { return width; }
+    int Height() const { return height; }
+
+    // Binduje framebuffer i ustawia viewport na jego rozmiar
+    void Bind();
+    // Powrót do domyślnego framebuffera (viewport bez zmian)
+    static void Unbind();
+    // Kolor RGB8, wiersze od góry obrazu (glReadPixels czyta od dołu) - czeka na zakończenie rysowania
+    void ReadPixels(std::vector<unsigned char>& rgb);
+    void Delete();
+
+private:
+    GLuint colorBuffer;
+    GLuint depthBuffer;
+    int width;
+    int height;
+    bool complete;
+};
+
+#endif
@@ -0,0 +1,174 @@
+#include "ShaderBuilder.h"
+#include "GLState.h"
+#include "shaderClass.h"
+#include "GLExtensions.h"
+#include "ProgramBinaryCache.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+    template<class T>
+    bool isFutureReady(const std::future<T>& result)
+    {
+        return result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    // Tylko zgłoszenie kompilacji - status sprawdzany po linkowaniu, żeby nie czekać na sterownik
+    GLuint submitStage(GLenum type, const std::string& source)
+    {
+        const char* text = source.c_str();
+        GLuint shader = glCreateShader(type);
+        glShaderSource(shader, 1, &text, NULL);
+        glCompileShader(shader);
+        return shader;
+    }
+}
+
+ShaderBuilder::ShaderBuilder(ThreadPool& pool)
+    : pool(pool), failedCount(0)
+{
+}
+
+ShaderBuilder::~ShaderBuilder()
+{
+    // Bez wywołań GL - destruktor może działać po zniszczeniu kontekstu (obiekty GL i tak znikają razem z nim).
+    // Czekamy tylko na zadania czytające pliki, które trzymają ścieżki tego obiektu.
+    for (PendingProgram& build : pending) {
+        if (build.vertexSource.valid()) build.vertexSource.wait();
+        if (build.fragmentSource.valid()) build.fragmentSource.wait();
+    }
+}
+
+void ShaderBuilder::Submit(Shader* target, const char* vertexFile, const char* fragmentFile, const ShaderDefines& defines)
+{
+    PendingProgram build;
+    build.target = target;
+    build.vertexFile = vertexFile;
+    build.fragmentFile = fragmentFile;
+    std::string vertexPath = build.vertexFile;
+    std::string fragmentPath = build.fragmentFile;
+    // Definicje wariantu wstrzykiwane też na wątku puli
+    build.vertexSource = pool.Submit([vertexPath, defines]() { return get_file_contents(vertexPath.c_str(), defines); });
+    build.fragmentSource = pool.Submit([fragmentPath, defines]() { return get_file_contents(fragmentPath.c_str(), defines); });
+    build.vertexShader = 0;
+    build.fragmentShader = 0;
+    build.program = 0;
+    build.storeInCache = false;
+    build.cacheKey = 0;
+    build.state = Reading;
+    pending.push_back(std::move(build));
+}
+
+void ShaderBuilder::StartBuild(PendingProgram& build)
+{
+    std::string vertexCode;
+    std::string fragmentCode;
+    try {
+        vertexCode = build.vertexSource.get();
+        fragmentCode = build.fragmentSource.get();
+    }
+    catch (const std::runtime_error& e) {
+        std::cerr << "BŁĄD::SHADER: Nie udało się wczytać plików shadera " << build.vertexFile << " / " << build.fragmentFile
+                  << ": " << e.what() << std::endl;
+        build.state = Failed;
+        return;
+    }
+
+    ProgramBinaryCache* cache = Shader::programCache;
+    if (cache != nullptr && cache->IsAvailable()) {
+        build.cacheKey = cache->MakeKey(vertexCode, fragmentCode);
+        build.program = glCreateProgram();
+        if (cache->Load(build.cacheKey, build.program)) {
+            build.state = Linking; // gotowy - FinishBuild przy najbliższym sprawdzeniu
+            return;
+        }
+        GLState::DeleteProgram(build.program);
+        build.storeInCache = true;
+    }
+
+    build.vertexShader = submitStage(GL_VERTEX_SHADER, vertexCode);
+    build.fragmentShader = submitStage(GL_FRAGMENT_SHADER, fragmentCode);
+    build.program = glCreateProgram();
+    glAttachShader(build.program, build.vertexShader);
+    glAttachShader(build.program, build.fragmentShader);
+    if (build.storeInCache) glExtensions.ProgramParameteri(build.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glLinkProgram(build.program);
+    build.state = Linking;
+}
+
+bool ShaderBuilder::IsLinkComplete(const PendingProgram& build) const
+{
+    if (!glExtensions.parallelShaderCompile) return true; // zapytanie o status i tak zaczeka na sterownik
+    GLint complete = GL_FALSE;
+    glGetProgramiv(build.program, GL_COMPLETION_STATUS_KHR, &complete);
+    return complete == GL_TRUE;
+}
+
+void ShaderBuilder::FinishBuild(PendingProgram& build)
+{
+    GLint linked = GL_FALSE;
+    glGetProgramiv(build.program, GL_LINK_STATUS, &linked);
+    if (linked == GL_FALSE) {
+        std::cerr << "BŁĄD::SHADER: " << build.vertexFile << " / " << build.fragmentFile << std::endl;
+        if (build.vertexShader) build.target->compileErrors(build.vertexShader, "VERTEX");
+        if (build.fragmentShader) build.target->compileErrors(build.fragmentShader, "FRAGMENT");
+        build.target->compileErrors(build.program, "PROGRAM");
+        GLState::DeleteProgram(build.program);
+        build.state = Failed;
+    }
+    else {
+        if (build.storeInCache) Shader::programCache->Store(build.cacheKey, build.program);
+        build.target->ID = build.program;
+        build.target->cacheUniformLocations();
+        build.state = Done;
+    }
+    build.program = 0;
+    if (build.vertexShader) glDeleteShader(build.vertexShader);
+    if (build.fragmentShader) glDeleteShader(build.fragmentShader);
+    build.vertexShader = 0;
+    build.fragmentShader = 0;
+}
+
+int ShaderBuilder::Poll()
+{
+    // 1. Zgłoszenie wszystkich programów, których źródła są już wczytane
+    for (PendingProgram& build : pending) {
+        if (build.state == Reading && isFutureReady(build.vertexSource) && isFutureReady(build.fragmentSource)) {
+            StartBuild(build);
+        }
+    }
+
+    // 2. Dopiero teraz statusy - bez rozszerzenia pierwsze zapytanie czeka, ale sterownik ma już całą pracę
+    int completed = 0;
+    for (PendingProgram& build : pending) {
+        if (build.state == Linking && IsLinkComplete(build)) {
+            FinishBuild(build);
+            if (build.state == Done) ++completed;
+        }
+        if (build.state == Failed) ++failedCount;
+    }
+
+    pending.erase(std::remove_if(pending.begin(), pending.end(),
+        [](const PendingProgram& build) { return build.state == Done || build.state == Failed; }), pending.end());
+    return completed;
+}
+
+int ShaderBuilder::Finish()
+{
+    int completed = 0;
+    while (!pending.empty()) {
+        for (PendingProgram& build : pending) {
+            if (build.state == Reading) {
+                build.vertexSource.wait();
+                build.fragmentSource.wait();
+            }
+        }
+        completed += Poll();
+        if (!pending.empty()) std::this_thread::yield();
+    }
+    return completed;
+}
@@ -0,0 +1,64 @@
+#ifndef SHADER_BUILDER_CLASS_H
+#define SHADER_BUILDER_CLASS_H
+
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+#include <future>
+#include <cstdint>
+#include "ThreadPool.h"
+
+class Shader;
+class ShaderDefines;
+
+// Asynchroniczne budowanie programów dla Shader(builder, vert, frag):
+//  - pliki .vert/.frag czytane są na wątkach puli,
+//  - Poll najpierw zgłasza kompilację i linkowanie WSZYSTKICH programów z gotowymi źródłami, dopiero potem pyta o statusy,
+//  - z KHR_parallel_shader_compile status sprawdzany jest przez GL_COMPLETION_STATUS_KHR, więc Poll nie blokuje;
+//    bez rozszerzenia pierwsze zapytanie o status czeka na sterownik (ale wszystkie programy są już wtedy zgłoszone).
+// Wszystkie wywołania GL odbywają się w Poll/Finish, na wątku z kontekstem.
+class ShaderBuilder
+{
+public:
+    explicit ShaderBuilder(ThreadPool& pool);
+    ~ShaderBuilder();
+
+    // Wołać raz na klatkę; zwraca liczbę programów, które właśnie stały się gotowe (Shader::IsReady)
+    int Poll();
+    // Czeka na wszystkie programy (np. przed pomiarami); zwraca liczbę programów gotowych w tym wywołaniu
+    int Finish();
+
+    int PendingCount() const { return (int)pending.size(); }
+    int FailedCount() const { return failedCount; }
+
+private:
+    friend class Shader;
+
+    enum BuildState { Reading, Linking, Done, Failed };
+
+    struct PendingProgram
+    {
+        Shader* target;
+        std::string vertexFile;
+        std::string fragmentFile;
+        std::future<std::string> vertexSource;
+        std::future<std::string> fragmentSource;
+        GLuint vertexShader;
+        GLuint fragmentShader;
+        GLuint program;
+        bool storeInCache;
+        uint64_t cacheKey;
+        BuildState state;
+    };
+
+    ThreadPool& pool;
+    std::vector<PendingProgram> pending;
+    int failedCount;
+
+    void Submit(Shader* target, const char* vertexFile, const char* fragmentFile, const ShaderDefines& defines);
+    void StartBuild(PendingProgram& build);
+    bool IsLinkComplete(const PendingProgram& build) const;
+    void FinishBuild(PendingProgram& build);
+};
+
+#endif
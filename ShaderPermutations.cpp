@@ -0,0 +1,22 @@
+#include "ShaderPermutations.h"
+
+ShaderPermutations::ShaderPermutations(ShaderBuilder& builder, const char* vertexFile, const char* fragmentFile)
+    : builder(builder), vertexFile(vertexFile), fragmentFile(fragmentFile)
+{
+}
+
+Shader& ShaderPermutations::Get(const ShaderDefines& defines)
+{
+    std::unique_ptr<Shader>& variant = variants[defines.Source()];
+    if (!variant) {
+        variant.reset(new Shader(builder, vertexFile.c_str(), fragmentFile.c_str(), defines));
+    }
+    return *variant;
+}
+
+void ShaderPermutations::Delete()
+{
+    for (std::map<std::string, std::unique_ptr<Shader>>::iterator it = variants.begin(); it != variants.end(); ++it) {
+        it->second->Delete();
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef SHADER_PERMUTATIONS_CLASS_H
+#define SHADER_PERMUTATIONS_CLASS_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include "shaderClass.h"
+#include "ShaderBuilder.h"
+
+// Warianty jednej pary plików .vert/.frag różniące się zestawem #define (ShaderDefines), np. składowymi oświetlenia.
+// Każdy wariant jest kompilowany raz (w tle, przez ShaderBuilder) i trzymany pod kluczem ShaderDefines::Source().
+// ProgramBinaryCache zapisuje każdy wariant osobno, bo jego klucz obejmuje źródło po wstrzyknięciu definicji.
+class ShaderPermutations
+{
+public:
+    ShaderPermutations(ShaderBuilder& builder, const char* vertexFile, const char* fragmentFile);
+
+    // Wariant dla zestawu definicji; nowy wariant jest zgłaszany do kompilacji i do czasu zlinkowania ma IsReady() == false.
+    // Zwrócona referencja jest ważna do Delete (warianty nie są przenoszone w pamięci).
+    Shader& Get(const ShaderDefines& defines);
+
+    int Count() const { return (int)variants.size(); }
+    void Delete();
+
+private:
+    ShaderBuilder& builder;
+    std::string vertexFile;
+    std::string fragmentFile;
+    std::map<std::string, std::unique_ptr<Shader>> variants;
+};
+
+#endif
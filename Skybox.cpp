@@ -1,4 +1,9 @@
 #include "Skybox.h"
+#include "GLState.h"
+#include "FrameUniforms.h"
+#include "GLExtensions.h"
+#include <cstring>
+#include <future>
 #include <iostream>
 
 // Upewnij si, e STB_IMAGE_IMPLEMENTATION jest zdefiniowane tylko raz w projekcie.
@@ -53,15 +58,27 @@ float skyboxVertices[] = {
 };
 
 Skybox::Skybox(const char* vertexPath, const char* fragmentPath)
-    : skyboxShader(vertexPath, fragmentPath), cubemapTextureID(0), skyboxVAO(0), skyboxVBO(0) {
+    : skyboxShader(vertexPath, fragmentPath), cubemapTextureID(0), skyboxVAO(0), skyboxVBO(0), atmosphere(nullptr) {
     setupSkybox();
+    // Macierze z bloku danych klatki; sampler cubemapy ustawiany raz - stala jednostka 0
+    skyboxShader.BindUniformBlock(kFrameDataBlockName, kFrameDataBinding);
+    skyboxShader.Activate();
+    skyboxShader.setInt("skyboxTexture", 0);
+    atmosphereUniform = skyboxShader.Uniform<float>("u_atmosphere");
+    atmosphereUniform.Set(0.0f);
+}
+
+void Skybox::SetAtmosphere(Atmosphere* skyAtmosphere) {
+    atmosphere = skyAtmosphere;
+    skyboxShader.Activate();
+    if (atmosphere) skyboxShader.setInt("skyViewLut", (int)atmosphere->unit);
 }
 
 Skybox::~Skybox() {
-    glDeleteVertexArrays(1, &skyboxVAO);
-    glDeleteBuffers(1, &skyboxVBO);
+    GLState::DeleteVertexArray(skyboxVAO);
+    GLState::DeleteBuffer(skyboxVBO);
     if (cubemapTextureID != 0) {
-        glDeleteTextures(1, &cubemapTextureID);
+        GLState::DeleteTexture(cubemapTextureID);
     }
     // Destruktor obiektu Shader powinien zaj si zwolnieniem programu shadera (skyboxShader.Delete())
 }
@@ -70,14 +87,14 @@ void Skybox::setupSkybox() {
     glGenVertexArrays(1, &skyboxVAO);
     glGenBuffers(1, &skyboxVBO);
 
-    glBindVertexArray(skyboxVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, skyboxVBO);
+    GLState::BindVertexArray(skyboxVAO);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, skyboxVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(skyboxVertices), &skyboxVertices, GL_STATIC_DRAW);
 
     glEnableVertexAttribArray(0); // Pozycja wierzchoka
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
 
-    glBindVertexArray(0); // Odcz VAO
+    GLState::BindVertexArray(0); // Odcz VAO
 }
 
 // Kolejno cianek tekstury: Prawo, Lewo, Gra, D, Przd(+Z), Ty(-Z)
@@ -88,55 +105,107 @@ void Skybox::setupSkybox() {
 // GL_TEXTURE_CUBE_MAP_NEGATIVE_Y
 // GL_TEXTURE_CUBE_MAP_POSITIVE_Z
 // GL_TEXTURE_CUBE_MAP_NEGATIVE_Z
-bool Skybox::loadCubemap(std::vector<std::string> faces) {
+bool Skybox::loadCubemap(const std::vector<std::string>& faces, ThreadPool& pool) {
     if (faces.size() != 6) {
         std::cerr << "ERROR::SKYBOX::LOAD_CUBEMAP::Oczekiwano 6 tekstur, otrzymano " << faces.size() << std::endl;
         return false;
     }
 
-    glGenTextures(1, &cubemapTextureID);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, cubemapTextureID);
+    // Wymiary z samych naglowkow plikow - bufor posredni przydzielany przed dekodowaniem
+    int width = 0, height = 0, nrChannels = 0;
+    for (unsigned int i = 0; i < faces.size(); i++) {
+        int faceWidth = 0, faceHeight = 0;
+        if (!stbi_info(faces[i].c_str(), &faceWidth, &faceHeight, &nrChannels)) {
+            std::cerr << "ERROR::SKYBOX::LOAD_CUBEMAP::Nie udalo sie zaladowac tekstury cubemapy: " << faces[i] << std::endl;
+            std::cerr << "STB Reason: " << stbi_failure_reason() << std::endl;
+            return false;
+        }
+        if (i == 0) { width = faceWidth; height = faceHeight; }
+        if (faceWidth != width || faceHeight != height || width != height) {
+            std::cerr << "ERROR::SKYBOX::LOAD_CUBEMAP::Sciany cubemapy musza byc kwadratowe i rowne: " << faces[i] << std::endl;
+            return false;
+        }
+    }
 
-    // Cubemapy czsto nie wymagaj odwracania wertykalnego,
-    // lub zaley to od rda tekstur. W razie problemw mona zmieni na true.
-    // Twoja klasa Texture.cpp uywa stbi_set_flip_vertically_on_load(true) dla tekstur 2D.
-    stbi_set_flip_vertically_on_load(false);
+    // Jeden PBO na wszystkie sciany (zawsze RGBA8 - staly format niezaleznie od liczby kanalow pliku);
+    // watki puli dekoduja sciany rownolegle prosto do zmapowanego bufora
+    const size_t faceBytes = (size_t)width * height * 4;
+    GLuint stagingBuffer = 0;
+    glGenBuffers(1, &stagingBuffer);
+    GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, stagingBuffer);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)(faceBytes * faces.size()), nullptr, GL_STREAM_DRAW);
+    unsigned char* staging = static_cast<unsigned char*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)(faceBytes * faces.size()),
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+    std::vector<unsigned char> clientStaging;
+    if (!staging) {
+        clientStaging.resize(faceBytes * faces.size()); // bez mapowania - wysylka z pamieci klienta
+        staging = clientStaging.data();
+    }
 
-    int width, height, nrChannels;
+    std::vector<std::future<std::string>> decoded;
     for (unsigned int i = 0; i < faces.size(); i++) {
-        unsigned char* data = stbi_load(faces[i].c_str(), &width, &height, &nrChannels, 0);
-        if (data) {
-            GLenum format = GL_RGB; // Domylny format
-            if (nrChannels == 1) format = GL_RED;
-            else if (nrChannels == 3) format = GL_RGB;
-            else if (nrChannels == 4) format = GL_RGBA;
-
-            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+        std::string path = faces[i];
+        unsigned char* target = staging + i * faceBytes;
+        decoded.push_back(pool.Submit([path, target, width, height, faceBytes]() -> std::string {
+            // Cubemapy bez odwracania; ustawienie tylko dla tego watku - globalnej flagi stb nie ruszamy
+            stbi_set_flip_vertically_on_load_thread(0);
+            int faceWidth = 0, faceHeight = 0, channels = 0;
+            unsigned char* data = stbi_load(path.c_str(), &faceWidth, &faceHeight, &channels, 4);
+            if (!data) {
+                const char* reason = stbi_failure_reason();
+                return reason ? reason : "nieznany";
+            }
+            if (faceWidth != width || faceHeight != height) {
+                stbi_image_free(data);
+                return "wymiary inne niz w naglowku";
+            }
+            std::memcpy(target, data, faceBytes);
             stbi_image_free(data);
+            return std::string();
+        }));
+    }
+    bool allFaces = true;
+    for (unsigned int i = 0; i < faces.size(); i++) {
+        std::string failure = decoded[i].get();
+        if (!failure.empty()) {
+            std::cerr << "ERROR::SKYBOX::LOAD_CUBEMAP::Nie udalo sie zaladowac tekstury cubemapy: " << faces[i] << std::endl;
+            std::cerr << "STB Reason: " << failure << std::endl;
+            allFaces = false;
+        }
+    }
+    if (clientStaging.empty()) glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    else GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (allFaces) {
+        glGenTextures(1, &cubemapTextureID);
+        GLState::BindTexture(0, GL_TEXTURE_CUBE_MAP, cubemapTextureID);
+        if (glExtensions.textureStorage) {
+            glExtensions.TexStorage2D(GL_TEXTURE_CUBE_MAP, 1, GL_RGBA8, width, height); // niezmienny magazyn, jeden poziom
         }
         else {
-            std::cerr << "ERROR::SKYBOX::LOAD_CUBEMAP::Nie udao si zaadowa tekstury cubemapy: " << faces[i] << std::endl;
-            std::cerr << "STB Reason: " << stbi_failure_reason() << std::endl;
-            // stbi_image_free(data); // Bezpieczne, nawet jeli data jest null
-            glDeleteTextures(1, &cubemapTextureID); // Posprztaj
-            cubemapTextureID = 0;
-            stbi_set_flip_vertically_on_load(true); // Przywr domylne ustawienie dla innych tekstur, jeli to konieczne
-            return false;
+            for (unsigned int i = 0; i < faces.size(); i++) {
+                glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            }
+        }
+        for (unsigned int i = 0; i < faces.size(); i++) {
+            const void* source = clientStaging.empty() ? reinterpret_cast<const void*>(i * faceBytes) : static_cast<const void*>(staging + i * faceBytes);
+            glTexSubImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, source);
         }
-    }
-    stbi_set_flip_vertically_on_load(true); // Przywr domylne ustawienie dla innych tekstur (jeli Texture.cpp tego oczekuje)
 
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+        GLState::BindTexture(0, GL_TEXTURE_CUBE_MAP, 0);
+    }
 
-    glBindTexture(GL_TEXTURE_CUBE_MAP, 0); // Odcz tekstur
-    return true;
+    GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0); // inne glTexImage2D czytalyby z PBO
+    GLState::DeleteBuffer(stagingBuffer);           // kopia do tekstury juz zgloszona - sterownik zwolni bufor po niej
+    return allFaces;
 }
 
-void Skybox::Draw(const glm::mat4& view, const glm::mat4& projection) {
+void Skybox::Draw() {
     if (cubemapTextureID == 0 || skyboxVAO == 0) {
         // Skybox nie jest zaadowany lub skonfigurowany
         return;
@@ -144,22 +213,18 @@ void Skybox::Draw(const glm::mat4& view, const glm::mat4& projection) {
 
     // Zmie funkcj gbi, aby test gbi przechodzi, gdy wartoci s rwne zawartoci bufora gbi.
     // Skybox powinien by rysowany, jeli jego gbia jest <= istniejcej gbi (ktra wyniesie 1.0 dziki shaderowi).
-    glDepthFunc(GL_LEQUAL);
+    GLState::DepthFunc(GL_LEQUAL);
 
     skyboxShader.Activate();
-    // Macierz widoku dla skyboxa nie powinna zawiera translacji.
-    // Vertex shader (`skybox.vert`) zajmuje si usuniciem translacji z macierzy 'view'.
-    skyboxShader.setMat4("view", view);
-    skyboxShader.setMat4("projection", projection);
-    skyboxShader.setInt("skyboxTexture", 0); // Ustaw uniform samplera cubemapy
 
-    glBindVertexArray(skyboxVAO);
-    glActiveTexture(GL_TEXTURE0); // Aktywuj jednostk teksturujc 0
-    glBindTexture(GL_TEXTURE_CUBE_MAP, cubemapTextureID);
+    GLState::BindVertexArray(skyboxVAO);
+    GLState::BindTexture(0, GL_TEXTURE_CUBE_MAP, cubemapTextureID); //jednostka 0 - pomijane, gdy juz zbindowana
+    const bool skyReady = atmosphere && atmosphere->IsReady();
+    if (skyReady) atmosphere->Bind();
+    atmosphereUniform.Set(skyReady ? 1.0f : 0.0f);
 
-    glDrawArrays(GL_TRIANGLES, 0, 36); // Rysuj szecian skyboxa
+    GLState::DrawArrays(GL_TRIANGLES, 0, 36); // Rysuj szecian skyboxa
 
-    glBindVertexArray(0); // Odcz VAO
-    glBindTexture(GL_TEXTURE_CUBE_MAP, 0); // Odcz tekstur cubemapy
-    glDepthFunc(GL_LESS); // Przywr domyln funkcj testu gbi
+    GLState::BindVertexArray(0); //tworzenie EBO poza VAO (strumieniowane chunki) nie moze trafic do VAO skyboxa
+    GLState::DepthFunc(GL_LESS); // Przywr domyln funkcj testu gbi
 }
\ No newline at end of file
@@ -7,6 +7,8 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <vector>
 #include <string>
+#include "ThreadPool.h"
+#include "Atmosphere.h"
 #include "shaderClass.h" // Twoja klasa do obsugi shaderw
 
 // stb_image.h zostanie doczony przez Skybox.cpp
@@ -27,14 +29,20 @@ public:
     // 5. Przd (+Z w koordynatach tekstury, co odpowiada kierunkowi widoku -Z, jeli na niego patrzymy)
     // 6. Ty (-Z w koordynatach tekstury, co odpowiada kierunkowi widoku +Z, jeli na niego patrzymy)
     // Podaj pene cieki do tekstur lub upewnij si, e znajduj si w katalogu roboczym.
-    bool loadCubemap(std::vector<std::string> faces);
+    // Sciany dekodowane rownolegle na watkach pool (koszt ~ jednej sciany), RGBA8 w niezmiennym magazynie.
+    bool loadCubemap(const std::vector<std::string>& faces, ThreadPool& pool);
 
-    // Rysuje skybox
-    void Draw(const glm::mat4& view, const glm::mat4& projection);
+    // Rysuje skybox - macierze view/projection z bloku FrameData (FrameUniformBuffer::Update w tej klatce)
+    void Draw();
+
+    // Niebo z tablicy widoku atmosfery (sampler na atmosphere->unit); do czasu Atmosphere::IsReady - sama cubemapa
+    void SetAtmosphere(Atmosphere* atmosphere);
 
 private:
     unsigned int skyboxVAO, skyboxVBO;
     unsigned int cubemapTextureID;
+    Atmosphere* atmosphere;
+    UniformHandle<float> atmosphereUniform;
     Shader skyboxShader; // Skybox zarzdza wasnym shaderem
 
     void setupSkybox(); // Prywatna metoda do konfiguracji VAO/VBO
@@ -0,0 +1,174 @@
+#define _USE_MATH_DEFINES
+#include "SphereLOD.h"
+#include "GLState.h"
+#include "VertexPacking.h"
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+const float SphereLODChain::kMaxEdgePixels = 10.0f;
+const int SphereLODChain::kSectors[SphereLODChain::kLevelCount] = { 36, 24, 16, 10, 6 };
+const int SphereLODChain::kStacks[SphereLODChain::kLevelCount] = { 18, 12, 8, 6, 4 };
+
+void generateSphere(float radius, int sectorCount, int stackCount,
+    std::vector<GLfloat>& outSphereVertices, std::vector<GLuint>& outSphereIndices)
+{
+    outSphereVertices.clear();
+    outSphereIndices.clear();
+
+    float x, y, z, xy;                      //vertex position
+    float nx, ny, nz, lengthInv = 1.0f / radius;    //vertex normal
+    float s, t;                                     //vertex texCoord
+
+    float sectorStep = 2 * M_PI / sectorCount;
+    float stackStep = M_PI / stackCount;
+    float sectorAngle, stackAngle;
+
+    for (int i = 0; i <= stackCount; ++i)
+    {
+        stackAngle = M_PI / 2 - i * stackStep;        //starting from pi/2 to -pi/2
+        xy = radius * cosf(stackAngle);             //r * cos(u)
+        z = radius * sinf(stackAngle);              //r * sin(u)
+
+        for (int j = 0; j <= sectorCount; ++j)
+        {
+            sectorAngle = j * sectorStep;           //starting from 0 to 2pi
+
+            x = xy * cosf(sectorAngle);             //r * cos(u) * cos(v)
+            y = xy * sinf(sectorAngle);             //r * cos(u) * sin(v)
+            outSphereVertices.push_back(x);
+            outSphereVertices.push_back(y);
+            outSphereVertices.push_back(z);
+
+            nx = x * lengthInv;
+            ny = y * lengthInv;
+            nz = z * lengthInv;
+            outSphereVertices.push_back(nx);
+            outSphereVertices.push_back(ny);
+            outSphereVertices.push_back(nz);
+
+            s = (float)j / sectorCount;
+            t = (float)i / stackCount;
+            outSphereVertices.push_back(s);
+            outSphereVertices.push_back(t);
+        }
+    }
+
+    int k1, k2;
+    for (int i = 0; i < stackCount; ++i)
+    {
+        k1 = i * (sectorCount + 1);     
+        k2 = k1 + sectorCount + 1;      
+
+        for (int j = 0; j < sectorCount; ++j, ++k1, ++k2)
+        {
+            if (i != 0)
+            {
+                outSphereIndices.push_back(k1);
+                outSphereIndices.push_back(k2);
+                outSphereIndices.push_back(k1 + 1);
+            }
+            if (i != (stackCount - 1))
+            {
+                outSphereIndices.push_back(k1 + 1);
+                outSphereIndices.push_back(k2);
+                outSphereIndices.push_back(k2 + 1);
+            }
+        }
+    }
+    std::cout << "Generated Sphere: " << outSphereVertices.size() / 8 << " vertices, " << outSphereIndices.size() / 3 << " triangles." << std::endl;
+}
+
+SphereLODChain::SphereLODChain(MeshCache& cache, float radius)
+    : vbo(nullptr, 0, GL_STATIC_DRAW), ebo(nullptr, 0, GL_STATIC_DRAW), radius(radius)
+{
+    MeshCacheKey key("sphereLOD");
+    key.Add(radius).Add(kVertexCacheSize);
+    for (int level = 0; level < kLevelCount; ++level) key.Add(kSectors[level]).Add(kStacks[level]);
+
+    CachedMesh mesh;
+    cache.LoadOrBuild(key, [radius](PackedMesh& packed, IndexData& indices, std::vector<MeshSection>& sections) {
+        std::vector<GLuint> allIndices;
+        std::vector<GLfloat> allVertices;
+        size_t maxLevelVertices = 0;
+        for (int level = 0; level < kLevelCount; ++level) {
+            std::vector<GLfloat> vertices; std::vector<GLuint> levelIndices;
+            generateSphere(radius, kSectors[level], kStacks[level], vertices, levelIndices);
+            size_t vertexCount = vertices.size() / 8;
+            optimizeVertexCache(levelIndices, vertexCount);
+            vertexCount = optimizeVertexFetch(levelIndices, vertices.data(), vertexCount, 8 * sizeof(GLfloat));
+
+            MeshSection section = { (uint32_t)allIndices.size(), (uint32_t)levelIndices.size(), (int32_t)(allVertices.size() / 8), (uint32_t)vertexCount };
+            sections.push_back(section);
+            // Indeksy pozostają lokalne dla poziomu - przesunięcie daje baseVertex przy rysowaniu
+            allIndices.insert(allIndices.end(), levelIndices.begin(), levelIndices.end());
+            allVertices.insert(allVertices.end(), vertices.begin(), vertices.begin() + vertexCount * 8);
+            maxLevelVertices = std::max(maxLevelVertices, vertexCount);
+        }
+        // Wszystkie poziomy pakowane razem - jedno texCoordScale (i przesunięcie UV) obowiązuje cały łańcuch
+        packed = packVertices(allVertices.data(), allVertices.size() / 8, 8, 0, 6, 3); // pozycja, normalna, UV
+        indices = makeIndexData(allIndices, maxLevelVertices);
+    }, mesh);
+
+    indexType = mesh.indexType;
+    texCoordScale = mesh.texCoordScale;
+    for (int level = 0; level < kLevelCount; ++level) levels[level] = mesh.sections[level];
+
+    vbo.Bind();
+    glBufferData(GL_ARRAY_BUFFER, mesh.vertexBytes, mesh.vertexData, GL_STATIC_DRAW);
+    vbo.Unbind();
+    ebo.Bind();
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.indexBytes, mesh.indexData, GL_STATIC_DRAW);
+    ebo.Unbind();
+    mesh.Release();
+
+    std::cout << "Sfera LOD: trójkąty na poziom";
+    for (int level = 0; level < kLevelCount; ++level) std::cout << " " << TriangleCount(level);
+    std::cout << std::endl;
+}
+
+void SphereLODChain::LinkAttribs(VAO& vao)
+{
+    vao.Bind();
+    ebo.Bind(); // EBO jest częścią stanu VAO
+    linkPackedVertexAttribs(vao, vbo);
+}
+
+int SphereLODChain::SelectLevel(const glm::mat4& camMatrix, const glm::vec3& center, float worldRadius, float viewportHeight) const
+{
+    float w = camMatrix[0][3] * center.x + camMatrix[1][3] * center.y + camMatrix[2][3] * center.z + camMatrix[3][3];
+    if (w <= worldRadius) return 0; // kamera w sferze lub tuż przy niej
+
+    // Drugi wiersz projekcja*widok to P[1][1] * (wiersz obrotu widoku o długości 1) - długość daje skalę projekcji
+    float projectionScale = glm::length(glm::vec3(camMatrix[0][1], camMatrix[1][1], camMatrix[2][1]));
+    float radiusPixels = worldRadius * projectionScale / w * viewportHeight * 0.5f;
+    float requiredSectors = 2.0f * (float)M_PI * radiusPixels / kMaxEdgePixels;
+
+    for (int level = kLevelCount - 1; level > 0; --level) {
+        if ((float)kSectors[level] >= requiredSectors) return level;
+    }
+    return 0;
+}
+
+void SphereLODChain::Draw(int level) const
+{
+    const MeshSection& section = levels[level];
+    size_t indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint);
+    GLState::DrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)section.indexCount, indexType,
+        (void*)(section.firstIndex * indexSize), section.baseVertex);
+}
+
+void SphereLODChain::DrawInstanced(int level, GLsizei instanceCount) const
+{
+    const MeshSection& section = levels[level];
+    size_t indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint);
+    GLState::DrawElementsInstancedBaseVertex(GL_TRIANGLES, (GLsizei)section.indexCount, indexType,
+        (void*)(section.firstIndex * indexSize), instanceCount, section.baseVertex);
+}
+
+void SphereLODChain::Delete()
+{
+    vbo.Delete();
+    ebo.Delete();
+}
@@ -0,0 +1,56 @@
+#ifndef SPHERE_LOD_CLASS_H
+#define SPHERE_LOD_CLASS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include "VAO.h"
+#include "VBO.h"
+#include "EBO.h"
+#include "MeshCache.h"
+
+// Sfera UV: (stackCount+1) x (sectorCount+1) wierzchołków po 8 floatów (pozycja, normalna, UV)
+void generateSphere(float radius, int sectorCount, int stackCount,
+    std::vector<GLfloat>& outSphereVertices, std::vector<GLuint>& outSphereIndices);
+
+// Łańcuch poziomów szczegółowości sfery (od 36x18 do 6x4) we wspólnym VBO/EBO.
+// Każdy poziom to zakres indeksów + baseVertex, rysowany glDrawElements(Instanced)BaseVertex.
+// Poziom wybierany jest z promienia sfery rzutowanego na ekran (w pikselach).
+class SphereLODChain
+{
+public:
+    static const int kLevelCount = 5;
+
+    // Poziomy budowane raz i trzymane w MeshCache (jak pojedyncza sfera wcześniej)
+    SphereLODChain(MeshCache& cache, float radius);
+
+    // Dopina EBO i atrybuty PackedVertex (lokacje 0, 2, 3) do vao
+    void LinkAttribs(VAO& vao);
+
+    // Najtańszy poziom, dla którego krawędź konturu na ekranie nie przekracza kMaxEdgePixels.
+    // camMatrix = projekcja * widok; worldRadius - promień sfery po transformacji modelu.
+    int SelectLevel(const glm::mat4& camMatrix, const glm::vec3& center, float worldRadius, float viewportHeight) const;
+
+    // VAO z LinkAttribs musi być zbindowane
+    void Draw(int level) const;
+    void DrawInstanced(int level, GLsizei instanceCount) const;
+
+    GLsizei TriangleCount(int level) const { return (GLsizei)levels[level].indexCount / 3; }
+    float Radius() const { return radius; }
+    float TexCoordScale() const { return texCoordScale; }
+    void Delete();
+
+private:
+    static const float kMaxEdgePixels;
+    static const int kSectors[kLevelCount];
+    static const int kStacks[kLevelCount];
+
+    VBO vbo;
+    EBO ebo;
+    GLenum indexType;
+    float radius;
+    float texCoordScale;
+    MeshSection levels[kLevelCount];
+};
+
+#endif
@@ -0,0 +1,469 @@
+#include "Terrain.h"
+#include "ThreadPool.h"
+#include <cmath>
+#include <atomic>
+#include <iostream>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define TERRAIN_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// GCC/Clang wymagają atrybutu target dla funkcji z intrynsykami AVX2; MSVC kompiluje je bez dodatkowych flag
+#if defined(TERRAIN_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define TERRAIN_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TERRAIN_TARGET_AVX2
+#endif
+
+// Współczynniki oktaw - te same co w getHeight
+static const float kTotalCoeffs = 1.0f + 0.4f + 0.15f + 0.08f;
+
+float getHeight(float x, float z, float amplitude, float frequency) {
+    float h = 0.0f;
+    h += amplitude * sin((x + z * 0.5f) * frequency);
+    h += (amplitude * 0.4f) * cos((x - z * 0.8f) * frequency * 1.5f);
+    h += (amplitude * 0.15f) * sin((x * 2.5f + z * 1.5f) * frequency * 2.0f);
+    h += (amplitude * 0.08f) * cos((z * 3.0f - x * 0.7f) * frequency * 3.0f);
+    float total_coeffs = 1.0f + 0.4f + 0.15f + 0.08f;
+    h /= total_coeffs;
+    return h;
+}
+
+glm::vec3 calculateNormal(float x, float z, float epsilon, float amplitude, float frequency) {
+    float y_center = getHeight(x, z, amplitude, frequency);
+    float y_dx = getHeight(x + epsilon, z, amplitude, frequency);
+    float y_dz = getHeight(x, z + epsilon, amplitude, frequency);
+    glm::vec3 tangentX = glm::vec3(epsilon, y_dx - y_center, 0.0f);
+    glm::vec3 tangentZ = glm::vec3(0.0f, y_dz - y_center, epsilon);
+    glm::vec3 normal = glm::normalize(glm::cross(tangentZ, tangentX));
+    return normal;
+}
+
+// Pochodne cząstkowe sumy oktaw:
+//   u1 = (x + 0.5z)f        dh/dx +=  1.0   * cos(u1)   dh/dz +=  0.5  * cos(u1)
+//   u2 = (x - 0.8z)1.5f     dh/dx += -0.6   * sin(u2)   dh/dz +=  0.48 * sin(u2)
+//   u3 = (2.5x + 1.5z)2f    dh/dx +=  0.75  * cos(u3)   dh/dz +=  0.45 * cos(u3)
+//   u4 = (3z - 0.7x)3f      dh/dx +=  0.168 * sin(u4)   dh/dz += -0.72 * sin(u4)
+// całość mnożona przez amplitude * frequency / total_coeffs. Normalna = normalize(-dh/dx, 1, -dh/dz).
+glm::vec3 calculateAnalyticNormal(float x, float z, float amplitude, float frequency) {
+    float u1 = (x + z * 0.5f) * frequency;
+    float u2 = (x - z * 0.8f) * frequency * 1.5f;
+    float u3 = (x * 2.5f + z * 1.5f) * frequency * 2.0f;
+    float u4 = (z * 3.0f - x * 0.7f) * frequency * 3.0f;
+    float c1 = std::cos(u1), s2 = std::sin(u2), c3 = std::cos(u3), s4 = std::sin(u4);
+    float k = amplitude * frequency / kTotalCoeffs;
+    float dhdx = k * (c1 - 0.6f * s2 + 0.75f * c3 + 0.168f * s4);
+    float dhdz = k * (0.5f * c1 + 0.48f * s2 + 0.45f * c3 - 0.72f * s4);
+    return glm::normalize(glm::vec3(-dhdx, 1.0f, -dhdz));
+}
+
+// Druga pochodna oktawy c*sin(a*x + b*z) po x to -c*a²*sin(...), więc |h_xx| <= sum(c_i * a_i²) (analogicznie dla z).
+// Szybkości zmian (a_i, b_i) jak w tabeli pochodnych powyżej, już z mnożnikami częstotliwości oktaw.
+glm::vec2 heightCurvatureBound(float amplitude, float frequency) {
+    const float coeffs[4] = { 1.0f, 0.4f, 0.15f, 0.08f };
+    const float rateX[4] = { 1.0f, 1.5f, 5.0f, 2.1f };
+    const float rateZ[4] = { 0.5f, 1.2f, 3.0f, 9.0f };
+    float fxx = 0.0f, fzz = 0.0f;
+    for (int i = 0; i < 4; ++i) {
+        fxx += coeffs[i] * rateX[i] * rateX[i];
+        fzz += coeffs[i] * rateZ[i] * rateZ[i];
+    }
+    float scale = std::fabs(amplitude) * frequency * frequency / kTotalCoeffs;
+    return glm::vec2(fxx * scale, fzz * scale);
+}
+
+// --- Ścieżka skalarna (fallback) ---
+
+static void heightBatchScalar(const float* xs, const float* zs, int count, float amplitude, float frequency,
+    float* outHeights, float* outNormals)
+{
+    float k = amplitude * frequency / kTotalCoeffs;
+    for (int i = 0; i < count; ++i) {
+        float x = xs[i], z = zs[i];
+        float u1 = (x + z * 0.5f) * frequency;
+        float u2 = (x - z * 0.8f) * frequency * 1.5f;
+        float u3 = (x * 2.5f + z * 1.5f) * frequency * 2.0f;
+        float u4 = (z * 3.0f - x * 0.7f) * frequency * 3.0f;
+        float s1 = std::sin(u1), c2 = std::cos(u2), s3 = std::sin(u3), c4 = std::cos(u4);
+        float h = 0.0f;
+        h += amplitude * s1;
+        h += (amplitude * 0.4f) * c2;
+        h += (amplitude * 0.15f) * s3;
+        h += (amplitude * 0.08f) * c4;
+        outHeights[i] = h / kTotalCoeffs;
+        if (outNormals) {
+            float c1 = std::cos(u1), s2 = std::sin(u2), c3 = std::cos(u3), s4 = std::sin(u4);
+            float nx = -k * (c1 - 0.6f * s2 + 0.75f * c3 + 0.168f * s4);
+            float nz = -k * (0.5f * c1 + 0.48f * s2 + 0.45f * c3 - 0.72f * s4);
+            float invLen = 1.0f / std::sqrt(nx * nx + 1.0f + nz * nz);
+            outNormals[i * 3 + 0] = nx * invLen;
+            outNormals[i * 3 + 1] = invLen;
+            outNormals[i * 3 + 2] = nz * invLen;
+        }
+    }
+}
+
+#ifdef TERRAIN_SIMD_X86
+
+// Stałe sincos (Cephes): redukcja argumentu do [-pi/4, pi/4] i wielomiany minimaksowe.
+// Dokładność ~1e-7 dla |x| < 8192.
+#define CEPHES_FOPI 1.27323954473516f
+#define CEPHES_DP1 -0.78515625f
+#define CEPHES_DP2 -2.4187564849853515625e-4f
+#define CEPHES_DP3 -3.77489497744594108e-8f
+#define CEPHES_SINCOF_P0 -1.9515295891e-4f
+#define CEPHES_SINCOF_P1 8.3321608736e-3f
+#define CEPHES_SINCOF_P2 -1.6666654611e-1f
+#define CEPHES_COSCOF_P0 2.443315711809948e-5f
+#define CEPHES_COSCOF_P1 -1.388731625493765e-3f
+#define CEPHES_COSCOF_P2 4.166664568298827e-2f
+
+// sin i cos czterech wartości jednocześnie (SSE2)
+static inline void sincos_sse2(__m128 x, __m128* s, __m128* c)
+{
+    const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000));
+    __m128 signBitSin = _mm_and_ps(x, signMask);
+    x = _mm_andnot_ps(signMask, x);
+
+    __m128 y = _mm_mul_ps(x, _mm_set1_ps(CEPHES_FOPI));
+    __m128i j = _mm_cvttps_epi32(y);
+    j = _mm_add_epi32(j, _mm_set1_epi32(1));
+    j = _mm_and_si128(j, _mm_set1_epi32(~1));
+    y = _mm_cvtepi32_ps(j);
+
+    __m128 swapSignSin = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(j, _mm_set1_epi32(4)), 29));
+    __m128 polyMask = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, _mm_set1_epi32(2)), _mm_setzero_si128()));
+    __m128 signBitCos = _mm_castsi128_ps(_mm_slli_epi32(
+        _mm_andnot_si128(_mm_sub_epi32(j, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));
+    signBitSin = _mm_xor_ps(signBitSin, swapSignSin);
+
+    x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(CEPHES_DP1)));
+    x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(CEPHES_DP2)));
+    x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(CEPHES_DP3)));
+    __m128 z = _mm_mul_ps(x, x);
+
+    __m128 yc = _mm_set1_ps(CEPHES_COSCOF_P0);
+    yc = _mm_add_ps(_mm_mul_ps(yc, z), _mm_set1_ps(CEPHES_COSCOF_P1));
+    yc = _mm_add_ps(_mm_mul_ps(yc, z), _mm_set1_ps(CEPHES_COSCOF_P2));
+    yc = _mm_mul_ps(_mm_mul_ps(yc, z), z);
+    yc = _mm_sub_ps(yc, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+    yc = _mm_add_ps(yc, _mm_set1_ps(1.0f));
+
+    __m128 ys = _mm_set1_ps(CEPHES_SINCOF_P0);
+    ys = _mm_add_ps(_mm_mul_ps(ys, z), _mm_set1_ps(CEPHES_SINCOF_P1));
+    ys = _mm_add_ps(_mm_mul_ps(ys, z), _mm_set1_ps(CEPHES_SINCOF_P2));
+    ys = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(ys, z), x), x);
+
+    __m128 sinPart = _mm_or_ps(_mm_and_ps(polyMask, ys), _mm_andnot_ps(polyMask, yc));
+    __m128 cosPart = _mm_or_ps(_mm_and_ps(polyMask, yc), _mm_andnot_ps(polyMask, ys));
+    *s = _mm_xor_ps(sinPart, signBitSin);
+    *c = _mm_xor_ps(cosPart, signBitCos);
+}
+
+static void heightBatchSSE2(const float* xs, const float* zs, int count, float amplitude, float frequency,
+    float* outHeights, float* outNormals)
+{
+    const __m128 f = _mm_set1_ps(frequency);
+    const __m128 f15 = _mm_set1_ps(1.5f), f2 = _mm_set1_ps(2.0f), f3 = _mm_set1_ps(3.0f);
+    const __m128 a1 = _mm_set1_ps(amplitude), a2 = _mm_set1_ps(amplitude * 0.4f);
+    const __m128 a3 = _mm_set1_ps(amplitude * 0.15f), a4 = _mm_set1_ps(amplitude * 0.08f);
+    const __m128 invTotal = _mm_set1_ps(1.0f / kTotalCoeffs);
+    const __m128 negK = _mm_set1_ps(-amplitude * frequency / kTotalCoeffs);
+    const __m128 one = _mm_set1_ps(1.0f);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(xs + i);
+        __m128 z = _mm_loadu_ps(zs + i);
+        __m128 u1 = _mm_mul_ps(_mm_add_ps(x, _mm_mul_ps(z, _mm_set1_ps(0.5f))), f);
+        __m128 u2 = _mm_mul_ps(_mm_mul_ps(_mm_sub_ps(x, _mm_mul_ps(z, _mm_set1_ps(0.8f))), f), f15);
+        __m128 u3 = _mm_mul_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(2.5f)), _mm_mul_ps(z, _mm_set1_ps(1.5f))), f), f2);
+        __m128 u4 = _mm_mul_ps(_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(z, _mm_set1_ps(3.0f)), _mm_mul_ps(x, _mm_set1_ps(0.7f))), f), f3);
+        __m128 s1, c1, s2, c2, s3, c3, s4, c4;
+        sincos_sse2(u1, &s1, &c1);
+        sincos_sse2(u2, &s2, &c2);
+        sincos_sse2(u3, &s3, &c3);
+        sincos_sse2(u4, &s4, &c4);
+
+        __m128 h = _mm_mul_ps(a1, s1);
+        h = _mm_add_ps(h, _mm_mul_ps(a2, c2));
+        h = _mm_add_ps(h, _mm_mul_ps(a3, s3));
+        h = _mm_add_ps(h, _mm_mul_ps(a4, c4));
+        _mm_storeu_ps(outHeights + i, _mm_mul_ps(h, invTotal));
+
+        if (outNormals) {
+            __m128 dx = _mm_add_ps(_mm_add_ps(c1, _mm_mul_ps(_mm_set1_ps(-0.6f), s2)),
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(0.75f), c3), _mm_mul_ps(_mm_set1_ps(0.168f), s4)));
+            __m128 dz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(0.5f), c1), _mm_mul_ps(_mm_set1_ps(0.48f), s2)),
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(0.45f), c3), _mm_mul_ps(_mm_set1_ps(-0.72f), s4)));
+            __m128 nx = _mm_mul_ps(negK, dx);
+            __m128 nz = _mm_mul_ps(negK, dz);
+            __m128 invLen = _mm_div_ps(one, _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, nx), one), _mm_mul_ps(nz, nz))));
+            float tx[4], ty[4], tz[4];
+            _mm_storeu_ps(tx, _mm_mul_ps(nx, invLen));
+            _mm_storeu_ps(ty, invLen);
+            _mm_storeu_ps(tz, _mm_mul_ps(nz, invLen));
+            for (int l = 0; l < 4; ++l) {
+                outNormals[(i + l) * 3 + 0] = tx[l];
+                outNormals[(i + l) * 3 + 1] = ty[l];
+                outNormals[(i + l) * 3 + 2] = tz[l];
+            }
+        }
+    }
+    if (i < count) {
+        heightBatchScalar(xs + i, zs + i, count - i, amplitude, frequency, outHeights + i, outNormals ? outNormals + i * 3 : nullptr);
+    }
+}
+
+// sin i cos ośmiu wartości jednocześnie (AVX2) - ten sam algorytm co sincos_sse2
+TERRAIN_TARGET_AVX2 static inline void sincos_avx2(__m256 x, __m256* s, __m256* c)
+{
+    const __m256 signMask = _mm256_castsi256_ps(_mm256_set1_epi32((int)0x80000000));
+    __m256 signBitSin = _mm256_and_ps(x, signMask);
+    x = _mm256_andnot_ps(signMask, x);
+
+    __m256 y = _mm256_mul_ps(x, _mm256_set1_ps(CEPHES_FOPI));
+    __m256i j = _mm256_cvttps_epi32(y);
+    j = _mm256_add_epi32(j, _mm256_set1_epi32(1));
+    j = _mm256_and_si256(j, _mm256_set1_epi32(~1));
+    y = _mm256_cvtepi32_ps(j);
+
+    __m256 swapSignSin = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(j, _mm256_set1_epi32(4)), 29));
+    __m256 polyMask = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(j, _mm256_set1_epi32(2)), _mm256_setzero_si256()));
+    __m256 signBitCos = _mm256_castsi256_ps(_mm256_slli_epi32(
+        _mm256_andnot_si256(_mm256_sub_epi32(j, _mm256_set1_epi32(2)), _mm256_set1_epi32(4)), 29));
+    signBitSin = _mm256_xor_ps(signBitSin, swapSignSin);
+
+    x = _mm256_add_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(CEPHES_DP1)));
+    x = _mm256_add_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(CEPHES_DP2)));
+    x = _mm256_add_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(CEPHES_DP3)));
+    __m256 z = _mm256_mul_ps(x, x);
+
+    __m256 yc = _mm256_set1_ps(CEPHES_COSCOF_P0);
+    yc = _mm256_add_ps(_mm256_mul_ps(yc, z), _mm256_set1_ps(CEPHES_COSCOF_P1));
+    yc = _mm256_add_ps(_mm256_mul_ps(yc, z), _mm256_set1_ps(CEPHES_COSCOF_P2));
+    yc = _mm256_mul_ps(_mm256_mul_ps(yc, z), z);
+    yc = _mm256_sub_ps(yc, _mm256_mul_ps(z, _mm256_set1_ps(0.5f)));
+    yc = _mm256_add_ps(yc, _mm256_set1_ps(1.0f));
+
+    __m256 ys = _mm256_set1_ps(CEPHES_SINCOF_P0);
+    ys = _mm256_add_ps(_mm256_mul_ps(ys, z), _mm256_set1_ps(CEPHES_SINCOF_P1));
+    ys = _mm256_add_ps(_mm256_mul_ps(ys, z), _mm256_set1_ps(CEPHES_SINCOF_P2));
+    ys = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(ys, z), x), x);
+
+    *s = _mm256_xor_ps(_mm256_blendv_ps(yc, ys, polyMask), signBitSin);
+    *c = _mm256_xor_ps(_mm256_blendv_ps(ys, yc, polyMask), signBitCos);
+}
+
+TERRAIN_TARGET_AVX2 static void heightBatchAVX2(const float* xs, const float* zs, int count, float amplitude, float frequency,
+    float* outHeights, float* outNormals)
+{
+    const __m256 f = _mm256_set1_ps(frequency);
+    const __m256 f15 = _mm256_set1_ps(1.5f), f2 = _mm256_set1_ps(2.0f), f3 = _mm256_set1_ps(3.0f);
+    const __m256 a1 = _mm256_set1_ps(amplitude), a2 = _mm256_set1_ps(amplitude * 0.4f);
+    const __m256 a3 = _mm256_set1_ps(amplitude * 0.15f), a4 = _mm256_set1_ps(amplitude * 0.08f);
+    const __m256 invTotal = _mm256_set1_ps(1.0f / kTotalCoeffs);
+    const __m256 negK = _mm256_set1_ps(-amplitude * frequency / kTotalCoeffs);
+    const __m256 one = _mm256_set1_ps(1.0f);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_loadu_ps(xs + i);
+        __m256 z = _mm256_loadu_ps(zs + i);
+        __m256 u1 = _mm256_mul_ps(_mm256_add_ps(x, _mm256_mul_ps(z, _mm256_set1_ps(0.5f))), f);
+        __m256 u2 = _mm256_mul_ps(_mm256_mul_ps(_mm256_sub_ps(x, _mm256_mul_ps(z, _mm256_set1_ps(0.8f))), f), f15);
+        __m256 u3 = _mm256_mul_ps(_mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(2.5f)), _mm256_mul_ps(z, _mm256_set1_ps(1.5f))), f), f2);
+        __m256 u4 = _mm256_mul_ps(_mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(z, _mm256_set1_ps(3.0f)), _mm256_mul_ps(x, _mm256_set1_ps(0.7f))), f), f3);
+        __m256 s1, c1, s2, c2, s3, c3, s4, c4;
+        sincos_avx2(u1, &s1, &c1);
+        sincos_avx2(u2, &s2, &c2);
+        sincos_avx2(u3, &s3, &c3);
+        sincos_avx2(u4, &s4, &c4);
+
+        __m256 h = _mm256_mul_ps(a1, s1);
+        h = _mm256_add_ps(h, _mm256_mul_ps(a2, c2));
+        h = _mm256_add_ps(h, _mm256_mul_ps(a3, s3));
+        h = _mm256_add_ps(h, _mm256_mul_ps(a4, c4));
+        _mm256_storeu_ps(outHeights + i, _mm256_mul_ps(h, invTotal));
+
+        if (outNormals) {
+            __m256 dx = _mm256_add_ps(_mm256_add_ps(c1, _mm256_mul_ps(_mm256_set1_ps(-0.6f), s2)),
+                _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(0.75f), c3), _mm256_mul_ps(_mm256_set1_ps(0.168f), s4)));
+            __m256 dz = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(0.5f), c1), _mm256_mul_ps(_mm256_set1_ps(0.48f), s2)),
+                _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(0.45f), c3), _mm256_mul_ps(_mm256_set1_ps(-0.72f), s4)));
+            __m256 nx = _mm256_mul_ps(negK, dx);
+            __m256 nz = _mm256_mul_ps(negK, dz);
+            __m256 invLen = _mm256_div_ps(one, _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx, nx), one), _mm256_mul_ps(nz, nz))));
+            float tx[8], ty[8], tz[8];
+            _mm256_storeu_ps(tx, _mm256_mul_ps(nx, invLen));
+            _mm256_storeu_ps(ty, invLen);
+            _mm256_storeu_ps(tz, _mm256_mul_ps(nz, invLen));
+            for (int l = 0; l < 8; ++l) {
+                outNormals[(i + l) * 3 + 0] = tx[l];
+                outNormals[(i + l) * 3 + 1] = ty[l];
+                outNormals[(i + l) * 3 + 2] = tz[l];
+            }
+        }
+    }
+    if (i < count) {
+        heightBatchSSE2(xs + i, zs + i, count - i, amplitude, frequency, outHeights + i, outNormals ? outNormals + i * 3 : nullptr);
+    }
+}
+
+static bool cpuSupportsAVX2()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx) return false;
+    if ((_xgetbv(0) & 0x6) != 0x6) return false; // system zapisuje rejestry YMM
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#elif defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#else
+    return false;
+#endif
+}
+
+#endif // TERRAIN_SIMD_X86
+
+static HeightSimdLevel detectHeightSimdLevel()
+{
+#ifdef TERRAIN_SIMD_X86
+    if (cpuSupportsAVX2()) return HeightSimdLevel::AVX2;
+    return HeightSimdLevel::SSE2; // SSE2 jest gwarantowane na x64 i domyślne (/arch:SSE2) na x86
+#else
+    return HeightSimdLevel::Scalar;
+#endif
+}
+
+static std::atomic<int> g_heightSimdLevel(-1);
+
+HeightSimdLevel getHeightSimdLevel()
+{
+    int level = g_heightSimdLevel.load(std::memory_order_relaxed);
+    if (level < 0) {
+        level = (int)detectHeightSimdLevel();
+        g_heightSimdLevel.store(level, std::memory_order_relaxed);
+    }
+    return (HeightSimdLevel)level;
+}
+
+void setHeightSimdLevel(HeightSimdLevel level)
+{
+    HeightSimdLevel supported = detectHeightSimdLevel();
+    if ((int)level > (int)supported) level = supported;
+    g_heightSimdLevel.store((int)level, std::memory_order_relaxed);
+}
+
+const char* heightSimdLevelName(HeightSimdLevel level)
+{
+    switch (level) {
+    case HeightSimdLevel::AVX2: return "AVX2";
+    case HeightSimdLevel::SSE2: return "SSE2";
+    default: return "skalarna";
+    }
+}
+
+void getHeightBatch(const float* xs, const float* zs, int count, float amplitude, float frequency,
+    float* outHeights, float* outNormals)
+{
+    switch (getHeightSimdLevel()) {
+#ifdef TERRAIN_SIMD_X86
+    case HeightSimdLevel::AVX2: heightBatchAVX2(xs, zs, count, amplitude, frequency, outHeights, outNormals); break;
+    case HeightSimdLevel::SSE2: heightBatchSSE2(xs, zs, count, amplitude, frequency, outHeights, outNormals); break;
+#endif
+    default: heightBatchScalar(xs, zs, count, amplitude, frequency, outHeights, outNormals); break;
+    }
+}
+
+void getHeightRow(float xStart, float xStep, float z, int count, float amplitude, float frequency,
+    float* outHeights, float* outNormals)
+{
+    // Wiersz przetwarzany porcjami, żeby bufory współrzędnych zmieściły się na stosie (i w L1)
+    const int chunk = 256;
+    float xs[chunk], zs[chunk];
+    for (int start = 0; start < count; start += chunk) {
+        int n = (count - start < chunk) ? (count - start) : chunk;
+        for (int j = 0; j < n; ++j) {
+            xs[j] = (float)(start + j) * xStep + xStart;
+            zs[j] = z;
+        }
+        getHeightBatch(xs, zs, n, amplitude, frequency, outHeights + start, outNormals ? outNormals + start * 3 : nullptr);
+    }
+}
+
+void generateWavyGround(int segmentsX, int segmentsZ, float totalWidth, float totalDepth,
+    float waveAmplitude, float waveFrequency, float textureTiling,
+    std::vector<GLfloat>& outGroundVertices, std::vector<GLuint>& outGroundIndices, ThreadPool* pool)
+{
+    const int floatsPerVertex = 11;
+    const int verticesPerSegmentRow = segmentsX + 1;
+    const size_t floatsPerRow = (size_t)verticesPerSegmentRow * floatsPerVertex;
+    const size_t indicesPerRow = (size_t)segmentsX * 6;
+
+    // Rozmiary wyjścia znane z góry - każde pasmo pisze pod wyliczonym offsetem, bez push_back
+    outGroundVertices.resize(floatsPerRow * (segmentsZ + 1));
+    outGroundIndices.resize(indicesPerRow * segmentsZ);
+
+    float segmentWidth = totalWidth / segmentsX;
+    float segmentDepth = totalDepth / segmentsZ;
+    GLfloat* vertices = outGroundVertices.data();
+    GLuint* indices = outGroundIndices.data();
+
+    auto buildRows = [&](int rowBegin, int rowEnd) {
+        // Wysokości i analityczne normalne całego wiersza liczone wsadowo (SIMD)
+        std::vector<float> rowHeights(verticesPerSegmentRow);
+        std::vector<float> rowNormals(verticesPerSegmentRow * 3);
+        for (int i = rowBegin; i < rowEnd; ++i) {
+            float z = (float)i * segmentDepth - totalDepth * 0.5f;
+            getHeightRow(-totalWidth * 0.5f, segmentWidth, z, verticesPerSegmentRow, waveAmplitude, waveFrequency, rowHeights.data(), rowNormals.data());
+            GLfloat* v = vertices + i * floatsPerRow;
+            for (int j = 0; j <= segmentsX; ++j) {
+                float x = (float)j * segmentWidth - totalWidth * 0.5f;
+                const float* normal = &rowNormals[j * 3];
+                v[0] = x; v[1] = rowHeights[j]; v[2] = z;
+                v[3] = 1.0f; v[4] = 1.0f; v[5] = 1.0f; // Dummy color
+                v[6] = (float)j / segmentsX * textureTiling;
+                v[7] = (float)i / segmentsZ * textureTiling;
+                v[8] = normal[0]; v[9] = normal[1]; v[10] = normal[2];
+                v += floatsPerVertex;
+            }
+
+            // Wiersz czworokątów nad wierszem wierzchołków i
+            if (i < segmentsZ) {
+                GLuint* idx = indices + i * indicesPerRow;
+                for (int j = 0; j < segmentsX; ++j) {
+                    GLuint vertexIndex_BL = i * verticesPerSegmentRow + j;
+                    GLuint vertexIndex_BR = i * verticesPerSegmentRow + j + 1;
+                    GLuint vertexIndex_TL = (i + 1) * verticesPerSegmentRow + j;
+                    GLuint vertexIndex_TR = (i + 1) * verticesPerSegmentRow + j + 1;
+                    idx[0] = vertexIndex_BL; idx[1] = vertexIndex_BR; idx[2] = vertexIndex_TR;
+                    idx[3] = vertexIndex_BL; idx[4] = vertexIndex_TR; idx[5] = vertexIndex_TL;
+                    idx += 6;
+                }
+            }
+        }
+    };
+
+    if (pool) {
+        // Kilka pasm na wątek wyrównuje obciążenie, gdy wątki startują w różnym czasie
+        int bands = (int)(pool->Size() + 1) * 4;
+        int grain = (segmentsZ + 1 + bands - 1) / bands;
+        pool->ParallelFor(0, segmentsZ + 1, grain, buildRows);
+    }
+    else {
+        buildRows(0, segmentsZ + 1);
+    }
+    std::cout << "Generated Wavy Ground: " << outGroundVertices.size() / 11 << " vertices, " << outGroundIndices.size() / 3 << " triangles." << std::endl;
+}
@@ -0,0 +1,50 @@
+#ifndef TERRAIN_H
+#define TERRAIN_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+class ThreadPool;
+
+// Funkcja wysokości terenu: suma czterech oktaw sin/cos, znormalizowana przez sumę współczynników.
+float getHeight(float x, float z, float amplitude, float frequency);
+
+// Normalna z różnic skończonych (trzy wywołania getHeight) - pozostawiona dla zgodności
+glm::vec3 calculateNormal(float x, float z, float epsilon, float amplitude, float frequency);
+
+// Normalna analityczna - z pochodnej cząstkowej sumy oktaw (bez różnic skończonych)
+glm::vec3 calculateAnalyticNormal(float x, float z, float amplitude, float frequency);
+
+// Górne ograniczenia (max|d²h/dx²|, max|d²h/dz²|) po całej płaszczyźnie - do szacowania błędu interpolacji
+glm::vec2 heightCurvatureBound(float amplitude, float frequency);
+
+// --- Wsadowe obliczanie wysokości i normalnych (SIMD) ---
+
+enum class HeightSimdLevel { Scalar, SSE2, AVX2 };
+
+// Poziom SIMD wybierany raz przy pierwszym użyciu na podstawie CPUID
+HeightSimdLevel getHeightSimdLevel();
+// Wymuszenie ścieżki (np. porównanie z wersją skalarną); poziom wyższy niż wspierany przez CPU jest obniżany
+void setHeightSimdLevel(HeightSimdLevel level);
+const char* heightSimdLevelName(HeightSimdLevel level);
+
+// Wysokości i normalne dla count punktów (xs[i], zs[i]).
+// outHeights: count floatów; outNormals: count*3 floatów (nx, ny, nz) lub nullptr, jeśli normalne nie są potrzebne.
+void getHeightBatch(const float* xs, const float* zs, int count, float amplitude, float frequency,
+    float* outHeights, float* outNormals);
+
+// Jeden wiersz siatki: x_j = (float)j * xStep + xStart dla j w [0, count), stałe z.
+void getHeightRow(float xStart, float xStep, float z, int count, float amplitude, float frequency,
+    float* outHeights, float* outNormals);
+
+// --- Generowanie siatki terenu ---
+
+// Siatka (segmentsX+1) x (segmentsZ+1) wierzchołków po 11 floatów (pozycja, kolor, UV, normalna), wyśrodkowana w (0,0).
+// Z pulą wątków wiersze dzielone są na pasma zapisujące bezpośrednio do wstępnie zaalokowanych tablic
+// (bez realokacji i blokad); wynik jest bitowo identyczny z wersją jednowątkową (pool == nullptr).
+void generateWavyGround(int segmentsX, int segmentsZ, float totalWidth, float totalDepth,
+    float waveAmplitude, float waveFrequency, float textureTiling,
+    std::vector<GLfloat>& outGroundVertices, std::vector<GLuint>& outGroundIndices, ThreadPool* pool = nullptr);
+
+#endif
@@ -0,0 +1,198 @@
+#include "TerrainChunks.h"
+#include "GLState.h"
+#include "Terrain.h"
+#include "VAO.h"
+#include "EBO.h"
+#include <algorithm>
+#include <cmath>
+
+TerrainChunkManager::TerrainChunkManager(const TerrainChunkSettings& settings, ThreadPool& pool)
+    : settings(settings), pool(pool), generated(std::make_shared<GeneratedQueue>()),
+      residentBytes(0), centerX(0), centerZ(0)
+{
+}
+
+// Siatka kafla (cx, cz) w układzie świata. Współrzędne liczone z globalnego indeksu wierzchołka,
+// więc wspólne krawędzie sąsiednich kafli mają bitowo te same pozycje (brak szczelin).
+void TerrainChunkManager::GenerateChunk(const TerrainChunkSettings& settings, int cx, int cz, GeneratedChunk& out)
+{
+    const int segments = settings.segments;
+    const int verticesPerRow = segments + 1;
+    const float step = settings.chunkSize / segments;
+    const int baseX = cx * segments;
+    const int baseZ = cz * segments;
+
+    out.vertices.resize((size_t)verticesPerRow * verticesPerRow * 11);
+    out.indices.resize((size_t)segments * segments * 6);
+
+    std::vector<float> rowHeights(verticesPerRow);
+    std::vector<float> rowNormals(verticesPerRow * 3);
+    GLfloat* v = out.vertices.data();
+    for (int i = 0; i <= segments; ++i) {
+        float z = (float)(baseZ + i) * step;
+        getHeightRow((float)baseX * step, step, z, verticesPerRow, settings.waveAmplitude, settings.waveFrequency, rowHeights.data(), rowNormals.data());
+        for (int j = 0; j <= segments; ++j) {
+            v[0] = (float)(baseX + j) * step; v[1] = rowHeights[j]; v[2] = z;
+            v[3] = 1.0f; v[4] = 1.0f; v[5] = 1.0f; // Dummy color
+            v[6] = (float)(baseX + j) / segments * settings.textureTiling;
+            v[7] = (float)(baseZ + i) / segments * settings.textureTiling;
+            v[8] = rowNormals[j * 3]; v[9] = rowNormals[j * 3 + 1]; v[10] = rowNormals[j * 3 + 2];
+            v += 11;
+        }
+    }
+
+    GLuint* idx = out.indices.data();
+    for (int i = 0; i < segments; ++i) {
+        for (int j = 0; j < segments; ++j) {
+            GLuint bl = i * verticesPerRow + j;
+            GLuint br = bl + 1;
+            GLuint tl = bl + verticesPerRow;
+            GLuint tr = tl + 1;
+            idx[0] = bl; idx[1] = br; idx[2] = tr;
+            idx[3] = bl; idx[4] = tr; idx[5] = tl;
+            idx += 6;
+        }
+    }
+}
+
+void TerrainChunkManager::Update(const glm::vec3& cameraPosition)
+{
+    centerX = (int)std::floor(cameraPosition.x / settings.chunkSize);
+    centerZ = (int)std::floor(cameraPosition.z / settings.chunkSize);
+
+    // 1. Wyślij do GPU część gotowych kafli (limit na klatkę, żeby nie gubić klatek przy szybkim ruchu)
+    std::vector<GeneratedChunk> toUpload;
+    {
+        std::lock_guard<std::mutex> lock(generated->mutex);
+        int count = std::min((int)generated->chunks.size(), settings.maxUploadsPerFrame);
+        for (int i = 0; i < count; ++i) {
+            toUpload.push_back(std::move(generated->chunks[i]));
+        }
+        generated->chunks.erase(generated->chunks.begin(), generated->chunks.begin() + count);
+    }
+    for (auto& chunk : toUpload) {
+        pending.erase(chunk.key);
+        Upload(chunk);
+    }
+
+    // 2. Zwolnij kafle daleko poza widocznym obszarem
+    const int evictRadius = settings.viewRadius + settings.evictMargin;
+    std::vector<ChunkKey> farChunks;
+    for (const auto& entry : resident) {
+        if (std::abs(entry.second.cx - centerX) > evictRadius || std::abs(entry.second.cz - centerZ) > evictRadius) {
+            farChunks.push_back(entry.first);
+        }
+    }
+    for (ChunkKey key : farChunks) {
+        Evict(key);
+    }
+
+    // 3. Zleć generowanie brakujących kafli, zaczynając od najbliższych kamerze
+    std::vector<std::pair<int, glm::ivec2>> missing; // (odległość^2, współrzędne kafla)
+    for (int dz = -settings.viewRadius; dz <= settings.viewRadius; ++dz) {
+        for (int dx = -settings.viewRadius; dx <= settings.viewRadius; ++dx) {
+            ChunkKey key = MakeKey(centerX + dx, centerZ + dz);
+            if (resident.count(key) || pending.count(key)) continue;
+            missing.push_back(std::make_pair(dx * dx + dz * dz, glm::ivec2(centerX + dx, centerZ + dz)));
+        }
+    }
+    std::sort(missing.begin(), missing.end(),
+        [](const std::pair<int, glm::ivec2>& a, const std::pair<int, glm::ivec2>& b) { return a.first < b.first; });
+    for (const auto& entry : missing) {
+        if ((int)pending.size() >= settings.maxPendingChunks) break;
+        glm::ivec2 coord = entry.second;
+        ChunkKey key = MakeKey(coord.x, coord.y);
+        pending.insert(key);
+
+        std::shared_ptr<GeneratedQueue> queue = generated;
+        TerrainChunkSettings chunkSettings = settings;
+        pool.Submit([queue, chunkSettings, coord, key]() {
+            GeneratedChunk chunk;
+            chunk.key = key;
+            chunk.cx = coord.x;
+            chunk.cz = coord.y;
+            GenerateChunk(chunkSettings, coord.x, coord.y, chunk);
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            queue->chunks.push_back(std::move(chunk));
+        });
+    }
+
+    // 4. Utrzymaj budżet pamięci: zwalniaj najdawniej używane kafle (widoczne są odświeżane w Draw)
+    while (residentBytes > settings.memoryBudgetBytes && !lru.empty()) {
+        Evict(lru.back());
+    }
+}
+
+void TerrainChunkManager::Upload(GeneratedChunk& chunk)
+{
+    if (std::abs(chunk.cx - centerX) > settings.viewRadius + settings.evictMargin ||
+        std::abs(chunk.cz - centerZ) > settings.viewRadius + settings.evictMargin) {
+        return; // kamera zdążyła odjechać - kafel nie jest już potrzebny
+    }
+
+    VAO chunkVAO; chunkVAO.Bind();
+    VBO chunkVBO(chunk.vertices.data(), chunk.vertices.size() * sizeof(GLfloat));
+    EBO chunkEBO(chunk.indices.data(), chunk.indices.size() * sizeof(GLuint));
+    chunkVAO.LinkAttrib(chunkVBO, 0, 3, GL_FLOAT, 11 * sizeof(float), (void*)0); // aPos
+    chunkVAO.LinkAttrib(chunkVBO, 1, 3, GL_FLOAT, 11 * sizeof(float), (void*)(3 * sizeof(float))); // aColor
+    chunkVAO.LinkAttrib(chunkVBO, 2, 2, GL_FLOAT, 11 * sizeof(float), (void*)(6 * sizeof(float))); // aTex
+    chunkVAO.LinkAttrib(chunkVBO, 3, 3, GL_FLOAT, 11 * sizeof(float), (void*)(8 * sizeof(float))); // aNormal
+    chunkVAO.Unbind();
+
+    ResidentChunk entry;
+    entry.vao = chunkVAO.ID;
+    entry.vbo = chunkVBO.ID;
+    entry.ebo = chunkEBO.ID;
+    entry.indexCount = (GLsizei)chunk.indices.size();
+    entry.bytes = chunk.vertices.size() * sizeof(GLfloat) + chunk.indices.size() * sizeof(GLuint);
+    entry.cx = chunk.cx;
+    entry.cz = chunk.cz;
+    lru.push_front(chunk.key);
+    entry.lruPosition = lru.begin();
+    resident[chunk.key] = entry;
+    residentBytes += entry.bytes;
+}
+
+void TerrainChunkManager::Evict(ChunkKey key)
+{
+    auto it = resident.find(key);
+    if (it == resident.end()) return;
+    GLState::DeleteVertexArray(it->second.vao);
+    GLState::DeleteBuffer(it->second.vbo);
+    GLState::DeleteBuffer(it->second.ebo);
+    residentBytes -= it->second.bytes;
+    lru.erase(it->second.lruPosition);
+    resident.erase(it);
+}
+
+void TerrainChunkManager::Touch(ResidentChunk& chunk, ChunkKey key)
+{
+    lru.erase(chunk.lruPosition);
+    lru.push_front(key);
+    chunk.lruPosition = lru.begin();
+}
+
+void TerrainChunkManager::Draw(Shader& shader)
+{
+    // Wierzchołki kafli są już w układzie świata
+    shader.setMat4("model", glm::mat4(1.0f));
+    for (int dz = -settings.viewRadius; dz <= settings.viewRadius; ++dz) {
+        for (int dx = -settings.viewRadius; dx <= settings.viewRadius; ++dx) {
+            ChunkKey key = MakeKey(centerX + dx, centerZ + dz);
+            auto it = resident.find(key);
+            if (it == resident.end()) continue; // jeszcze się generuje
+            Touch(it->second, key);
+            GLState::BindVertexArray(it->second.vao);
+            GLState::DrawElements(GL_TRIANGLES, it->second.indexCount, GL_UNSIGNED_INT, 0);
+        }
+    }
+    GLState::BindVertexArray(0);
+}
+
+void TerrainChunkManager::Delete()
+{
+    while (!lru.empty()) {
+        Evict(lru.back());
+    }
+    pending.clear();
+}
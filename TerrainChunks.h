@@ -0,0 +1,92 @@
+#ifndef TERRAIN_CHUNKS_CLASS_H
+#define TERRAIN_CHUNKS_CLASS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
+#include <memory>
+#include <mutex>
+#include "shaderClass.h"
+#include "ThreadPool.h"
+
+struct TerrainChunkSettings
+{
+    float chunkSize = 6.0f;          // bok kafla w jednostkach świata
+    int segments = 60;               // segmentów siatki na bok kafla
+    int viewRadius = 4;              // promień (w kaflach) widocznego obszaru wokół kamery
+    int evictMargin = 2;             // kafle dalsze niż viewRadius + evictMargin są zwalniane od razu
+    float waveAmplitude = 0.25f;
+    float waveFrequency = 0.8f;
+    float textureTiling = 8.0f;      // powtórzeń tekstury na jeden kafel
+    size_t memoryBudgetBytes = 48u * 1024u * 1024u; // limit pamięci VBO/EBO kafli na GPU
+    int maxUploadsPerFrame = 4;      // ile gotowych kafli wysłać do GPU w jednej klatce
+    int maxPendingChunks = 16;       // ile kafli może się jednocześnie generować w tle
+};
+
+// Nieskończony teren dzielony na kafle generowane w tle wokół kamery.
+// Kafle rezydentne na GPU trzymane są w pamięci podręcznej LRU ograniczonej budżetem pamięci.
+class TerrainChunkManager
+{
+public:
+    TerrainChunkManager(const TerrainChunkSettings& settings, ThreadPool& pool);
+
+    // Zleca generowanie brakujących kafli wokół kamery, wysyła gotowe do GPU i zwalnia dalekie
+    void Update(const glm::vec3& cameraPosition);
+    // Rysuje widoczne kafle; shader (default.vert/frag) z ustawionymi uniformami i tekstura muszą być zbindowane zewnętrznie
+    void Draw(Shader& shader);
+    void Delete();
+
+    size_t ResidentBytes() const { return residentBytes; }
+    int ResidentCount() const { return (int)resident.size(); }
+
+private:
+    typedef long long ChunkKey;
+
+    struct ResidentChunk
+    {
+        GLuint vao, vbo, ebo;
+        GLsizei indexCount;
+        size_t bytes;
+        int cx, cz;
+        std::list<ChunkKey>::iterator lruPosition;
+    };
+
+    // Kafel wygenerowany na wątku roboczym, czekający na wysłanie do GPU (w wątku GL)
+    struct GeneratedChunk
+    {
+        ChunkKey key;
+        int cx, cz;
+        std::vector<GLfloat> vertices;
+        std::vector<GLuint> indices;
+    };
+
+    // Kolejka gotowych kafli współdzielona z zadaniami puli (przeżywa menedżera, jeśli zadania jeszcze trwają)
+    struct GeneratedQueue
+    {
+        std::mutex mutex;
+        std::vector<GeneratedChunk> chunks;
+    };
+
+    TerrainChunkSettings settings;
+    ThreadPool& pool;
+    std::shared_ptr<GeneratedQueue> generated;
+    std::unordered_map<ChunkKey, ResidentChunk> resident;
+    std::unordered_set<ChunkKey> pending;
+    std::list<ChunkKey> lru; // przód = ostatnio używane
+    size_t residentBytes;
+    int centerX, centerZ;
+
+    // Przesunięcie na wartościach bez znaku - ujemne cx nie daje niezdefiniowanego przesunięcia w lewo
+    static ChunkKey MakeKey(int cx, int cz) { return (ChunkKey)(((uint64_t)(uint32_t)cx << 32) | (uint32_t)cz); }
+    static void GenerateChunk(const TerrainChunkSettings& settings, int cx, int cz, GeneratedChunk& out);
+
+    void Upload(GeneratedChunk& chunk);
+    void Evict(ChunkKey key);
+    void Touch(ResidentChunk& chunk, ChunkKey key);
+};
+
+#endif
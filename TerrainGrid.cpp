@@ -0,0 +1,61 @@
+#include "TerrainGrid.h"
+#include "GLState.h"
+#include "VAO.h"
+#include "EBO.h"
+#include <vector>
+
+TerrainGrid::TerrainGrid(int segments)
+{
+    std::vector<GLfloat> gridVertices;
+    std::vector<GLuint> gridIndices;
+    gridVertices.reserve((size_t)(segments + 1) * (segments + 1) * 2);
+    gridIndices.reserve((size_t)segments * segments * 6);
+    for (int i = 0; i <= segments; ++i) {
+        for (int j = 0; j <= segments; ++j) {
+            gridVertices.push_back((float)j / segments);
+            gridVertices.push_back((float)i / segments);
+        }
+    }
+    int verticesPerSegmentRow = segments + 1;
+    for (int i = 0; i < segments; ++i) {
+        for (int j = 0; j < segments; ++j) {
+            GLuint bl = i * verticesPerSegmentRow + j;
+            GLuint br = bl + 1;
+            GLuint tl = bl + verticesPerSegmentRow;
+            GLuint tr = tl + 1;
+            gridIndices.push_back(bl); gridIndices.push_back(br); gridIndices.push_back(tr);
+            gridIndices.push_back(bl); gridIndices.push_back(tr); gridIndices.push_back(tl);
+        }
+    }
+    indexCount = (GLsizei)gridIndices.size();
+    vertexBytes = gridVertices.size() * sizeof(GLfloat);
+
+    VAO gridVAO; gridVAO.Bind();
+    VBO gridVBO(gridVertices.data(), gridVertices.size() * sizeof(GLfloat));
+    EBO gridEBO(gridIndices.data(), gridIndices.size() * sizeof(GLuint));
+    gridVAO.LinkAttrib(gridVBO, 0, 2, GL_FLOAT, 2 * sizeof(float), (void*)0); // aGrid
+    gridVAO.Unbind();
+    vao = gridVAO.ID;
+    vbo = gridVBO.ID;
+    ebo = gridEBO.ID;
+}
+
+void TerrainGrid::Draw(Shader& shader, const glm::vec2& origin, float size, float waveAmplitude, float waveFrequency, float texScale)
+{
+    shader.setFloat("u_waveAmplitude", waveAmplitude);
+    shader.setFloat("u_waveFrequency", waveFrequency);
+    shader.setFloat("u_texScale", texScale);
+
+    GLState::BindVertexArray(vao);
+    // aNode (lokacja 4) nie ma tu tablicy - stała wartość atrybutu: jeden węzeł, poziom -1 = bez morphingu
+    glVertexAttrib4f(4, origin.x, origin.y, size, -1.0f);
+    GLState::DrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
+    GLState::BindVertexArray(0);
+}
+
+void TerrainGrid::Delete()
+{
+    GLState::DeleteVertexArray(vao);
+    GLState::DeleteBuffer(vbo);
+    GLState::DeleteBuffer(ebo);
+}
@@ -0,0 +1,30 @@
+#ifndef TERRAIN_GRID_CLASS_H
+#define TERRAIN_GRID_CLASS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "shaderClass.h"
+
+// Teren przesuwany na GPU: VBO zawiera tylko współdzieloną siatkę 2D (vec2 na wierzchołek),
+// a terrain.vert liczy wysokość i analityczną normalną z uniformów amplitudy, częstotliwości i kafelkowania.
+// Zmiana parametrów fali nie wymaga ponownego generowania ani wysyłania danych.
+class TerrainGrid
+{
+public:
+    // Kwadratowa siatka segments x segments
+    TerrainGrid(int segments);
+
+    // Rysuje kwadrat o boku size z rogiem w origin (XZ świata); shader terrain.vert/default.frag musi być aktywny
+    void Draw(Shader& shader, const glm::vec2& origin, float size, float waveAmplitude, float waveFrequency, float texScale);
+    void Delete();
+
+    // Rozmiar danych wierzchołków na GPU (dla porównania z siatką CPU po 11 floatów)
+    size_t VertexBytes() const { return vertexBytes; }
+
+private:
+    GLuint vao, vbo, ebo;
+    GLsizei indexCount;
+    size_t vertexBytes;
+};
+
+#endif
@@ -0,0 +1,194 @@
+#include "TerrainLOD.h"
+#include "GLState.h"
+#include "VAO.h"
+#include "EBO.h"
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+    TerrainLODSettings clampLevels(TerrainLODSettings settings)
+    {
+        const int levelCount = std::min(std::max(settings.levelCount, 1), (int)TerrainLOD::kMaxLevels);
+        if (levelCount != settings.levelCount) {
+            std::cerr << "TerrainLOD: levelCount " << settings.levelCount << " poza zakresem 1.." << (int)TerrainLOD::kMaxLevels
+                      << ", użyto " << levelCount << std::endl;
+            settings.levelCount = levelCount;
+        }
+        return settings;
+    }
+}
+
+TerrainLOD::TerrainLOD(const TerrainLODSettings& requested)
+    : settings(clampLevels(requested)), cameraPosition(0.0f)
+{
+    // Zasięgi poziomów i strefy morphingu: poziom L przechodzi w siatkę L+1 tuż przed granicą swojego zasięgu
+    float range = settings.leafNodeSize * settings.lodDistanceRatio;
+    float previousRange = 0.0f;
+    for (int level = 0; level < settings.levelCount; ++level) {
+        lodRanges.push_back(range);
+        float morphStart = previousRange + (range - previousRange) * settings.morphStartRatio;
+        morphConsts.push_back(glm::vec2(morphStart, range));
+        previousRange = range;
+        range *= 2.0f;
+    }
+
+    // Wspólna siatka ćwiartki węzła: (gridDim/2 + 1)^2 wierzchołków vec2 w [0,1]
+    const int patchDim = settings.gridDim / 2;
+    std::vector<GLfloat> gridVertices;
+    std::vector<GLuint> gridIndices;
+    for (int i = 0; i <= patchDim; ++i) {
+        for (int j = 0; j <= patchDim; ++j) {
+            gridVertices.push_back((float)j / patchDim);
+            gridVertices.push_back((float)i / patchDim);
+        }
+    }
+    for (int i = 0; i < patchDim; ++i) {
+        for (int j = 0; j < patchDim; ++j) {
+            GLuint bl = i * (patchDim + 1) + j;
+            GLuint br = bl + 1;
+            GLuint tl = bl + patchDim + 1;
+            GLuint tr = tl + 1;
+            gridIndices.push_back(bl); gridIndices.push_back(br); gridIndices.push_back(tr);
+            gridIndices.push_back(bl); gridIndices.push_back(tr); gridIndices.push_back(tl);
+        }
+    }
+    patchIndexCount = (GLsizei)gridIndices.size();
+
+    VAO vao; vao.Bind();
+    VBO gridVBO(gridVertices.data(), gridVertices.size() * sizeof(GLfloat));
+    EBO gridEBO(gridIndices.data(), gridIndices.size() * sizeof(GLuint));
+    vao.LinkAttrib(gridVBO, 0, 2, GL_FLOAT, 2 * sizeof(float), (void*)0); // aGrid
+    VBO nodeVBO(nullptr, 0, GL_STREAM_DRAW);
+    vao.LinkAttribInstanced(nodeVBO, 4, 4, GL_FLOAT, sizeof(glm::vec4), (void*)0, 1); // aNode
+    vao.Unbind();
+
+    patchVAO = vao.ID;
+    patchVBO = gridVBO.ID;
+    patchEBO = gridEBO.ID;
+    instanceVBO = nodeVBO.ID;
+}
+
+bool TerrainLOD::NodeInFrustum(float x, float z, float size) const
+{
+    // AABB węzła: wysokość ograniczona amplitudą funkcji terenu
+    glm::vec3 minCorner(x, -settings.waveAmplitude, z);
+    glm::vec3 maxCorner(x + size, settings.waveAmplitude, z + size);
+    for (int i = 0; i < 6; ++i) {
+        const glm::vec4& p = frustumPlanes[i];
+        glm::vec3 positive(p.x >= 0.0f ? maxCorner.x : minCorner.x,
+                           p.y >= 0.0f ? maxCorner.y : minCorner.y,
+                           p.z >= 0.0f ? maxCorner.z : minCorner.z);
+        if (p.x * positive.x + p.y * positive.y + p.z * positive.z + p.w < 0.0f) return false;
+    }
+    return true;
+}
+
+bool TerrainLOD::NodeInRange(float x, float z, float size, float range) const
+{
+    // Odległość kamery od AABB węzła porównana z zasięgiem poziomu
+    float dx = std::max(std::max(x - cameraPosition.x, cameraPosition.x - (x + size)), 0.0f);
+    float dz = std::max(std::max(z - cameraPosition.z, cameraPosition.z - (z + size)), 0.0f);
+    float dy = std::max(std::fabs(cameraPosition.y) - settings.waveAmplitude, 0.0f);
+    return dx * dx + dy * dy + dz * dz <= range * range;
+}
+
+void TerrainLOD::AddQuadrant(float x, float z, float size, int level)
+{
+    if (NodeInFrustum(x, z, size)) {
+        instances.push_back(glm::vec4(x, z, size, (float)level));
+    }
+}
+
+// Klasyczny wybór CDLOD: węzeł poza zasięgiem swojego poziomu zostawia obszar rodzicowi (false),
+// a ćwiartki, których dzieci nie są w zasięgu poziomu niżej, rysuje sam.
+bool TerrainLOD::SelectNode(float x, float z, float size, int level)
+{
+    if (!NodeInRange(x, z, size, lodRanges[level])) return false;
+    if (!NodeInFrustum(x, z, size)) return true; // w zasięgu, ale niewidoczny - nic do rysowania
+
+    float half = size * 0.5f;
+    if (level == 0 || !NodeInRange(x, z, size, lodRanges[level - 1])) {
+        AddQuadrant(x, z, half, level);
+        AddQuadrant(x + half, z, half, level);
+        AddQuadrant(x, z + half, half, level);
+        AddQuadrant(x + half, z + half, half, level);
+        return true;
+    }
+    for (int q = 0; q < 4; ++q) {
+        float cx = x + (q & 1) * half;
+        float cz = z + (q >> 1) * half;
+        if (!SelectNode(cx, cz, half, level - 1)) {
+            AddQuadrant(cx, cz, half, level);
+        }
+    }
+    return true;
+}
+
+void TerrainLOD::Update(const glm::vec3& position, const glm::mat4& camMatrix)
+{
+    cameraPosition = position;
+
+    // Płaszczyzny frustum z macierzy projekcja*widok (metoda Gribba-Hartmanna)
+    for (int i = 0; i < 3; ++i) {
+        glm::vec4 row3(camMatrix[0][3], camMatrix[1][3], camMatrix[2][3], camMatrix[3][3]);
+        glm::vec4 row(camMatrix[0][i], camMatrix[1][i], camMatrix[2][i], camMatrix[3][i]);
+        frustumPlanes[i * 2] = row3 + row;
+        frustumPlanes[i * 2 + 1] = row3 - row;
+    }
+
+    // Korzenie 2x2 przyciągnięte do siatki korzeni, tak by kamera była zawsze w środkowej części
+    instances.clear();
+    const int top = settings.levelCount - 1;
+    const float rootSize = settings.leafNodeSize * std::pow(2.0f, (float)top);
+    float originX = (std::floor(position.x / rootSize + 0.5f) - 1.0f) * rootSize;
+    float originZ = (std::floor(position.z / rootSize + 0.5f) - 1.0f) * rootSize;
+    for (int rz = 0; rz < 2; ++rz) {
+        for (int rx = 0; rx < 2; ++rx) {
+            float x = originX + rx * rootSize;
+            float z = originZ + rz * rootSize;
+            if (!SelectNode(x, z, rootSize, top)) {
+                // Poza zasięgiem najwyższego poziomu - rysuj korzeń w najgrubszej rozdzielczości
+                float half = rootSize * 0.5f;
+                AddQuadrant(x, z, half, top);
+                AddQuadrant(x + half, z, half, top);
+                AddQuadrant(x, z + half, half, top);
+                AddQuadrant(x + half, z + half, half, top);
+            }
+        }
+    }
+
+    GLState::BindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(glm::vec4), instances.empty() ? nullptr : instances.data(), GL_STREAM_DRAW);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void TerrainLOD::Draw(Shader& shader)
+{
+    if (instances.empty()) return;
+    shader.setFloat("u_waveAmplitude", settings.waveAmplitude);
+    shader.setFloat("u_waveFrequency", settings.waveFrequency);
+    shader.setFloat("u_texScale", settings.textureTiling / settings.textureWorldSize);
+    shader.setFloat("u_gridDim", (float)(settings.gridDim / 2));
+    // Cała tablica jednym glUniform2fv - bez składania nazw "u_morphConsts[i]" w każdej klatce
+    shader.Uniform<glm::vec2>("u_morphConsts").Set(morphConsts.data(), (GLsizei)morphConsts.size());
+
+    GLState::BindVertexArray(patchVAO);
+    GLState::DrawElementsInstanced(GL_TRIANGLES, patchIndexCount, GL_UNSIGNED_INT, 0, (GLsizei)instances.size());
+    GLState::BindVertexArray(0);
+}
+
+void TerrainLOD::SetWaveParameters(float waveAmplitude, float waveFrequency)
+{
+    settings.waveAmplitude = waveAmplitude;
+    settings.waveFrequency = waveFrequency;
+}
+
+void TerrainLOD::Delete()
+{
+    GLState::DeleteVertexArray(patchVAO);
+    GLState::DeleteBuffer(patchVBO);
+    GLState::DeleteBuffer(patchEBO);
+    GLState::DeleteBuffer(instanceVBO);
+}
@@ -0,0 +1,64 @@
+#ifndef TERRAIN_LOD_CLASS_H
+#define TERRAIN_LOD_CLASS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include "shaderClass.h"
+
+struct TerrainLODSettings
+{
+    float leafNodeSize = 3.0f;      // bok najdrobniejszego węzła drzewa czwórkowego
+    int levelCount = 8;             // liczba poziomów LOD, 1..TerrainLOD::kMaxLevels (korzeń ma bok leafNodeSize * 2^(levelCount-1))
+    int gridDim = 32;               // czworokątów na bok węzła (wielokrotność 4); rysowana ćwiartka ma gridDim/2
+    float lodDistanceRatio = 2.0f;  // zasięg poziomu 0 = leafNodeSize * lodDistanceRatio, każdy następny x2
+    float morphStartRatio = 0.66f;  // w jakiej części strefy poziomu zaczyna się przejście do rzadszej siatki
+    float waveAmplitude = 0.25f;
+    float waveFrequency = 0.8f;
+    float textureTiling = 8.0f;     // powtórzeń tekstury na textureWorldSize jednostek świata
+    float textureWorldSize = 6.0f;
+};
+
+// Teren CDLOD (Continuous Distance-Dependent LOD): drzewo czwórkowe wybierane co klatkę według odległości
+// od kamery, jedna wspólna siatka rysowana instancyjnie dla wszystkich wybranych ćwiartek węzłów,
+// a wierzchołki płynnie przechodzą (morphing) do siatki poziomu wyżej, więc nie ma przeskoków LOD.
+// Wysokość i normalna liczone są w terrain.vert, liczba trójkątów nie zależy od rozmiaru świata.
+class TerrainLOD
+{
+public:
+    // Rozmiar tablicy u_morphConsts w terrain.vert - wstrzykiwany do shadera jako TERRAIN_MAX_LEVELS
+    static const int kMaxLevels = 16;
+
+    // levelCount spoza 1..kMaxLevels jest przycinany (z komunikatem)
+    TerrainLOD(const TerrainLODSettings& settings);
+
+    // Wybiera węzły dla bieżącej kamery (z odrzucaniem poza frustum) i wysyła instancje do GPU
+    void Update(const glm::vec3& cameraPosition, const glm::mat4& camMatrix);
+    // Rysuje teren; shader terrain.vert/default.frag musi być aktywny z ustawionymi uniformami światła i kamery
+    void Draw(Shader& shader);
+    void Delete();
+
+    // Parametry fali zmieniane w locie (wysokość liczona jest w shaderze, nic nie trzeba generować ponownie)
+    void SetWaveParameters(float waveAmplitude, float waveFrequency);
+
+    int SelectedNodeCount() const { return (int)instances.size(); }
+    int TriangleCount() const { return (int)instances.size() * patchIndexCount / 3; }
+
+private:
+    TerrainLODSettings settings;
+    std::vector<float> lodRanges;       // zasięg każdego poziomu
+    std::vector<glm::vec2> morphConsts; // początek/koniec strefy morphingu każdego poziomu
+    std::vector<glm::vec4> instances;   // (rogX, rogZ, bok, poziom) wybranych ćwiartek węzłów
+    glm::vec4 frustumPlanes[6];
+    glm::vec3 cameraPosition;
+
+    GLuint patchVAO, patchVBO, patchEBO, instanceVBO;
+    GLsizei patchIndexCount;
+
+    bool SelectNode(float x, float z, float size, int level);
+    void AddQuadrant(float x, float z, float size, int level);
+    bool NodeInFrustum(float x, float z, float size) const;
+    bool NodeInRange(float x, float z, float size, float range) const;
+};
+
+#endif
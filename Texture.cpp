@@ -1,4 +1,6 @@
 #include "Texture.h"
+#include "GLState.h"
+#include "TextureLoader.h"
 #include <iostream>
 
 #define STB_IMAGE_IMPLEMENTATION
@@ -9,6 +11,7 @@ Texture::Texture(const char* image, GLenum texType, GLuint slot, GLenum format,
     type = texType;
     unit = slot; //zapisanie jednostki teksturujcej
     ID = 0;      //inicjowanie ID na 0
+    resident = false;
 
     int widthImg, heightImg, numColCh;
     stbi_set_flip_vertically_on_load(true); //odwrocenie obrazka - standard dla opengl
@@ -26,8 +29,7 @@ Texture::Texture(const char* image, GLenum texType, GLuint slot, GLenum format,
     }
 
     glGenTextures(1, &ID);
-    glActiveTexture(GL_TEXTURE0 + unit); //aktywowanie jednostki teksturujcej
-    glBindTexture(texType, ID);
+    GLState::BindTexture(unit, texType, ID); //aktywowanie jednostki i bind przez cache stanu
 
     //parametry owijania i teksturowania
     glTexParameteri(texType, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -40,7 +42,21 @@ Texture::Texture(const char* image, GLenum texType, GLuint slot, GLenum format,
     glGenerateMipmap(texType); //generowanie mipmapy
 
     stbi_image_free(bytes);    //zwolnienie pamieci obrazu
-    glBindTexture(texType, 0);
+    GLState::BindTexture(unit, texType, 0);
+    resident = true;
+}
+
+Texture::Texture(TextureLoader& loader, const char* image, GLenum texType, GLuint slot, GLenum pixelType)
+{
+    type = texType;
+    unit = slot;
+    ID = 0;
+    resident = false;
+
+    //placeholder 1x1 (neutralny szary) - rysowany, dopoki loader nie wysle pelnego obrazu
+    ID = TextureLoader::CreatePlaceholder(texType, unit, 1);
+
+    loader.Submit(this, image, pixelType);
 }
 
 void Texture::texUnit(Shader& shader, const char* uniform)
@@ -49,9 +65,9 @@ void Texture::texUnit(Shader& shader, const char* uniform)
         std::cerr << "wywolanie texUnit na nieprawidlowym obiekcie tekstury (ID=0)" << std::endl;
         return;
     }
-    shader.Activate(); //aktywowanie shadera przed ustawieniami uniformu
-    //pobranie lokalizacji uniformu samplera
-    GLint texUniLoc = glGetUniformLocation(shader.ID, uniform);
+    //shader musi byc juz aktywny - bez ponownego glUseProgram w kazdej klatce
+    //lokalizacja z pamieci podrecznej shadera (bez glGetUniformLocation)
+    GLint texUniLoc = shader.UniformLocation(uniform);
     if (texUniLoc == -1) {
         std::cerr << "uniform sampler2D '" << uniform << "' nie znaleziony w shaderze (ID: " << shader.ID << ")!" << std::endl;
     }
@@ -62,19 +78,18 @@ void Texture::texUnit(Shader& shader, const char* uniform)
 void Texture::Bind()
 {
     if (ID == 0) return;
-    glActiveTexture(GL_TEXTURE0 + unit); //aktywowanie przypisanej jednostki sterujcej
-    glBindTexture(type, ID);
+    GLState::BindTexture(unit, type, ID); //pomijane, gdy ta tekstura jest juz na swojej jednostce
 }
 
 void Texture::Unbind()
 {
     if (ID == 0) return;
-    glBindTexture(type, 0);
+    GLState::BindTexture(unit, type, 0);
 }
 
 void Texture::Delete()
 {
     if (ID == 0) return;
-    glDeleteTextures(1, &ID);
+    GLState::DeleteTexture(ID);
     ID = 0;
 }
\ No newline at end of file
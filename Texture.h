@@ -6,6 +6,8 @@
 #include <string>
 // stb_image.h w Texture.cpp
 
+class TextureLoader;
+
 class Texture
 {
 public:
@@ -20,8 +22,14 @@ public:
     //format: format danych obrazu (np. GL_RGBA)
     //pixelType: typ danych pikseli (np. GL_UNSIGNED_BYTE)
     Texture(const char* image, GLenum texType, GLuint slot, GLenum format, GLenum pixelType);
+    //Konstruktor asynchroniczny: od razu placeholder 1x1, obraz dekodowany i wysylany przez loader (TextureLoader::Poll),
+    //zawsze jako RGBA (loader sam wybiera format w GPU) - stad brak parametru format
+    Texture(TextureLoader& loader, const char* image, GLenum texType, GLuint slot, GLenum pixelType);
+
+    //czy ID wskazuje juz pelny obraz (a nie placeholder)
+    bool IsResident() const { return resident; }
 
-    //ustawia uniform samplera w shaderze
+    //ustawia uniform samplera w shaderze (shader musi byc aktywny)
     void texUnit(Shader& shader, const char* uniform);
     //aktywuje jednostk teksturujc i binduje tekstur
     void Bind();
@@ -29,6 +37,10 @@ public:
     void Unbind();
     //usuwa tekstur
     void Delete();
+
+private:
+    friend class TextureLoader;
+    bool resident;
 };
 
 #endif
\ No newline at end of file
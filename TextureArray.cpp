@@ -0,0 +1,44 @@
+#include "TextureArray.h"
+#include "TextureLoader.h"
+#include "GLState.h"
+#include <algorithm>
+#include <iostream>
+
+#include "stb_image.h" // implementacja w Texture.cpp
+
+TextureArray::TextureArray(TextureLoader& loader, const std::vector<std::string>& files, GLuint slot)
+    : ID(0), unit(slot), layerCount((int)files.size()), layerWidth(0), layerHeight(0), resident(false)
+{
+    // Sam nagłówek pliku (stbi_info) - wymiary znane przed dekodowaniem, więc warstwy skaluje już wątek puli
+    for (const std::string& file : files) {
+        int width = 0;
+        int height = 0;
+        int channels = 0;
+        if (!stbi_info(file.c_str(), &width, &height, &channels)) continue; // błąd zgłosi loader, warstwa będzie szara
+        layerWidth = layerWidth == 0 ? width : std::min(layerWidth, width);
+        layerHeight = layerHeight == 0 ? height : std::min(layerHeight, height);
+    }
+    // Wielokrotność bloku BC 4x4 - poziom 0 bez bloków dopełnianych krawędzią
+    if (layerWidth >= 4) layerWidth = layerWidth / 4 * 4;
+    if (layerHeight >= 4) layerHeight = layerHeight / 4 * 4;
+    layerWidth = std::max(layerWidth, 1);
+    layerHeight = std::max(layerHeight, 1);
+    std::cout << "Tablica tekstur: " << layerCount << " warstw " << layerWidth << "x" << layerHeight << std::endl;
+
+    // Placeholder: 1x1 na każdą warstwę - indeksy warstw w shaderach są poprawne od pierwszej klatki
+    ID = TextureLoader::CreatePlaceholder(GL_TEXTURE_2D_ARRAY, unit, (GLsizei)layerCount);
+    loader.SubmitArray(this, files, layerWidth, layerHeight);
+}
+
+void TextureArray::Bind()
+{
+    if (ID == 0) return;
+    GLState::BindTexture(unit, GL_TEXTURE_2D_ARRAY, ID);
+}
+
+void TextureArray::Delete()
+{
+    // Obiekt w trakcie wysyłania usuwa loader (ID == 0)
+    if (ID) GLState::DeleteTexture(ID);
+    ID = 0;
+}
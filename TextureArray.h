@@ -0,0 +1,44 @@
+#ifndef TEXTURE_ARRAY_CLASS_H
+#define TEXTURE_ARRAY_CLASS_H
+
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+
+class TextureLoader;
+
+// Materiały sceny jako warstwy jednej tekstury GL_TEXTURE_2D_ARRAY na jednej jednostce:
+// shader wybiera warstwę indeksem (u_layer w default.frag), więc rysowanie różnych materiałów nie zmienia bindingów.
+//  - rozmiar warstwy to najmniejsza szerokość i wysokość spośród źródeł (z nagłówków plików) - źródła są tylko
+//    pomniejszane, nigdy powiększane,
+//  - dekodowanie, kompresja BC1/BC3 przez TextureCache i wysyłanie przez pierścień PBO odbywa się w TextureLoader,
+//    jak dla Texture; do końca ID wskazuje szary placeholder 1x1 z tą samą liczbą warstw.
+// Wywołania GL: konstruktor (placeholder), Bind i Delete; resztę robi loader w Poll/Finish.
+class TextureArray
+{
+public:
+    GLuint ID;
+    GLuint unit;
+
+    // files: indeks warstwy = pozycja na liście
+    TextureArray(TextureLoader& loader, const std::vector<std::string>& files, GLuint slot);
+
+    bool IsResident() const { return resident; }
+    int LayerCount() const { return layerCount; }
+    int LayerWidth() const { return layerWidth; }
+    int LayerHeight() const { return layerHeight; }
+
+    // aktywuje jednostkę teksturującą i binduje tablicę
+    void Bind();
+    void Delete();
+
+private:
+    friend class TextureLoader;
+
+    int layerCount;
+    int layerWidth;
+    int layerHeight;
+    bool resident;
+};
+
+#endif
@@ -0,0 +1,265 @@
+#include "TextureCache.h"
+#include "FileUtils.h"
+#include "BlockCompression.h"
+#include "GLExtensions.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+#include "stb_image.h" // implementacja w Texture.cpp
+
+namespace
+{
+    // Zmiana układu pliku albo kodera wymaga podbicia wersji - stare pliki zostaną odrzucone
+    const uint32_t kTextureCacheVersion = 1;
+    const char kTextureCacheMagic[4] = { 'G', 'K', 'T', 'X' };
+
+    struct TextureCacheHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint64_t key;
+        uint32_t format;
+        uint32_t width;
+        uint32_t height;
+        uint32_t levelCount;
+        uint64_t dataOffset;
+        uint64_t payloadChecksum; // tabela poziomów i bloki - od końca nagłówka do końca pliku
+    };
+    static_assert(sizeof(TextureCacheHeader) % 16 == 0, "TextureCacheHeader musi mieć rozmiar wielokrotności 16 B");
+
+    struct TextureCacheLevel
+    {
+        uint32_t width;
+        uint32_t height;
+        uint64_t offset; // względem dataOffset
+        uint64_t size;
+    };
+
+    struct StbiFree
+    {
+        void operator()(unsigned char* pixels) const { stbi_image_free(pixels); }
+    };
+}
+
+TextureCache::TextureCache(const std::string& cacheDirectory)
+    : directory(cacheDirectory), directoryReady(false), hits(0), misses(0)
+{
+    directoryReady = makeDirectory(directory);
+    if (!directoryReady) {
+        std::cerr << "TextureCache: nie można utworzyć katalogu " << directory << " - tekstury będą kodowane przy każdym starcie" << std::endl;
+    }
+}
+
+std::string TextureCache::PathFor(uint64_t key) const
+{
+    char hex[17];
+    for (int i = 0; i < 16; ++i) {
+        hex[i] = "0123456789abcdef"[(key >> (60 - i * 4)) & 0xF];
+    }
+    hex[16] = '\0';
+    return directory + "/texture_" + hex + ".gktx";
+}
+
+bool TextureCache::Load(uint64_t key, CompressedImage& out)
+{
+    std::string path = PathFor(key);
+    if (!out.file.Open(path)) return false;
+
+    const unsigned char* bytes = out.file.Data();
+    const size_t fileSize = out.file.Size();
+    TextureCacheHeader header;
+    bool valid = fileSize >= sizeof(header);
+    if (valid) {
+        std::memcpy(&header, bytes, sizeof(header));
+        valid = std::memcmp(header.magic, kTextureCacheMagic, sizeof(kTextureCacheMagic)) == 0
+            && header.version == kTextureCacheVersion
+            && header.key == key
+            && (header.format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT || header.format == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT)
+            && header.levelCount > 0 && header.levelCount <= 32
+            && header.dataOffset >= sizeof(header) + (uint64_t)header.levelCount * sizeof(TextureCacheLevel)
+            && header.dataOffset <= fileSize;
+    }
+    if (valid) {
+        valid = fnv1a(kFnvOffset, bytes + sizeof(header), fileSize - sizeof(header)) == header.payloadChecksum;
+    }
+    if (valid) {
+        const size_t blockBytes = header.format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT ? kBC1BlockBytes : kBC3BlockBytes;
+        out.levels.resize(header.levelCount);
+        for (uint32_t i = 0; i < header.levelCount && valid; ++i) {
+            TextureCacheLevel level;
+            std::memcpy(&level, bytes + sizeof(header) + i * sizeof(level), sizeof(level)); // tabela może nie być wyrównana
+            valid = level.size == compressedLevelSize(blockBytes, (int)level.width, (int)level.height)
+                && header.dataOffset + level.offset + level.size <= fileSize;
+            if (valid) {
+                CompressedLevel& target = out.levels[i];
+                target.width = (int)level.width;
+                target.height = (int)level.height;
+                target.data = bytes + header.dataOffset + level.offset;
+                target.size = (size_t)level.size;
+            }
+        }
+    }
+    if (!valid) {
+        out.levels.clear();
+        out.file.Close();
+        std::remove(path.c_str());
+        std::cout << "TextureCache: odrzucono uszkodzony lub nieaktualny plik " << path << std::endl;
+        return false;
+    }
+
+    out.format = (GLenum)header.format;
+    out.width = (int)header.width;
+    out.height = (int)header.height;
+    out.fromCache = true;
+    return true;
+}
+
+bool TextureCache::Build(const unsigned char* encoded, size_t encodedSize, int targetWidth, int targetHeight, CompressedImage& out, std::string& failure)
+{
+    // Flaga globalna stb należy do wątku głównego (Texture) - wątek ustawia własną
+    stbi_set_flip_vertically_on_load_thread(1);
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    std::unique_ptr<unsigned char, StbiFree> pixels(stbi_load_from_memory(encoded, (int)encodedSize, &width, &height, &channels, 4));
+    if (!pixels) {
+        const char* reason = stbi_failure_reason();
+        failure = reason ? reason : "nieznany";
+        return false;
+    }
+    if (targetWidth > 0 && targetHeight > 0 && (targetWidth != width || targetHeight != height)) {
+        std::vector<unsigned char> resampled;
+        resampleRGBA8(pixels.get(), width, height, targetWidth, targetHeight, resampled);
+        Encode(resampled.data(), targetWidth, targetHeight, out);
+    }
+    else {
+        Encode(pixels.get(), width, height, out);
+    }
+    return true;
+}
+
+void TextureCache::Encode(const unsigned char* rgba, int width, int height, CompressedImage& out)
+{
+    const bool translucent = hasTranslucentTexels(rgba, width, height);
+    const size_t blockBytes = translucent ? kBC3BlockBytes : kBC1BlockBytes;
+    out.format = translucent ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    out.width = width;
+    out.height = height;
+    out.levels.clear();
+
+    // Układ poziomów (aż do 1x1), potem kodowanie - poziom n + 1 liczony z nieskompresowanego poziomu n
+    std::vector<size_t> offsets;
+    size_t totalSize = 0;
+    for (int levelWidth = width, levelHeight = height; ; levelWidth = std::max(1, levelWidth / 2), levelHeight = std::max(1, levelHeight / 2)) {
+        CompressedLevel level = { levelWidth, levelHeight, nullptr, compressedLevelSize(blockBytes, levelWidth, levelHeight) };
+        out.levels.push_back(level);
+        offsets.push_back(totalSize);
+        totalSize += level.size;
+        if (levelWidth == 1 && levelHeight == 1) break;
+    }
+    out.builtData.resize(totalSize);
+
+    std::vector<unsigned char> current;
+    std::vector<unsigned char> next;
+    const unsigned char* source = rgba;
+    for (size_t i = 0; i < out.levels.size(); ++i) {
+        CompressedLevel& level = out.levels[i];
+        level.data = out.builtData.data() + offsets[i];
+        if (translucent) compressBC3(source, level.width, level.height, out.builtData.data() + offsets[i]);
+        else compressBC1(source, level.width, level.height, out.builtData.data() + offsets[i]);
+        if (i + 1 < out.levels.size()) {
+            downsampleRGBA8(source, level.width, level.height, next);
+            current.swap(next);
+            source = current.data();
+        }
+    }
+    out.fromCache = false;
+}
+
+bool TextureCache::Store(uint64_t key, const CompressedImage& image)
+{
+    if (!directoryReady) return false;
+
+    TextureCacheHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kTextureCacheMagic, sizeof(kTextureCacheMagic));
+    header.version = kTextureCacheVersion;
+    header.key = key;
+    header.format = image.format;
+    header.width = (uint32_t)image.width;
+    header.height = (uint32_t)image.height;
+    header.levelCount = (uint32_t)image.levels.size();
+    const uint64_t tableEnd = sizeof(header) + (uint64_t)image.levels.size() * sizeof(TextureCacheLevel);
+    header.dataOffset = (tableEnd + 15) / 16 * 16; // bloki wyrównane w zmapowanym pliku
+
+    std::vector<unsigned char> table((size_t)(header.dataOffset - sizeof(header)), 0);
+    for (size_t i = 0; i < image.levels.size(); ++i) {
+        const CompressedLevel& source = image.levels[i];
+        TextureCacheLevel level;
+        level.width = (uint32_t)source.width;
+        level.height = (uint32_t)source.height;
+        level.offset = (uint64_t)(source.data - image.levels[0].data);
+        level.size = source.size;
+        std::memcpy(table.data() + i * sizeof(level), &level, sizeof(level));
+    }
+    const unsigned char* data = image.levels[0].data;
+    const size_t dataSize = (size_t)(image.levels.back().data + image.levels.back().size - data);
+    header.payloadChecksum = fnv1a(fnv1a(kFnvOffset, table.data(), table.size()), data, dataSize);
+
+    // Zapis do pliku tymczasowego (nazwa z identyfikatorem wątku - ten sam obraz może kodować kilka wątków) i podmiana
+    std::string path = PathFor(key);
+    std::ostringstream tempName;
+    tempName << path << "." << std::this_thread::get_id() << ".tmp";
+    std::string tempPath = tempName.str();
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file) return false;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(table.data()), (std::streamsize)table.size());
+        file.write(reinterpret_cast<const char*>(data), (std::streamsize)dataSize);
+        if (!file) {
+            file.close();
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+    std::remove(path.c_str()); // rename na Windows nie nadpisuje istniejącego pliku
+    if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool TextureCache::LoadOrBuild(const std::string& sourceFile, CompressedImage& out, std::string& failure, int width, int height)
+{
+    MappedFile source;
+    if (!source.Open(sourceFile)) {
+        failure = "nie można otworzyć pliku";
+        return false;
+    }
+    uint64_t key = fnv1a(kFnvOffset, &kTextureCacheVersion, sizeof(kTextureCacheVersion));
+    if (width > 0 && height > 0) {
+        // Bez rozmiaru docelowego klucz jak dotąd - istniejące pliki cache zostają ważne
+        const int32_t size[2] = { width, height };
+        key = fnv1a(key, size, sizeof(size));
+    }
+    key = fnv1a(key, source.Data(), source.Size());
+
+    if (Load(key, out)) {
+        ++hits;
+        return true;
+    }
+    ++misses;
+    if (!Build(source.Data(), source.Size(), width, height, out, failure)) return false;
+    if (!Store(key, out)) {
+        std::cerr << "TextureCache: nie udało się zapisać " << PathFor(key) << std::endl;
+    }
+    return true;
+}
@@ -0,0 +1,66 @@
+#ifndef TEXTURE_CACHE_CLASS_H
+#define TEXTURE_CACHE_CLASS_H
+
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include "MappedFile.h"
+
+// Poziom mip gotowy do glCompressedTexImage2D
+struct CompressedLevel
+{
+    int width;
+    int height;
+    const unsigned char* data;
+    size_t size;
+};
+
+// Tekstura BC1/BC3 z pełnym łańcuchem mip: wskaźniki do zmapowanego pliku cache albo do świeżo zakodowanych danych
+struct CompressedImage
+{
+    GLenum format = 0; // GL_COMPRESSED_RGB_S3TC_DXT1_EXT albo GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+    int width = 0;
+    int height = 0;
+    std::vector<CompressedLevel> levels;
+    bool fromCache = false;
+
+    MappedFile file;
+    std::vector<unsigned char> builtData;
+};
+
+// Dyskowa pamięć podręczna tekstur skompresowanych blokowo (transkodowanie przy pierwszym uruchomieniu).
+// Klucz: FNV-1a z zawartości pliku źródłowego - zmieniony PNG/JPG daje nowy plik cache.
+// Plik: nagłówek (magia, wersja, klucz, format GL, wymiary, liczba poziomów, suma kontrolna), tabela poziomów,
+// bloki poziomów od największego. Odczyt to mmap - bez dekodowania obrazu.
+// Metody są bezpieczne dla wielu wątków (TextureLoader woła je z puli).
+class TextureCache
+{
+public:
+    explicit TextureCache(const std::string& cacheDirectory);
+
+    // Wypełnia out z cache albo dekoduje plik źródłowy, koduje go z mipmapami (BC1, a z przezroczystością BC3)
+    // i zapisuje wynik. false (i powód w failure), gdy źródła nie da się wczytać.
+    // width/height > 0: poziom 0 przeskalowany do tego rozmiaru (wspólny rozmiar warstw TextureArray) - osobny wpis cache
+    bool LoadOrBuild(const std::string& sourceFile, CompressedImage& out, std::string& failure, int width = 0, int height = 0);
+
+    // Kodowanie obrazu RGBA8 z pełnym łańcuchem mip do out.builtData, bez cache (np. placeholder warstwy)
+    static void Encode(const unsigned char* rgba, int width, int height, CompressedImage& out);
+
+    int Hits() const { return hits; }
+    int Misses() const { return misses; }
+
+private:
+    std::string directory;
+    bool directoryReady;
+    std::atomic<int> hits;
+    std::atomic<int> misses;
+
+    std::string PathFor(uint64_t key) const;
+    bool Load(uint64_t key, CompressedImage& out);
+    bool Build(const unsigned char* encoded, size_t encodedSize, int targetWidth, int targetHeight, CompressedImage& out, std::string& failure);
+    bool Store(uint64_t key, const CompressedImage& image);
+};
+
+#endif
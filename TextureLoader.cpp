@@ -0,0 +1,531 @@
+#include "TextureLoader.h"
+#include "Texture.h"
+#include "GLState.h"
+#include "GLExtensions.h"
+#include "TextureArray.h"
+#include "TextureCache.h"
+#include "BlockCompression.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#include "stb_image.h" // implementacja w Texture.cpp
+
+namespace
+{
+    template<class T>
+    bool isFutureReady(const std::future<T>& result)
+    {
+        return result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    const int kBytesPerPixel = 4; // zawsze RGBA8, jak w synchronicznym konstruktorze Texture
+
+    // RGBA8 z pełnym łańcuchem mip (~4/3 poziomu 0) - punkt odniesienia dla kompresji
+    unsigned long long uncompressedSize(int width, int height)
+    {
+        return (unsigned long long)width * height * kBytesPerPixel * 4 / 3;
+    }
+    // Warstwy tablicy: pełny łańcuch mip jak z glGenerateMipmap / TextureCache (aż do 1x1)
+    int mipLevelCount(int width, int height)
+    {
+        int levels = 1;
+        for (int size = std::max(width, height); size > 1; size /= 2) ++levels;
+        return levels;
+    }
+
+    // Tablica ma jeden format: warstwy BC1 dołączają do BC3 bez ponownego kodowania
+    std::shared_ptr<CompressedImage> promoteToBC3(const CompressedImage& image)
+    {
+        std::shared_ptr<CompressedImage> promoted = std::make_shared<CompressedImage>();
+        promoted->format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        promoted->width = image.width;
+        promoted->height = image.height;
+        promoted->fromCache = image.fromCache;
+        size_t totalSize = 0;
+        for (const CompressedLevel& level : image.levels) totalSize += level.size / kBC1BlockBytes * kBC3BlockBytes;
+        promoted->builtData.resize(totalSize);
+        unsigned char* out = promoted->builtData.data();
+        for (const CompressedLevel& level : image.levels) {
+            const size_t blockCount = level.size / kBC1BlockBytes;
+            convertBC1ToBC3(level.data, blockCount, out);
+            CompressedLevel converted = { level.width, level.height, out, blockCount * kBC3BlockBytes };
+            promoted->levels.push_back(converted);
+            out += converted.size;
+        }
+        return promoted;
+    }
+}
+
+const unsigned char TextureLoader::kPlaceholderTexel[4] = { 128, 128, 128, 255 };
+
+void TextureLoader::StbiFree::operator()(unsigned char* pixels) const
+{
+    stbi_image_free(pixels);
+}
+
+TextureLoader::TextureLoader(ThreadPool& pool, GLsizeiptr uploadBudget)
+    : pool(pool), compressedCache(nullptr), failedCount(0), uploadedBytes(0), uncompressedBytes(0), deferredFrames(0),
+      pixelBuffer(0), segmentSize(0), persistentMapping(nullptr), segment(0)
+{
+    for (int i = 0; i < kRingSize; ++i) fences[i] = 0;
+    // Wiersze RGBA8 mają długość wielokrotności 4 B, więc przesunięcia w segmencie spełniają GL_UNPACK_ALIGNMENT
+    segmentSize = (std::max(uploadBudget, (GLsizeiptr)kBytesPerPixel) + 3) / 4 * 4;
+}
+
+GLuint TextureLoader::CreatePlaceholder(GLenum type, GLuint unit, GLsizei layers)
+{
+    std::vector<unsigned char> texels((size_t)std::max(layers, 1) * kBytesPerPixel);
+    for (size_t i = 0; i < texels.size(); i += kBytesPerPixel) std::copy(kPlaceholderTexel, kPlaceholderTexel + kBytesPerPixel, texels.begin() + i);
+    GLuint placeholder = 0;
+    glGenTextures(1, &placeholder);
+    GLState::BindTexture(unit, type, placeholder);
+    GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glTexParameteri(type, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(type, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(type, GL_TEXTURE_MIN_FILTER, GL_NEAREST); // bez mipmap
+    glTexParameteri(type, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    if (type == GL_TEXTURE_2D_ARRAY) glTexImage3D(type, 0, GL_RGBA8, 1, 1, layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+    else glTexImage2D(type, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+    GLState::BindTexture(unit, type, 0);
+    return placeholder;
+}
+
+TextureLoader::DecodedImage TextureLoader::Decode(const std::string& path, TextureCache* cache, int width, int height)
+{
+    DecodedImage image;
+    const bool layer = width > 0 && height > 0;
+    if (cache) {
+        // Plik BC1/BC3 zmapowany z cache albo zakodowany teraz (pierwsze uruchomienie)
+        std::shared_ptr<CompressedImage> compressed = std::make_shared<CompressedImage>();
+        if (cache->LoadOrBuild(path, *compressed, image.failure, width, height)) image.compressed = compressed;
+    }
+    else {
+        // Flaga globalna stb należy do wątku głównego (Texture) - wątek puli ustawia własną
+        stbi_set_flip_vertically_on_load_thread(1);
+        int channels = 0;
+        image.pixels.reset(stbi_load(path.c_str(), &image.width, &image.height, &channels, kBytesPerPixel));
+        if (!image.pixels) {
+            const char* reason = stbi_failure_reason();
+            image.failure = reason ? reason : "nieznany";
+        }
+        else if (layer && (image.width != width || image.height != height)) {
+            resampleRGBA8(image.pixels.get(), image.width, image.height, width, height, image.resampled);
+            image.pixels.reset();
+            image.width = width;
+            image.height = height;
+        }
+    }
+    if (layer && image.Empty()) {
+        std::vector<unsigned char> placeholder((size_t)width * height * kBytesPerPixel);
+        for (size_t i = 0; i < placeholder.size(); i += kBytesPerPixel) std::copy(kPlaceholderTexel, kPlaceholderTexel + kBytesPerPixel, placeholder.begin() + i);
+        if (cache) {
+            image.compressed = std::make_shared<CompressedImage>();
+            TextureCache::Encode(placeholder.data(), width, height, *image.compressed);
+        }
+        else {
+            image.resampled.swap(placeholder);
+            image.width = width;
+            image.height = height;
+        }
+    }
+    return image;
+}
+
+void TextureLoader::Submit(Texture* target, const char* file, GLenum pixelType)
+{
+    PendingTexture load;
+    load.type = target->type;
+    load.unit = target->unit;
+    load.targetID = &target->ID;
+    load.targetResident = &target->resident;
+    load.files.push_back(file);
+    load.pixelType = pixelType;
+    Enqueue(load, 0, 0);
+}
+
+void TextureLoader::SubmitArray(TextureArray* target, const std::vector<std::string>& files, int layerWidth, int layerHeight)
+{
+    PendingTexture load;
+    load.type = GL_TEXTURE_2D_ARRAY;
+    load.unit = target->unit;
+    load.targetID = &target->ID;
+    load.targetResident = &target->resident;
+    load.files = files;
+    load.pixelType = GL_UNSIGNED_BYTE;
+    Enqueue(load, layerWidth, layerHeight);
+}
+
+void TextureLoader::Enqueue(PendingTexture& load, int width, int height)
+{
+    TextureCache* cache = glExtensions.textureCompressionS3TC ? compressedCache : nullptr;
+    for (const std::string& file : load.files) {
+        std::string path = file;
+        load.decoded.push_back(pool.Submit([path, cache, width, height]() { return Decode(path, cache, width, height); }));
+    }
+    load.texture = 0;
+    load.uploadedLayers = 0;
+    load.uploadedRows = 0;
+    load.uploadedLevels = 0;
+    load.state = Decoding;
+    pending.push_back(std::move(load));
+}
+
+void TextureLoader::StartUpload(PendingTexture& load)
+{
+    for (std::future<DecodedImage>& decoded : load.decoded) load.images.push_back(decoded.get());
+    load.decoded.clear();
+    if (load.type != GL_TEXTURE_2D_ARRAY && load.images[0].Empty()) {
+        std::cerr << "nie udalo się załadować tekstury: " << load.files[0] << ". Powod: " << load.images[0].failure << std::endl;
+        load.state = Failed;
+        return;
+    }
+    if (*load.targetID == 0) {
+        load.state = Done; // tekstura usunięta przed końcem dekodowania
+        return;
+    }
+    const GLenum type = load.type;
+    glGenTextures(1, &load.texture);
+    GLState::BindTexture(load.unit, type, load.texture);
+    glTexParameteri(type, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(type, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(type, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(type, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    load.state = Uploading;
+    if (type == GL_TEXTURE_2D_ARRAY) {
+        StartArrayUpload(load);
+        return;
+    }
+
+    const DecodedImage& image = load.images[0];
+    if (image.compressed) {
+        // Poziomy przydzielane po kolei przez glCompressedTexImage2D w Upload
+        const CompressedImage& compressed = *image.compressed;
+        std::cout << "Tekstura '" << load.files[0] << "' " << (compressed.format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT ? "BC1" : "BC3")
+                  << (compressed.fromCache ? " z cache" : " zakodowana") << ". Wymiary: " << compressed.width << "x" << compressed.height
+                  << ", poziomów mip: " << compressed.levels.size() << std::endl;
+        uncompressedBytes += uncompressedSize(compressed.width, compressed.height);
+        return;
+    }
+
+    std::cout << "Tekstura '" << load.files[0] << "' zdekodowana w tle. Wymiary: " << image.width << "x" << image.height << std::endl;
+    uncompressedBytes += uncompressedSize(image.width, image.height);
+    // Sam przydział poziomu 0 - dane przychodzą pasmami z PBO (przy zbindowanym PBO nullptr byłby przesunięciem)
+    GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glTexImage2D(type, 0, GL_RGBA, image.width, image.height, 0, GL_RGBA, load.pixelType, nullptr);
+
+    const GLsizeiptr rowBytes = (GLsizeiptr)image.width * kBytesPerPixel;
+    if (rowBytes > segmentSize) {
+        // Wiersz nie mieści się w segmencie - cały obraz od razu z pamięci klienta
+        glTexSubImage2D(type, 0, 0, 0, image.width, image.height, GL_RGBA, load.pixelType, image.Pixels());
+        uploadedBytes += (unsigned long long)rowBytes * image.height;
+        load.uploadedLayers = 1;
+        FinishUpload(load);
+    }
+}
+
+void TextureLoader::StartArrayUpload(PendingTexture& load)
+{
+    const GLsizei layerCount = (GLsizei)load.images.size();
+    bool anyBC3 = false;
+    int fromCache = 0;
+    for (size_t i = 0; i < load.images.size(); ++i) {
+        const DecodedImage& image = load.images[i];
+        if (!image.failure.empty()) {
+            std::cerr << "nie udalo się załadować warstwy " << i << " tablicy tekstur: " << load.files[i] << ". Powod: " << image.failure << std::endl;
+            ++failedCount; // warstwa zostaje szara, reszta tablicy normalnie
+        }
+        if (image.compressed) {
+            anyBC3 = anyBC3 || image.compressed->format == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+            if (image.compressed->fromCache) ++fromCache;
+        }
+    }
+
+    GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0); // przydział bez danych - przy zbindowanym PBO nullptr byłby przesunięciem
+    if (load.images[0].compressed) {
+        // Cache albo wszystkie warstwy, albo żadnej - wszystkie mają wspólny rozmiar, więc i liczbę poziomów
+        if (anyBC3) {
+            for (DecodedImage& image : load.images) {
+                if (image.compressed->format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT) image.compressed = promoteToBC3(*image.compressed);
+            }
+        }
+        const CompressedImage& first = *load.images[0].compressed;
+        std::cout << "Tablica tekstur " << first.width << "x" << first.height << " x " << layerCount << " " << (anyBC3 ? "BC3" : "BC1")
+                  << ", z cache " << fromCache << "/" << layerCount << " warstw, poziomów mip: " << first.levels.size() << std::endl;
+        if (glExtensions.textureStorage) {
+            glExtensions.TexStorage3D(GL_TEXTURE_2D_ARRAY, (GLsizei)first.levels.size(), first.format, first.width, first.height, layerCount);
+        }
+        else {
+            for (size_t i = 0; i < first.levels.size(); ++i) {
+                const CompressedLevel& level = first.levels[i];
+                glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, (GLint)i, first.format, level.width, level.height, layerCount, 0,
+                    (GLsizei)(level.size * layerCount), nullptr);
+            }
+        }
+        uncompressedBytes += uncompressedSize(first.width, first.height) * layerCount;
+        return;
+    }
+
+    const DecodedImage& first = load.images[0];
+    std::cout << "Tablica tekstur " << first.width << "x" << first.height << " x " << layerCount << " RGBA8 zdekodowana w tle" << std::endl;
+    uncompressedBytes += uncompressedSize(first.width, first.height) * layerCount;
+    if (glExtensions.textureStorage) {
+        glExtensions.TexStorage3D(GL_TEXTURE_2D_ARRAY, mipLevelCount(first.width, first.height), GL_RGBA8, first.width, first.height, layerCount);
+    }
+    else {
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, first.width, first.height, layerCount, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    }
+    const GLsizeiptr rowBytes = (GLsizeiptr)first.width * kBytesPerPixel;
+    if (rowBytes > segmentSize) {
+        // Wiersz nie mieści się w segmencie - wszystkie warstwy od razu z pamięci klienta
+        for (GLsizei layer = 0; layer < layerCount; ++layer) {
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, first.width, first.height, 1, GL_RGBA, load.pixelType, load.images[layer].Pixels());
+            uploadedBytes += (unsigned long long)rowBytes * first.height;
+        }
+        load.uploadedLayers = layerCount;
+        FinishUpload(load);
+    }
+}
+
+void TextureLoader::FinishUpload(PendingTexture& load)
+{
+    const GLenum type = load.type;
+    GLState::BindTexture(load.unit, type, load.texture);
+    if (!load.images[0].compressed) glGenerateMipmap(type); // skompresowane mają własny łańcuch mip
+    load.images.clear(); // zamyka mapowania plików cache
+    load.state = Done;
+    if (*load.targetID == 0) {
+        GLState::DeleteTexture(load.texture); // tekstura usunięta w trakcie wysyłania
+        load.texture = 0;
+        return;
+    }
+    // Podmiana placeholdera - Bind w następnej klatce zbinduje już pełny obraz
+    GLState::DeleteTexture(*load.targetID);
+    *load.targetID = load.texture;
+    *load.targetResident = true;
+    load.texture = 0;
+}
+
+void TextureLoader::CreatePixelBuffer()
+{
+    const GLsizeiptr size = segmentSize * kRingSize;
+    glGenBuffers(1, &pixelBuffer);
+    GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffer);
+    if (glExtensions.bufferStorage) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glExtensions.BufferStorage(GL_PIXEL_UNPACK_BUFFER, size, nullptr, flags);
+        persistentMapping = static_cast<unsigned char*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, flags));
+        if (!persistentMapping) {
+            // Magazyn niezmienny - zwykły bufor wymaga nowego obiektu
+            GLState::DeleteBuffer(pixelBuffer);
+            glGenBuffers(1, &pixelBuffer);
+            GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffer);
+        }
+    }
+    if (!persistentMapping) {
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+    }
+    GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    std::cout << "TextureLoader: PBO " << size / (1024 * 1024) << " MB (" << kRingSize << " segmenty), "
+              << (persistentMapping ? "trwale zmapowany" : "mapowany co klatkę") << std::endl;
+}
+
+int TextureLoader::Upload(bool wait)
+{
+    bool anyUploading = false;
+    for (const PendingTexture& load : pending) {
+        if (load.state == Uploading) anyUploading = true;
+    }
+    if (!anyUploading) return 0;
+    if (pixelBuffer == 0) CreatePixelBuffer();
+
+    GLsync& fence = fences[segment];
+    if (fence) {
+        // Segment czytany przez glTexSubImage2D sprzed kRingSize wysyłek - zwykle już wolny
+        GLenum status = glClientWaitSync(fence, 0, 0);
+        if (status == GL_TIMEOUT_EXPIRED) {
+            if (!wait) {
+                ++deferredFrames;
+                return 0;
+            }
+            do {
+                status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); // 1 ms
+            } while (status == GL_TIMEOUT_EXPIRED);
+        }
+        glDeleteSync(fence);
+        fence = 0;
+    }
+
+    const GLintptr segmentOffset = segment * segmentSize;
+    GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffer);
+    unsigned char* mapped = persistentMapping ? persistentMapping + segmentOffset
+        : static_cast<unsigned char*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, segmentOffset, segmentSize,
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+    if (!mapped) {
+        GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0); // wysyłka z pamięci klienta, w tym samym budżecie
+    }
+
+    // 1. Kopiowanie pasm wierszy (albo całych poziomów BC) do segmentu, po kolei (warstwa po warstwie),
+    //    aż do wyczerpania budżetu klatki
+    std::vector<UploadSpan> spans;
+    GLintptr used = 0;
+    bool budgetLeft = true;
+    for (PendingTexture& load : pending) {
+        if (load.state != Uploading) continue;
+        const int layerCount = (int)load.images.size();
+        while (budgetLeft && load.uploadedLayers < layerCount) {
+            const int layer = load.uploadedLayers;
+            const DecodedImage& image = load.images[layer];
+            if (image.compressed) {
+                const CompressedImage& compressed = *image.compressed;
+                while (load.uploadedLevels < (int)compressed.levels.size()) {
+                    const CompressedLevel& level = compressed.levels[load.uploadedLevels];
+                    // Poziom większy niż segment idzie z mapowania pliku i zużywa budżet całej klatki
+                    const bool direct = !mapped || (GLsizeiptr)level.size > segmentSize;
+                    const GLsizeiptr cost = std::min((GLsizeiptr)level.size, segmentSize);
+                    if (cost > segmentSize - used) {
+                        budgetLeft = false;
+                        break;
+                    }
+                    if (!direct) std::memcpy(mapped + used, level.data, level.size);
+                    UploadSpan span = { &load, layer, 0, 0, load.uploadedLevels, used, direct, false };
+                    spans.push_back(span);
+                    ++load.uploadedLevels;
+                    used += cost; // rozmiary bloków BC są wielokrotnością 8 B - wyrównanie wierszy RGBA8 zostaje
+                }
+                if (load.uploadedLevels < (int)compressed.levels.size()) break;
+                load.uploadedLevels = 0;
+            }
+            else {
+                const GLsizeiptr rowBytes = (GLsizeiptr)image.width * kBytesPerPixel;
+                const int rows = (int)std::min((GLsizeiptr)(image.height - load.uploadedRows), (segmentSize - used) / rowBytes);
+                if (rows <= 0) {
+                    budgetLeft = false;
+                    break;
+                }
+                if (mapped) {
+                    std::memcpy(mapped + used, image.Pixels() + load.uploadedRows * rowBytes, (size_t)(rows * rowBytes));
+                }
+                UploadSpan span = { &load, layer, load.uploadedRows, rows, -1, used, !mapped, false };
+                spans.push_back(span);
+                load.uploadedRows += rows;
+                used += rows * rowBytes;
+                if (load.uploadedRows < image.height) continue;
+                load.uploadedRows = 0;
+            }
+            if (++load.uploadedLayers == layerCount) spans.back().last = true;
+        }
+        if (!budgetLeft) break;
+    }
+    if (mapped && !persistentMapping) glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+    // 2. Kopie PBO -> tekstura; ostatnie pasmo kończy teksturę (mipmapy i podmiana placeholdera)
+    int completed = 0;
+    for (const UploadSpan& span : spans) {
+        PendingTexture& load = *span.texture;
+        const DecodedImage& image = load.images[span.layer];
+        const bool array = load.type == GL_TEXTURE_2D_ARRAY;
+        GLState::BindTexture(load.unit, load.type, load.texture);
+        GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, span.direct ? 0 : pixelBuffer);
+        if (span.level >= 0) {
+            const CompressedImage& compressed = *image.compressed;
+            const CompressedLevel& level = compressed.levels[span.level];
+            const void* source = span.direct ? static_cast<const void*>(level.data) : reinterpret_cast<const void*>(segmentOffset + span.offset);
+            if (array) {
+                // Magazyn przydzielony w StartArrayUpload - tu tylko dane warstwy
+                glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, span.level, 0, 0, span.layer, level.width, level.height, 1,
+                    compressed.format, (GLsizei)level.size, source);
+            }
+            else {
+                glCompressedTexImage2D(load.type, span.level, compressed.format, level.width, level.height, 0, (GLsizei)level.size, source);
+            }
+            uploadedBytes += level.size;
+        }
+        else {
+            const GLsizeiptr rowBytes = (GLsizeiptr)image.width * kBytesPerPixel;
+            const void* source = span.direct ? static_cast<const void*>(image.Pixels() + span.firstRow * rowBytes)
+                : reinterpret_cast<const void*>(segmentOffset + span.offset);
+            if (array) {
+                glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, span.firstRow, span.layer, image.width, span.rowCount, 1, GL_RGBA, load.pixelType, source);
+            }
+            else {
+                glTexSubImage2D(load.type, 0, 0, span.firstRow, image.width, span.rowCount, GL_RGBA, load.pixelType, source);
+            }
+            uploadedBytes += (unsigned long long)span.rowCount * rowBytes;
+        }
+        if (span.last) {
+            FinishUpload(load);
+            if (*load.targetResident) ++completed;
+        }
+    }
+    GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0); // inne glTexImage2D czytałyby z PBO
+
+    if (mapped) {
+        fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        segment = (segment + 1) % kRingSize;
+    }
+    return completed;
+}
+
+int TextureLoader::Update(bool wait)
+{
+    int completed = 0;
+    for (PendingTexture& load : pending) {
+        if (load.state == Decoding && std::all_of(load.decoded.begin(), load.decoded.end(), isFutureReady<DecodedImage>)) {
+            StartUpload(load);
+            if (load.state == Done && *load.targetResident) ++completed;
+        }
+    }
+    completed += Upload(wait);
+
+    for (const PendingTexture& load : pending) {
+        if (load.state == Failed) ++failedCount;
+    }
+    pending.erase(std::remove_if(pending.begin(), pending.end(),
+        [](const PendingTexture& load) { return load.state == Done || load.state == Failed; }), pending.end());
+    return completed;
+}
+
+int TextureLoader::Poll()
+{
+    return Update(false);
+}
+
+int TextureLoader::Finish()
+{
+    int completed = 0;
+    while (!pending.empty()) {
+        for (PendingTexture& load : pending) {
+            if (load.state != Decoding) continue;
+            for (const std::future<DecodedImage>& decoded : load.decoded) decoded.wait();
+        }
+        completed += Update(true);
+        if (!pending.empty()) std::this_thread::yield();
+    }
+    return completed;
+}
+
+void TextureLoader::Delete()
+{
+    for (PendingTexture& load : pending) {
+        if (load.texture) GLState::DeleteTexture(load.texture);
+        load.texture = 0;
+    }
+    pending.clear();
+    for (int i = 0; i < kRingSize; ++i) {
+        if (fences[i]) glDeleteSync(fences[i]);
+        fences[i] = 0;
+    }
+    if (pixelBuffer) {
+        if (persistentMapping) {
+            GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffer);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        }
+        GLState::DeleteBuffer(pixelBuffer);
+    }
+    pixelBuffer = 0;
+    persistentMapping = nullptr;
+}
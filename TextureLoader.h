@@ -0,0 +1,144 @@
+#ifndef TEXTURE_LOADER_CLASS_H
+#define TEXTURE_LOADER_CLASS_H
+
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+#include <future>
+#include <memory>
+#include "ThreadPool.h"
+
+class Texture;
+class TextureArray;
+class TextureCache;
+struct CompressedImage;
+
+// Asynchroniczne ładowanie tekstur dla Texture(loader, ...) i warstw TextureArray(loader, ...):
+//  - pliki PNG/JPG dekodowane są (stb_image) na wątkach puli,
+//  - piksele idą do GPU przez pierścień PBO - trwale zmapowany z ARB_buffer_storage, bez niego mapowany co klatkę
+//    bez synchronizacji (o wolny segment dbają fence'y, jak w FrameUniformBuffer),
+//  - Poll wysyła najwyżej uploadBudget bajtów na klatkę, pasmami wierszy; duża tekstura rozkłada się na kilka klatek,
+//  - do końca wysyłania Texture::ID wskazuje placeholder 1x1, potem (po glGenerateMipmap) gotowy obiekt.
+// Warstwy tablicy dekodowane są równolegle, a wysyłane (glTexSubImage3D / glCompressedTexSubImage3D) tym samym
+// pierścieniem i budżetem, dopiero gdy wszystkie są gotowe - format magazynu zależy od wszystkich warstw.
+// Z TextureCache i EXT_texture_compression_s3tc wątek puli mapuje plik BC1/BC3 z pełnym łańcuchem mip
+// (przy pierwszym uruchomieniu koduje go ze źródła), a Poll wysyła całe poziomy glCompressedTexImage2D;
+// bez rozszerzenia albo cache - RGBA8 jak wyżej.
+// Wszystkie wywołania GL odbywają się w Poll/Finish/Delete, na wątku z kontekstem.
+class TextureLoader
+{
+public:
+    static const GLsizeiptr kDefaultUploadBudget = 4 * 1024 * 1024;
+
+    // Bez wywołań GL - PBO tworzone przy pierwszym wysyłaniu; destruktor też nie dotyka GL (zwalnia Delete)
+    explicit TextureLoader(ThreadPool& pool, GLsizeiptr uploadBudget = kDefaultUploadBudget);
+
+    // nullptr wyłącza kompresję; cache musi żyć dłużej niż ładowane tekstury
+    void SetCompressedCache(TextureCache* cache) { compressedCache = cache; }
+
+    // Wołać raz na klatkę; zwraca liczbę tekstur (i tablic), które właśnie trafiły do GPU (IsResident)
+    int Poll();
+    // Czeka na wszystkie tekstury (np. przed pomiarami); budżet na klatkę nie obowiązuje
+    int Finish();
+    // Zwalnia PBO i fence'y; tekstury w trakcie ładowania zostają z placeholderem
+    void Delete();
+
+    int PendingCount() const { return (int)pending.size(); }
+    // Tekstury, które zostały z placeholderem, i warstwy tablic wypełnione placeholderem
+    int FailedCount() const { return failedCount; }
+    // Bajty wysłane do tekstur (po kompresji) i ile zajęłyby jako RGBA8 z mipmapami
+    unsigned long long UploadedBytes() const { return uploadedBytes; }
+    unsigned long long UncompressedBytes() const { return uncompressedBytes; }
+    // Klatki, w których wysyłanie przesunięto, bo GPU jeszcze czytało segment PBO
+    unsigned long long DeferredFrames() const { return deferredFrames; }
+
+private:
+    friend class Texture;
+    friend class TextureArray;
+
+    static const int kRingSize = 3;
+    static const unsigned char kPlaceholderTexel[4];
+
+    struct StbiFree
+    {
+        void operator()(unsigned char* pixels) const;
+    };
+
+    struct DecodedImage
+    {
+        std::unique_ptr<unsigned char, StbiFree> pixels; // RGBA8, wiersze od dołu (konwencja GL)
+        std::vector<unsigned char> resampled;            // zamiast pixels: warstwa tablicy w innym rozmiarze niż źródło
+        std::shared_ptr<CompressedImage> compressed;     // zamiast pixels, gdy ładowanie z TextureCache
+        int width = 0;
+        int height = 0;
+        std::string failure;
+
+        const unsigned char* Pixels() const { return pixels ? pixels.get() : resampled.data(); }
+        bool Empty() const { return !pixels && resampled.empty() && !compressed; }
+    };
+
+    enum LoadState { Decoding, Uploading, Done, Failed };
+
+    struct PendingTexture
+    {
+        GLenum type;         // GL_TEXTURE_2D_ARRAY: images to kolejne warstwy
+        GLuint unit;
+        GLuint* targetID;    // Texture::ID albo TextureArray::ID - do końca wysyłania siedzi tam placeholder
+        bool* targetResident;
+        std::vector<std::string> files;
+        std::vector<std::future<DecodedImage>> decoded;
+        std::vector<DecodedImage> images;
+        GLenum pixelType;
+        GLuint texture;      // docelowy obiekt
+        int uploadedLayers;
+        int uploadedRows;
+        int uploadedLevels;  // tekstury skompresowane wysyłane są całymi poziomami
+        LoadState state;
+    };
+
+    // Fragment obrazu skopiowany do segmentu PBO w tej klatce
+    struct UploadSpan
+    {
+        PendingTexture* texture;
+        int layer;
+        int firstRow;
+        int rowCount;
+        int level;           // >= 0: poziom tekstury skompresowanej
+        GLintptr offset;
+        bool direct;         // z pamięci klienta (poziom większy niż segment PBO)
+        bool last;           // kończy teksturę (mipmapy i podmiana placeholdera)
+    };
+
+    ThreadPool& pool;
+    TextureCache* compressedCache;
+    std::vector<PendingTexture> pending;
+    int failedCount;
+    unsigned long long uploadedBytes;
+    unsigned long long uncompressedBytes;
+    unsigned long long deferredFrames;
+
+    GLuint pixelBuffer;
+    GLsizeiptr segmentSize;
+    unsigned char* persistentMapping; // nullptr bez ARB_buffer_storage
+    GLsync fences[kRingSize];
+    int segment;
+
+    // Szary placeholder 1x1 bez mipmap (dla GL_TEXTURE_2D_ARRAY po tekselu na warstwę) - rysowany do końca wysyłania
+    static GLuint CreatePlaceholder(GLenum type, GLuint unit, GLsizei layers);
+    // Wątek puli: TextureCache (BC1/BC3) albo stb_image (RGBA8). width/height > 0: warstwa tablicy w tym rozmiarze;
+    // gdy pliku nie da się wczytać, zamiast niej placeholder (failure ustawione) - tablica i tak ma wszystkie warstwy
+    static DecodedImage Decode(const std::string& path, TextureCache* cache, int width, int height);
+
+    void Submit(Texture* target, const char* file, GLenum pixelType);
+    void SubmitArray(TextureArray* target, const std::vector<std::string>& files, int layerWidth, int layerHeight);
+    void Enqueue(PendingTexture& load, int width, int height);
+    void StartUpload(PendingTexture& load);
+    void StartArrayUpload(PendingTexture& load);
+    // wait == false: zajęty segment PBO przesuwa wysyłanie na następną klatkę
+    int Update(bool wait);
+    int Upload(bool wait);
+    void FinishUpload(PendingTexture& load);
+    void CreatePixelBuffer();
+};
+
+#endif
@@ -0,0 +1,107 @@
+#include "ThreadPool.h"
+#include <atomic>
+
+ThreadPool::ThreadPool(unsigned threadCount)
+    : stopping(false)
+{
+    if (threadCount == 0) {
+        unsigned hardware = std::thread::hardware_concurrency();
+        threadCount = hardware > 1 ? hardware - 1 : 1;
+    }
+    for (unsigned i = 0; i < threadCount; ++i) {
+        workers.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueCondition.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+ThreadPool& ThreadPool::Shared()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::Enqueue(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        tasks.push(std::move(task));
+    }
+    queueCondition.notify_one();
+}
+
+void ThreadPool::WorkerLoop()
+{
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (stopping && tasks.empty()) return;
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+        task();
+    }
+}
+
+// Stan jednego ParallelFor współdzielony przez wątki pomocnicze. Trzymany w shared_ptr, bo pomocnik może
+// wystartować dopiero po powrocie z ParallelFor (gdy wszystkie pasma zabrał już wątek wywołujący).
+struct ParallelForState
+{
+    std::function<void(int, int)> body;
+    int begin, end, grain, bandCount;
+    std::atomic<int> nextBand;
+    std::atomic<int> doneBands;
+    std::mutex doneMutex;
+    std::condition_variable doneCondition;
+
+    // Zabiera kolejne pasma aż do wyczerpania zakresu
+    void Run()
+    {
+        int band;
+        while ((band = nextBand.fetch_add(1)) < bandCount) {
+            int bandBegin = begin + band * grain;
+            int bandEnd = bandBegin + grain < end ? bandBegin + grain : end;
+            body(bandBegin, bandEnd);
+            if (doneBands.fetch_add(1) + 1 == bandCount) {
+                std::lock_guard<std::mutex> lock(doneMutex);
+                doneCondition.notify_all();
+            }
+        }
+    }
+};
+
+void ThreadPool::ParallelFor(int begin, int end, int grain, const std::function<void(int, int)>& body)
+{
+    if (end <= begin) return;
+    if (grain < 1) grain = 1;
+
+    auto state = std::make_shared<ParallelForState>();
+    state->body = body;
+    state->begin = begin;
+    state->end = end;
+    state->grain = grain;
+    state->bandCount = (end - begin + grain - 1) / grain;
+    state->nextBand = 0;
+    state->doneBands = 0;
+
+    int helpers = state->bandCount - 1 < (int)workers.size() ? state->bandCount - 1 : (int)workers.size();
+    for (int i = 0; i < helpers; ++i) {
+        Enqueue([state]() { state->Run(); });
+    }
+    state->Run();
+
+    std::unique_lock<std::mutex> lock(state->doneMutex);
+    state->doneCondition.wait(lock, [&state]() { return state->doneBands.load() == state->bandCount; });
+}
@@ -0,0 +1,52 @@
+#ifndef THREAD_POOL_CLASS_H
+#define THREAD_POOL_CLASS_H
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+
+// Prosta pula wątków roboczych: kolejka zadań FIFO + ParallelFor dzielący zakres na pasma.
+class ThreadPool
+{
+public:
+    // threadCount == 0: liczba wątków sprzętowych - 1 (wątek wywołujący też pracuje w ParallelFor)
+    explicit ThreadPool(unsigned threadCount = 0);
+    ~ThreadPool();
+
+    // Kolejkuje zadanie; wynik (lub wyjątek) dostępny przez zwrócone std::future
+    template<class F>
+    auto Submit(F&& task) -> std::future<decltype(task())>
+    {
+        typedef decltype(task()) Result;
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+        std::future<Result> result = packaged->get_future();
+        Enqueue([packaged]() { (*packaged)(); });
+        return result;
+    }
+
+    // Wywołuje body(bandBegin, bandEnd) dla pasm po grain elementów z zakresu [begin, end) i czeka na wszystkie.
+    // Wątek wywołujący przetwarza pasma razem z pulą, więc można to wołać także z wnętrza zadania puli.
+    void ParallelFor(int begin, int end, int grain, const std::function<void(int, int)>& body);
+
+    unsigned Size() const { return (unsigned)workers.size(); }
+
+    // Współdzielona pula całej aplikacji (tworzona przy pierwszym użyciu)
+    static ThreadPool& Shared();
+
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    bool stopping;
+
+    void Enqueue(std::function<void()> task);
+    void WorkerLoop();
+};
+
+#endif
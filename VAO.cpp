@@ -1,4 +1,5 @@
 #include"VAO.h"
+#include "GLState.h"
 
 VAO::VAO()
 {
@@ -10,12 +11,11 @@ void VAO::LinkVBO(VBO& VBO, GLuint layout)
 	VBO.Bind();
 	glVertexAttribPointer(layout, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
 	glEnableVertexAttribArray(layout);
-	VBO.Unbind();
 }
 
 void VAO::Bind()
 {
-	glBindVertexArray(ID);
+	GLState::BindVertexArray(ID);
 }
 
 void VAO::LinkAttrib(VBO& VBO, GLuint layout, GLuint numComponents, GLenum type, GLsizei stride, void* offset)
@@ -23,16 +23,29 @@ void VAO::LinkAttrib(VBO& VBO, GLuint layout, GLuint numComponents, GLenum type,
 	VBO.Bind();
 	glVertexAttribPointer(layout, numComponents, type, GL_FALSE, stride, offset);
 	glEnableVertexAttribArray(layout);
-	VBO.Unbind();
 }
 
+void VAO::LinkAttrib(VBO& VBO, GLuint layout, GLuint numComponents, GLenum type, GLboolean normalized, GLsizei stride, void* offset)
+{
+	VBO.Bind();
+	glVertexAttribPointer(layout, numComponents, type, normalized, stride, offset);
+	glEnableVertexAttribArray(layout);
+}
+
+void VAO::LinkAttribInstanced(VBO& VBO, GLuint layout, GLuint numComponents, GLenum type, GLsizei stride, void* offset, GLuint divisor)
+{
+	VBO.Bind();
+	glVertexAttribPointer(layout, numComponents, type, GL_FALSE, stride, offset);
+	glEnableVertexAttribArray(layout);
+	glVertexAttribDivisor(layout, divisor);
+}
 
 void VAO::Unbind()
 {
-	glBindVertexArray(0);
+	GLState::BindVertexArray(0);
 }
 
 void VAO::Delete()
 {
-	glDeleteVertexArrays(1, &ID);
+	GLState::DeleteVertexArray(ID);
 }
\ No newline at end of file
@@ -12,6 +12,9 @@ public:
 
 	void LinkVBO(VBO& VBO, GLuint layout);
 	void LinkAttrib(VBO& VBO, GLuint layout, GLuint numComponents, GLenum type, GLsizei stride, void* offset);
+	// Atrybut z normalizacja typow calkowitych (np. GL_SHORT -> [-1, 1], GL_UNSIGNED_SHORT -> [0, 1])
+	void LinkAttrib(VBO& VBO, GLuint layout, GLuint numComponents, GLenum type, GLboolean normalized, GLsizei stride, void* offset);
+	void LinkAttribInstanced(VBO& VBO, GLuint layout, GLuint numComponents, GLenum type, GLsizei stride, void* offset, GLuint divisor);
 	void Bind();
 	void Unbind();
 	void Delete();
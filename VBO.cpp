@@ -1,23 +1,31 @@
 #include"VBO.h"
+#include "GLState.h"
 
 VBO::VBO(GLfloat* vertices, GLsizeiptr size)
 {
 	glGenBuffers(1, &ID);
-	glBindBuffer(GL_ARRAY_BUFFER, ID);
+	GLState::BindBuffer(GL_ARRAY_BUFFER, ID);
 	glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_STATIC_DRAW);
 }
 
+VBO::VBO(const void* data, GLsizeiptr size, GLenum usage)
+{
+	glGenBuffers(1, &ID);
+	GLState::BindBuffer(GL_ARRAY_BUFFER, ID);
+	glBufferData(GL_ARRAY_BUFFER, size, data, usage);
+}
+
 void VBO::Bind()
 {
-	glBindBuffer(GL_ARRAY_BUFFER, ID);
+	GLState::BindBuffer(GL_ARRAY_BUFFER, ID);
 }
 
 void VBO::Unbind()
 {
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	GLState::BindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 void VBO::Delete()
 {
-	glDeleteBuffers(1, &ID);
+	GLState::DeleteBuffer(ID);
 }
\ No newline at end of file
@@ -8,6 +8,7 @@ class VBO
 public:
 	GLuint ID;
 	VBO(GLfloat* vertices, GLsizeiptr size);
+	VBO(const void* data, GLsizeiptr size, GLenum usage);
 
 	void Bind();
 	void Unbind();
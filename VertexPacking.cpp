@@ -0,0 +1,154 @@
+#include "VertexPacking.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cstddef>
+
+static_assert(sizeof(PackedVertex) == 16, "PackedVertex musi mieć 16 bajtów");
+
+// Konwersja z zaokrągleniem do najbliższej (remis do parzystej), jak przy konwersji sprzętowej
+GLushort floatToHalf(float value)
+{
+    unsigned int bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    unsigned int sign = (bits >> 16) & 0x8000u;
+    unsigned int absBits = bits & 0x7FFFFFFFu;
+
+    if (absBits >= 0x7F800000u) { // inf / NaN
+        return (GLushort)(sign | 0x7C00u | (absBits > 0x7F800000u ? 0x200u : 0u));
+    }
+    if (absBits >= 0x477FF000u) { // poza zakresem half po zaokrągleniu -> inf
+        return (GLushort)(sign | 0x7C00u);
+    }
+    if (absBits < 0x38800000u) { // denormal half (lub zero)
+        if (absBits < 0x33000000u) return (GLushort)sign;
+        unsigned int exponent = absBits >> 23;
+        unsigned int mantissa = (absBits & 0x7FFFFFu) | 0x800000u;
+        unsigned int shift = 126u - exponent; // 14..24
+        unsigned int halfMantissa = mantissa >> shift;
+        unsigned int remainder = mantissa & ((1u << shift) - 1u);
+        unsigned int halfway = 1u << (shift - 1u);
+        if (remainder > halfway || (remainder == halfway && (halfMantissa & 1u))) ++halfMantissa;
+        return (GLushort)(sign | halfMantissa);
+    }
+    unsigned int rebased = absBits - 0x38000000u; // wykładnik 127 -> 15
+    unsigned int half = rebased >> 13;
+    unsigned int remainder = rebased & 0x1FFFu;
+    if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) ++half; // przeniesienie może podbić wykładnik - to poprawne
+    return (GLushort)(sign | half);
+}
+
+float halfToFloat(GLushort value)
+{
+    unsigned int sign = (unsigned int)(value & 0x8000u) << 16;
+    unsigned int exponent = (value >> 10) & 0x1Fu;
+    unsigned int mantissa = value & 0x3FFu;
+    unsigned int bits;
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            bits = sign;
+        }
+        else {
+            float denormal = std::ldexp((float)mantissa, -24);
+            std::memcpy(&bits, &denormal, sizeof(bits));
+            bits |= sign;
+        }
+    }
+    else if (exponent == 0x1F) {
+        bits = sign | 0x7F800000u | (mantissa << 13);
+    }
+    else {
+        bits = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+    }
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+static GLshort toSnorm16(float value)
+{
+    value = std::max(-1.0f, std::min(1.0f, value));
+    return (GLshort)std::lround(value * 32767.0f);
+}
+
+static float fromSnorm16(GLshort value)
+{
+    return std::max((float)value / 32767.0f, -1.0f); // ta sama reguła co GL 3.3 dla znormalizowanych atrybutów
+}
+
+static float signNotZero(float value)
+{
+    return value >= 0.0f ? 1.0f : -1.0f;
+}
+
+void octEncode(const glm::vec3& normal, GLshort out[2])
+{
+    float l1 = std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z);
+    if (l1 <= 0.0f) { out[0] = 0; out[1] = 0; return; }
+    float px = normal.x / l1;
+    float py = normal.y / l1;
+    if (normal.z < 0.0f) {
+        // Dolna półkula odbijana na rogi kwadratu
+        float foldedX = (1.0f - std::fabs(py)) * signNotZero(px);
+        float foldedY = (1.0f - std::fabs(px)) * signNotZero(py);
+        px = foldedX;
+        py = foldedY;
+    }
+    out[0] = toSnorm16(px);
+    out[1] = toSnorm16(py);
+}
+
+glm::vec3 octDecode(const GLshort encoded[2])
+{
+    glm::vec3 n(fromSnorm16(encoded[0]), fromSnorm16(encoded[1]), 0.0f);
+    n.z = 1.0f - std::fabs(n.x) - std::fabs(n.y);
+    float t = std::max(-n.z, 0.0f);
+    n.x += n.x >= 0.0f ? -t : t;
+    n.y += n.y >= 0.0f ? -t : t;
+    return glm::normalize(n);
+}
+
+PackedMesh packVertices(const GLfloat* vertices, size_t vertexCount, int strideFloats,
+    int positionOffset, int texCoordOffset, int normalOffset)
+{
+    PackedMesh mesh;
+    mesh.vertices.resize(vertexCount);
+    mesh.texCoordScale = 1.0f;
+    if (vertexCount == 0) return mesh;
+
+    // Przesunięcie UV o całkowitą liczbę powtórzeń tak, aby minimum trafiło do [0, 1), oraz skala = całkowity zakres
+    float minU = vertices[texCoordOffset], minV = vertices[texCoordOffset + 1];
+    float maxU = minU, maxV = minV;
+    for (size_t i = 1; i < vertexCount; ++i) {
+        const GLfloat* uv = vertices + i * strideFloats + texCoordOffset;
+        minU = std::min(minU, uv[0]); maxU = std::max(maxU, uv[0]);
+        minV = std::min(minV, uv[1]); maxV = std::max(maxV, uv[1]);
+    }
+    float shiftU = std::floor(minU);
+    float shiftV = std::floor(minV);
+    mesh.texCoordScale = std::max(1.0f, std::ceil(std::max(maxU - shiftU, maxV - shiftV)));
+    const float uvToUnorm = 65535.0f / mesh.texCoordScale;
+
+    for (size_t i = 0; i < vertexCount; ++i) {
+        const GLfloat* v = vertices + i * strideFloats;
+        PackedVertex& out = mesh.vertices[i];
+        out.position[0] = floatToHalf(v[positionOffset]);
+        out.position[1] = floatToHalf(v[positionOffset + 1]);
+        out.position[2] = floatToHalf(v[positionOffset + 2]);
+        out.padding = 0;
+        octEncode(glm::vec3(v[normalOffset], v[normalOffset + 1], v[normalOffset + 2]), out.normal);
+        float u = (v[texCoordOffset] - shiftU) * uvToUnorm;
+        float t = (v[texCoordOffset + 1] - shiftV) * uvToUnorm;
+        out.texCoord[0] = (GLushort)std::lround(std::max(0.0f, std::min(65535.0f, u)));
+        out.texCoord[1] = (GLushort)std::lround(std::max(0.0f, std::min(65535.0f, t)));
+    }
+    return mesh;
+}
+
+void linkPackedVertexAttribs(VAO& vao, VBO& vbo)
+{
+    vao.Bind();
+    vao.LinkAttrib(vbo, 0, 3, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, position)); // aPos
+    vao.LinkAttrib(vbo, 2, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, texCoord)); // aTex
+    vao.LinkAttrib(vbo, 3, 2, GL_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, normal)); // aNormalOct
+}
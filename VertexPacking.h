@@ -0,0 +1,45 @@
+#ifndef VERTEX_PACKING_H
+#define VERTEX_PACKING_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include "VAO.h"
+
+// Skompresowany wierzchołek (16 B zamiast 44 B dla układu pozycja/kolor/UV/normalna):
+//  - pozycja: 3 x half float (+ 2 B wyrównania),
+//  - normalna: kodowanie oktaedryczne, 2 x snorm16,
+//  - UV: 2 x unorm16, przeskalowane przez u_texCoordScale w shaderze.
+// Kolor pomijamy - default.frag go nie czyta.
+struct PackedVertex
+{
+    GLushort position[3];
+    GLushort padding;
+    GLshort normal[2];
+    GLushort texCoord[2];
+};
+
+struct PackedMesh
+{
+    std::vector<PackedVertex> vertices;
+    float texCoordScale; // UV w shaderze = aTex * texCoordScale
+};
+
+GLushort floatToHalf(float value);
+float halfToFloat(GLushort value);
+
+// Normalna (dowolnej długości) -> dwa snorm16 w kodowaniu oktaedrycznym; odwrotność: octDecode w shaderach
+void octEncode(const glm::vec3& normal, GLshort out[2]);
+glm::vec3 octDecode(const GLshort encoded[2]);
+
+// Pakuje vertexCount wierzchołków z tablicy floatów o kroku strideFloats;
+// offsety (w floatach) wskazują pozycję (3), UV (2) i normalną (3).
+// UV przesuwane są o całkowitą liczbę powtórzeń do zakresu [0, texCoordScale] - przy GL_REPEAT wynik próbkowania się nie zmienia.
+PackedMesh packVertices(const GLfloat* vertices, size_t vertexCount, int strideFloats,
+    int positionOffset, int texCoordOffset, int normalOffset);
+
+// Binduje vao i podpina PackedVertex: 0 aPos (half float), 2 aTex (unorm16 -> [0, 1]), 3 aNormalOct (snorm16 -> [-1, 1]);
+// wszystkie przez glVertexAttribPointer, więc w shaderze to zwykłe vec3/vec2
+void linkPackedVertexAttribs(VAO& vao, VBO& vbo);
+
+#endif
@@ -6,12 +6,22 @@ in vec2 texCoord;
 in vec3 FragPos_world;
 in vec3 Normal_world;
 
-uniform sampler2D tex0;
+uniform sampler2DArray tex0; //materialy sceny jako warstwy (TextureArray) - jeden binding dla wszystkich obiektow
+uniform int u_layer;         //warstwa materialu dla rysowanego obiektu
 
-uniform vec4 lightColor;
-uniform vec3 lightPos;
-uniform vec3 camPos;
-uniform int u_lightingMode;
+// Warianty programu (ShaderDefines wstrzykiwane za #version): składowe oświetlenia włączane na etapie kompilacji
+// zamiast rozgałęzienia po uniformie. Bez definicji - pełne oświetlenie (ambient + diffuse + specular).
+#ifndef LIGHTING_AMBIENT
+#define LIGHTING_AMBIENT 1
+#endif
+#ifndef LIGHTING_DIFFUSE
+#define LIGHTING_DIFFUSE 1
+#endif
+#ifndef LIGHTING_SPECULAR
+#define LIGHTING_SPECULAR 1
+#endif
+
+//blok FrameData (camMatrix, view, projection, lightColor, lightPos, u_time, camPos) wstrzykiwany za #version - kFrameDataBlock w FrameUniforms.h
 
 // --- Dodany uniform dla kontroli błyszczenia ---
 uniform float u_specularStrength;
@@ -33,48 +43,39 @@ void main()
     // -----------------------------------------------------------
 
 
-    vec3 objectBaseColor = texture(tex0, texCoord).rgb;
+    vec3 objectBaseColor = texture(tex0, vec3(texCoord, float(u_layer))).rgb;
+
+    //obliczenia komponentów modelu Phonga - tylko te, których potrzebuje wariant (klawisze 1-4)
+    vec3 finalColor = vec3(0.0f);
 
-    //obliczenia komponentów modelu Phonga
+#if LIGHTING_DIFFUSE || LIGHTING_SPECULAR
+    vec3 norm = normalize(Normal_world);
+    vec3 lightDir = normalize(lightPos - FragPos_world);		//kierunek swiatla
+#endif
+
+#if LIGHTING_AMBIENT
     //swiatlo ambientowe - ambient light
     float ambientStrength = 0.20f;		//sila swiatla ambientowego
     vec3 ambientComponent = ambientStrength * lightColor.rgb;
+    finalColor += ambientComponent * objectBaseColor;
+#endif
 
+#if LIGHTING_DIFFUSE
     //swiatlo rozproszone - diffuse light
-    vec3 norm = normalize(Normal_world);
-    vec3 lightDir = normalize(lightPos - FragPos_world);		//kierunek swiatla
     float diffFactor = max(dot(norm, lightDir), 0.0f);		//wspolczynnik rozproszenia
     vec3 diffuseComponent = diffFactor * lightColor.rgb;
+    finalColor += diffuseComponent * objectBaseColor;
+#endif
 
-    //swiatlo odbite - specular light
-    // Zmieniono: Używamy uniformu u_specularStrength zamiast stałej
-    // float specularStrength = 0.7f; // Usunięto tę stałą
+#if LIGHTING_SPECULAR
+    //swiatlo odbite - specular light, skalowane uniformem u_specularStrength
     int shininess = 64;		//im wyższa wartość błyszczenia, tym mniejsze i ostrzejsze odbicie
     vec3 viewDir = normalize(camPos - FragPos_world);			//kierunek od fragmentu do kamery
     vec3 reflectDir = reflect(-lightDir, norm);		//wektor odbicia światła
     float specFactor = pow(max(dot(viewDir, reflectDir), 0.0f), float(shininess));
-    // Zmieniono: Mnożymy przez uniform u_specularStrength
     vec3 specularComponent = u_specularStrength * specFactor * lightColor.rgb;
+    finalColor += specularComponent;
+#endif
 
-    //wybor i zastosowanie modelu oswietlenia
-    vec3 finalColor;
-
-    if (u_lightingMode == 0)
-    {
-        finalColor = ambientComponent * objectBaseColor;
-    }
-    else if (u_lightingMode == 1)
-    {
-       finalColor = diffuseComponent * objectBaseColor;
-    }
-    else if (u_lightingMode == 2)
-    {
-        // Tryb 2 to Specular (+Ambient)
-        finalColor = (ambientComponent * objectBaseColor) + specularComponent;
-    }
-    else		//pelne oswietlenie (ambient + diffuse + specular) - klawisz 4
-    {
-       finalColor = (ambientComponent + diffuseComponent) * objectBaseColor + specularComponent;
-    }
     FragColor = vec4(finalColor, 1.0f);
 }
\ No newline at end of file
@@ -6,7 +6,7 @@ layout (location = 3) in vec3 aNormal;
 out vec2 texCoord;
 out vec3 FragPos_world;
 out vec3 Normal_world;
-uniform mat4 camMatrix;
+//blok FrameData (camMatrix, view, projection, lightColor, lightPos, u_time, camPos) wstrzykiwany za #version - kFrameDataBlock w FrameUniforms.h
 uniform mat4 model;
 void main()
 {
@@ -0,0 +1,27 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;       //half float
+layout (location = 2) in vec2 aTex;       //unorm16, przeskalowane przez u_texCoordScale
+layout (location = 3) in vec2 aNormalOct; //snorm16, normalna zakodowana oktaedrycznie (PackedVertex)
+layout (location = 4) in mat4 aInstanceModel; //macierz modelu instancji - zajmuje lokacje 4-7
+out vec2 texCoord;
+out vec3 FragPos_world;
+out vec3 Normal_world;
+//blok FrameData (camMatrix, view, projection, lightColor, lightPos, u_time, camPos) wstrzykiwany za #version - kFrameDataBlock w FrameUniforms.h
+uniform float u_texCoordScale;
+
+vec3 octDecode(vec2 e)
+{
+vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+float t = max(-n.z, 0.0);
+n.x += n.x >= 0.0 ? -t : t;
+n.y += n.y >= 0.0 ? -t : t;
+return normalize(n);
+}
+
+void main()
+{
+FragPos_world = vec3(aInstanceModel * vec4(aPos, 1.0f));
+gl_Position = camMatrix * vec4(FragPos_world, 1.0f);
+texCoord = aTex * u_texCoordScale;
+Normal_world = normalize(mat3(transpose(inverse(aInstanceModel))) * octDecode(aNormalOct));
+}
@@ -1,6 +1,6 @@
 #version 330 core
 out vec4 FragColor;
-uniform vec4 lightColor;
+//blok FrameData (camMatrix, view, projection, lightColor, lightPos, u_time, camPos) wstrzykiwany za #version - kFrameDataBlock w FrameUniforms.h
 void main()
 {
 FragColor = lightColor;
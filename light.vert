@@ -1,7 +1,8 @@
 #version 330 core
+// Program zastepczy: rysuje geometrie kolorem swiatla, dopoki docelowy program sie kompiluje (ShaderBuilder)
 layout (location = 0) in vec3 aPos;
 uniform mat4 model;
-uniform mat4 camMatrix;
+//blok FrameData (camMatrix, view, projection, lightColor, lightPos, u_time, camPos) wstrzykiwany za #version - kFrameDataBlock w FrameUniforms.h
 void main()
 {
 gl_Position = camMatrix * model *
@@ -13,147 +13,121 @@
 #include <glm/gtx/vector_angle.hpp>
 #include <random>
 #include <ctime>
+#include <memory>
 
 #include "shaderClass.h"
+#include "GLState.h"
 #include "VAO.h"
 #include "VBO.h"
 #include "EBO.h"
 #include "Camera.h"
 #include "Texture.h"
+#include "TextureLoader.h"
+#include "TextureCache.h"
+#include "TextureArray.h"
+#include "Atmosphere.h"
+#include "Profiler.h"
+#include "Benchmark.h"
+#include "CameraPath.h"
+#include "RegressionGate.h"
+#include "RenderTarget.h"
 #include "Cactus.h"
 #include "Skybox.h" 
+#include "Terrain.h"
+#include "ThreadPool.h"
+#include "TerrainChunks.h"
+#include "TerrainLOD.h"
+#include "TerrainGrid.h"
+#include "VertexPacking.h"
+#include "MeshOptimizer.h"
+#include "HeightField.h"
+#include "MeshCache.h"
+#include "SphereLOD.h"
+#include "FrameUniforms.h"
+#include "GLExtensions.h"
+#include "ProgramBinaryCache.h"
+#include "ShaderBuilder.h"
+#include "ShaderPermutations.h"
 
 
-void generateSphere(float radius, int sectorCount, int stackCount,
-    std::vector<GLfloat>& outSphereVertices, std::vector<GLuint>& outSphereIndices)
-{
-    outSphereVertices.clear();
-    outSphereIndices.clear();
-
-    float x, y, z, xy;                      //vertex position
-    float nx, ny, nz, lengthInv = 1.0f / radius;    //vertex normal
-    float s, t;                                     //vertex texCoord
-
-    float sectorStep = 2 * M_PI / sectorCount;
-    float stackStep = M_PI / stackCount;
-    float sectorAngle, stackAngle;
-
-    for (int i = 0; i <= stackCount; ++i)
-    {
-        stackAngle = M_PI / 2 - i * stackStep;        //starting from pi/2 to -pi/2
-        xy = radius * cosf(stackAngle);             //r * cos(u)
-        z = radius * sinf(stackAngle);              //r * sin(u)
-
-        for (int j = 0; j <= sectorCount; ++j)
-        {
-            sectorAngle = j * sectorStep;           //starting from 0 to 2pi
-
-            x = xy * cosf(sectorAngle);             //r * cos(u) * cos(v)
-            y = xy * sinf(sectorAngle);             //r * cos(u) * sin(v)
-            outSphereVertices.push_back(x);
-            outSphereVertices.push_back(y);
-            outSphereVertices.push_back(z);
-
-            nx = x * lengthInv;
-            ny = y * lengthInv;
-            nz = z * lengthInv;
-            outSphereVertices.push_back(nx);
-            outSphereVertices.push_back(ny);
-            outSphereVertices.push_back(nz);
-
-            s = (float)j / sectorCount;
-            t = (float)i / stackCount;
-            outSphereVertices.push_back(s);
-            outSphereVertices.push_back(t);
-        }
-    }
+// --- Koniec funkcji pomocniczych ---
 
-    int k1, k2;
-    for (int i = 0; i < stackCount; ++i)
-    {
-        k1 = i * (sectorCount + 1);     
-        k2 = k1 + sectorCount + 1;      
-
-        for (int j = 0; j < sectorCount; ++j, ++k1, ++k2)
-        {
-            if (i != 0)
-            {
-                outSphereIndices.push_back(k1);
-                outSphereIndices.push_back(k2);
-                outSphereIndices.push_back(k1 + 1);
-            }
-            if (i != (stackCount - 1))
-            {
-                outSphereIndices.push_back(k1 + 1);
-                outSphereIndices.push_back(k2);
-                outSphereIndices.push_back(k2 + 1);
-            }
-        }
-    }
-    std::cout << "Generated Sphere: " << outSphereVertices.size() / 8 << " vertices, " << outSphereIndices.size() / 3 << " triangles." << std::endl;
-}
+// Tryb oświetlenia (klawisze 1-4, L) wybiera wariant programów oświetlanych - bez uniformu i rozgałęzień w shaderze
+static const int kLightingModeCount = 4;
+static int currentLightingMode = 3;
 
-float getHeight(float x, float z, float amplitude, float frequency) {
-    float h = 0.0f;
-    h += amplitude * sin((x + z * 0.5f) * frequency);
-    h += (amplitude * 0.4f) * cos((x - z * 0.8f) * frequency * 1.5f);
-    h += (amplitude * 0.15f) * sin((x * 2.5f + z * 1.5f) * frequency * 2.0f);
-    h += (amplitude * 0.08f) * cos((z * 3.0f - x * 0.7f) * frequency * 3.0f);
-    float total_coeffs = 1.0f + 0.4f + 0.15f + 0.08f;
-    h /= total_coeffs;
-    return h;
+// Tryby terenu przełączane klawiszem T
+enum TerrainMode { TERRAIN_STATIC = 0, TERRAIN_STREAMED = 1, TERRAIN_CDLOD = 2, TERRAIN_GPU_GRID = 3, TERRAIN_MODE_COUNT };
+static int currentTerrainMode = TERRAIN_STATIC;
+// Parametry fali terenów liczonych na GPU (CDLOD, płaska siatka) - zmieniane w locie klawiszami [ ] oraz - =
+static float terrainWaveAmplitude = 0.25f;
+static float terrainWaveFrequency = 0.8f;
+// Klawisz P: zapis profilu (profile.csv, profile_trace.json) i podsumowania przebiegów
+static bool profileExportRequested = false;
+
+// Materiały oświetlanych obiektów - warstwy jednej tablicy tekstur (kolejność plików w materialFiles)
+enum MaterialLayer { MATERIAL_PYRAMID_SAND = 0, MATERIAL_GROUND_SAND = 1, MATERIAL_CACTUS = 2, MATERIAL_COUNT };
+static const GLuint kMaterialTextureUnit = 0;
+static const GLuint kSunTextureUnit = 1;
+static const GLuint kSkyViewTextureUnit = 2;
+
+static const char* terrainModeName(int mode) {
+    if (mode == TERRAIN_STREAMED) return "Teren: strumieniowany (kafle wokół kamery)";
+    if (mode == TERRAIN_CDLOD) return "Teren: CDLOD (LOD zależny od odległości)";
+    if (mode == TERRAIN_GPU_GRID) return "Teren: płaska siatka, wysokość liczona na GPU";
+    return "Teren: stały (6x6)";
 }
 
-glm::vec3 calculateNormal(float x, float z, float epsilon, float amplitude, float frequency) {
-    float y_center = getHeight(x, z, amplitude, frequency);
-    float y_dx = getHeight(x + epsilon, z, amplitude, frequency);
-    float y_dz = getHeight(x, z + epsilon, amplitude, frequency);
-    glm::vec3 tangentX = glm::vec3(epsilon, y_dx - y_center, 0.0f);
-    glm::vec3 tangentZ = glm::vec3(0.0f, y_dz - y_center, epsilon);
-    glm::vec3 normal = glm::normalize(glm::cross(tangentZ, tangentX));
-    return normal;
+// Uniformy programów z default.frag - nazwy rozwiązywane raz po linkowaniu, w pętli renderowania tylko Set.
+// Kamera i światło są w bloku FrameData (FrameUniformBuffer), wspólnym dla wszystkich programów.
+struct LitUniforms {
+    UniformHandle<glm::mat4> model;
+    UniformHandle<float> specularStrength;
+    UniformHandle<float> texCoordScale;
+    UniformHandle<int> tex0;
+    UniformHandle<int> layer;
+
+    LitUniforms() {}
+    explicit LitUniforms(const Shader& shader)
+        : model(shader.Uniform<glm::mat4>("model")), specularStrength(shader.Uniform<float>("u_specularStrength")),
+          texCoordScale(shader.Uniform<float>("u_texCoordScale")), tex0(shader.Uniform<int>("tex0")),
+          layer(shader.Uniform<int>("u_layer")) {}
+};
+
+// Składowe oświetlenia default.frag dla trybu: 0 ambient, 1 diffuse, 2 ambient + specular, 3 pełne (ADS)
+static ShaderDefines lightingDefines(int mode, ShaderDefines defines) {
+    defines.Set("LIGHTING_AMBIENT", mode == 0 || mode == 2 || mode == 3 ? 1 : 0);
+    defines.Set("LIGHTING_DIFFUSE", mode == 1 || mode == 3 ? 1 : 0);
+    defines.Set("LIGHTING_SPECULAR", mode == 2 || mode == 3 ? 1 : 0);
+    return defines;
 }
 
-void generateWavyGround(int segmentsX, int segmentsZ, float totalWidth, float totalDepth,
-    float waveAmplitude, float waveFrequency, float textureTiling,
-    std::vector<GLfloat>& outGroundVertices, std::vector<GLuint>& outGroundIndices)
-{
-    outGroundVertices.clear();
-    outGroundIndices.clear();
-    float segmentWidth = totalWidth / segmentsX;
-    float segmentDepth = totalDepth / segmentsZ;
-    float epsilon = 0.005f;
-    for (int i = 0; i <= segmentsZ; ++i) {
-        for (int j = 0; j <= segmentsX; ++j) {
-            float x = (float)j * segmentWidth - totalWidth * 0.5f;
-            float z = (float)i * segmentDepth - totalDepth * 0.5f;
-            float y = getHeight(x, z, waveAmplitude, waveFrequency);
-            float r = 1.0f, g = 1.0f, b = 1.0f; // Dummy color
-            float s = (float)j / segmentsX * textureTiling;
-            float t = (float)i / segmentsZ * textureTiling;
-            glm::vec3 normal = calculateNormal(x, z, epsilon, waveAmplitude, waveFrequency);
-            outGroundVertices.push_back(x); outGroundVertices.push_back(y); outGroundVertices.push_back(z);
-            outGroundVertices.push_back(r); outGroundVertices.push_back(g); outGroundVertices.push_back(b);
-            outGroundVertices.push_back(s); outGroundVertices.push_back(t);
-            outGroundVertices.push_back(normal.x); outGroundVertices.push_back(normal.y); outGroundVertices.push_back(normal.z);
+// Warianty jednego programu oświetlanego dla wszystkich trybów i uchwyty uniformów każdego z nich
+struct LitProgramSet {
+    Shader* variants[kLightingModeCount];
+    LitUniforms uniforms[kLightingModeCount];
+
+    // base: definicje wspólne dla wszystkich trybów (np. rozmiary tablic uniformów)
+    explicit LitProgramSet(ShaderPermutations& permutations, const ShaderDefines& base = ShaderDefines()) {
+        // Bieżący tryb zgłaszany pierwszy - jego wariant będzie gotowy najwcześniej
+        for (int i = 0; i < kLightingModeCount; ++i) {
+            int mode = (currentLightingMode + i) % kLightingModeCount;
+            variants[mode] = &permutations.Get(lightingDefines(mode, base));
         }
     }
-    int verticesPerSegmentRow = segmentsX + 1;
-    for (int i = 0; i < segmentsZ; ++i) {
-        for (int j = 0; j < segmentsX; ++j) {
-            int vertexIndex_BL = i * verticesPerSegmentRow + j;
-            int vertexIndex_BR = i * verticesPerSegmentRow + j + 1;
-            int vertexIndex_TL = (i + 1) * verticesPerSegmentRow + j;
-            int vertexIndex_TR = (i + 1) * verticesPerSegmentRow + j + 1;
-            outGroundIndices.push_back(vertexIndex_BL); outGroundIndices.push_back(vertexIndex_BR); outGroundIndices.push_back(vertexIndex_TR);
-            outGroundIndices.push_back(vertexIndex_BL); outGroundIndices.push_back(vertexIndex_TR); outGroundIndices.push_back(vertexIndex_TL);
+    // Sampler tablicy materiałów ustawiany raz na program - między rysowaniami zmienia się tylko u_layer
+    void ResolveUniforms() {
+        for (int mode = 0; mode < kLightingModeCount; ++mode) {
+            uniforms[mode] = LitUniforms(*variants[mode]);
+            if (!variants[mode]->IsReady()) continue;
+            variants[mode]->Activate();
+            uniforms[mode].tex0.Set((int)kMaterialTextureUnit);
         }
     }
-    std::cout << "Generated Wavy Ground: " << outGroundVertices.size() / 11 << " vertices, " << outGroundIndices.size() / 3 << " triangles." << std::endl;
-}
-// --- Koniec funkcji pomocniczych ---
+    Shader& Program() const { return *variants[currentLightingMode]; }
+    const LitUniforms& Uniforms() const { return uniforms[currentLightingMode]; }
+};
 
-static int currentLightingMode = 3;
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods) {
     if (action == GLFW_PRESS) {
         if (key == GLFW_KEY_1) { currentLightingMode = 0; std::cout << "Tryb: Ambient" << std::endl; }
@@ -161,12 +135,29 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
         else if (key == GLFW_KEY_3) { currentLightingMode = 2; std::cout << "Tryb: Specular (+Ambient)" << std::endl; }
         else if (key == GLFW_KEY_4) { currentLightingMode = 3; std::cout << "Tryb: Pełne (ADS)" << std::endl; }
         else if (key == GLFW_KEY_L) {
-            currentLightingMode = (currentLightingMode + 1) % 4;
+            currentLightingMode = (currentLightingMode + 1) % kLightingModeCount;
             if (currentLightingMode == 0) std::cout << "Tryb: Ambient" << std::endl;
             else if (currentLightingMode == 1) std::cout << "Tryb: Diffuse" << std::endl;
             else if (currentLightingMode == 2) std::cout << "Tryb: Specular (+Ambient)" << std::endl;
             else if (currentLightingMode == 3) std::cout << "Tryb: Pełne (ADS)" << std::endl;
         }
+        else if (key == GLFW_KEY_T) {
+            currentTerrainMode = (currentTerrainMode + 1) % TERRAIN_MODE_COUNT;
+            std::cout << terrainModeName(currentTerrainMode) << std::endl;
+        }
+        else if (key == GLFW_KEY_LEFT_BRACKET || key == GLFW_KEY_RIGHT_BRACKET) {
+            terrainWaveAmplitude += (key == GLFW_KEY_RIGHT_BRACKET) ? 0.05f : -0.05f;
+            if (terrainWaveAmplitude < 0.0f) terrainWaveAmplitude = 0.0f;
+            std::cout << "Amplituda fali (tryby GPU): " << terrainWaveAmplitude << std::endl;
+        }
+        else if (key == GLFW_KEY_MINUS || key == GLFW_KEY_EQUAL) {
+            terrainWaveFrequency += (key == GLFW_KEY_EQUAL) ? 0.1f : -0.1f;
+            if (terrainWaveFrequency < 0.1f) terrainWaveFrequency = 0.1f;
+            std::cout << "Częstotliwość fali (tryby GPU): " << terrainWaveFrequency << std::endl;
+        }
+        else if (key == GLFW_KEY_P) {
+            profileExportRequested = true;
+        }
     }
 }
 
@@ -207,88 +198,205 @@ std::vector<std::string> skyboxFaces = {
 };
 // -----------------------------------------
 
-int main() {
-    glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "Projekt OpenGL + Skybox", NULL, NULL);
-    if (window == NULL) { std::cout << "Nie udało się utworzyć okna GLFW" << std::endl; glfwTerminate(); return -1; }
+int main(int argc, char** argv) {
+    // Tryb benchmarku (--benchmark sciezka.txt): kontekst bez okna, kamera ze ścieżki, stały krok czasu, wynik w JSON
+    BenchmarkSettings benchmark;
+    std::string argumentError;
+    if (!parseBenchmarkArguments(argc, argv, benchmark, argumentError)) { std::cerr << argumentError << std::endl; return -1; }
+    CameraPath cameraPath;
+    if (!benchmark.cameraPathFile.empty() && !cameraPath.Load(benchmark.cameraPathFile, argumentError)) { std::cerr << "Ścieżka kamery: " << argumentError << std::endl; return -1; }
+    // Bramka regresji (--regress ujecia.txt): jak benchmark, ale nieruchome ujęcia x tryby oświetlenia, porównanie z obrazami wzorcowymi
+    const bool regression = !benchmark.regressionPosesFile.empty();
+    RegressionGate regressionGate(benchmark);
+    if (regression && !regressionGate.Load(argumentError)) { std::cerr << "Regresja: " << argumentError << std::endl; return -1; }
+
+    GLFWwindow* window = NULL;
+    std::string contextDescription = "okno";
+    if (benchmark.enabled) {
+        window = createOffscreenContext(SCR_WIDTH, SCR_HEIGHT, contextDescription);
+        if (window == NULL) { std::cout << "Nie udało się utworzyć kontekstu GL bez okna" << std::endl; return -1; }
+    }
+    else {
+        glfwInit();
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "Projekt OpenGL + Skybox", NULL, NULL);
+        if (window == NULL) { std::cout << "Nie udało się utworzyć okna GLFW" << std::endl; glfwTerminate(); return -1; }
+    }
     glfwMakeContextCurrent(window);
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) { std::cout << "Nie udało się zainicjalizować GLAD" << std::endl; return -1; }
+    loadGLExtensions((GLADloadproc)glfwGetProcAddress);
 
-    glEnable(GL_DEPTH_TEST); // Włączone globalnie
+    GLState::SetCapability(GL_DEPTH_TEST, true); // Włączone globalnie
     glViewport(0, 0, SCR_WIDTH, SCR_HEIGHT);
     glfwSetKeyCallback(window, key_callback);
 
-    std::srand(static_cast<unsigned int>(std::time(0)));
-    std::mt19937 rng(static_cast<unsigned int>(std::time(0)));
+    // Benchmark: stałe ziarno - te same kaktusy i piramidy przy każdym pomiarze
+    const unsigned int sceneSeed = benchmark.enabled ? 2025u : static_cast<unsigned int>(std::time(0));
+    std::srand(sceneSeed);
+    std::mt19937 rng(sceneSeed);
     std::uniform_real_distribution<float> dist(0.0f, 360.0f);
 
     Camera camera(SCR_WIDTH, SCR_HEIGHT, glm::vec3(0.0f, 2.0f, 10.0f));
-    Shader pyramidShaderProgram("default.vert", "default.frag"); 
-    Shader sunShaderProgram("sun.vert", "sun.frag");        
-
-    
-    if (pyramidShaderProgram.ID == 0) { std::cerr << "Shader 'default' nie załadowany." << std::endl; return -1; }
-    if (sunShaderProgram.ID == 0) { std::cerr << "Shader 'sun' nie załadowany." << std::endl; return -1; }
+    std::cout << "Teren: sciezka SIMD " << heightSimdLevelName(getHeightSimdLevel()) << std::endl;
+    // Zlinkowane programy zapisywane na dysku - kolejne uruchomienia pomijają kompilację GLSL
+    ProgramBinaryCache programCache("cache");
+    Shader::SetProgramCache(&programCache);
+    // Programy budowane w tle: źródła czytane w puli wątków, kompilacja zgłaszana w shaderBuilder.Poll().
+    // Dopóki program nie jest gotowy (IsReady), geometria rysowana jest programem zastępczym albo pomijana.
+    ShaderBuilder shaderBuilder(ThreadPool::Shared());
+    // Programy oświetlane: po jednym wariancie default.frag na tryb oświetlenia (LIGHTING_* w lightingDefines)
+    ShaderPermutations pyramidPermutations(shaderBuilder, "default.vert", "default.frag"); // pełne wierzchołki (11 floatów) - kafle strumieniowane
+    ShaderPermutations packedPermutations(shaderBuilder, "default_packed.vert", "default.frag"); // skompresowane wierzchołki - stały teren i piramidy
+    ShaderPermutations cactusPermutations(shaderBuilder, "default_instanced.vert", "default.frag"); // kaktusy rysowane instancyjnie
+    ShaderPermutations terrainPermutations(shaderBuilder, "terrain.vert", "default.frag"); // teren CDLOD - wysokość liczona w shaderze
+    LitProgramSet pyramidPrograms(pyramidPermutations);
+    LitProgramSet packedPrograms(packedPermutations);
+    LitProgramSet cactusPrograms(cactusPermutations);
+    LitProgramSet terrainPrograms(terrainPermutations, ShaderDefines().Set("TERRAIN_MAX_LEVELS", TerrainLOD::kMaxLevels));
+    LitProgramSet* litProgramSets[] = { &pyramidPrograms, &packedPrograms, &cactusPrograms, &terrainPrograms };
+    Shader sunShaderProgram(shaderBuilder, "sun.vert", "sun.frag");
+    // Zastępczy program (kolor światła, tylko pozycja z lokacji 0) - mały, kompilowany od razu
+    Shader fallbackShaderProgram("light.vert", "light.frag");
+    if (fallbackShaderProgram.ID == 0) { std::cerr << "Shader 'light' nie załadowany." << std::endl; return -1; }
+    fallbackShaderProgram.BindUniformBlock(kFrameDataBlockName, kFrameDataBinding);
+    UniformHandle<glm::mat4> fallbackModelUniform = fallbackShaderProgram.Uniform<glm::mat4>("model");
+
+    FrameUniformBuffer frameUniforms;
+    std::vector<Shader*> framePrograms(1, &sunShaderProgram);
+    for (LitProgramSet* programSet : litProgramSets) {
+        framePrograms.insert(framePrograms.end(), programSet->variants, programSet->variants + kLightingModeCount);
+    }
+    UniformHandle<glm::mat4> sunModelUniform;
+    UniformHandle<glm::vec4> sunColorUniform;
+    UniformHandle<float> sunTexCoordScaleUniform;
+    // Po zlinkowaniu kolejnych programów: blok FrameData i uchwyty uniformów rozwiązywane na nowo
+    auto onProgramsReady = [&]() {
+        for (Shader* program : framePrograms) {
+            if (program->IsReady() && !program->BindUniformBlock(kFrameDataBlockName, kFrameDataBinding)) {
+                std::cerr << "Shader (ID: " << program->ID << ") nie ma bloku " << kFrameDataBlockName << std::endl;
+            }
+        }
+        for (LitProgramSet* programSet : litProgramSets) programSet->ResolveUniforms();
+        sunModelUniform = sunShaderProgram.Uniform<glm::mat4>("model");
+        sunColorUniform = sunShaderProgram.Uniform<glm::vec4>("sunColor");
+        sunTexCoordScaleUniform = sunShaderProgram.Uniform<float>("u_texCoordScale");
+        if (sunShaderProgram.IsReady()) {
+            sunShaderProgram.Activate();
+            sunShaderProgram.Uniform<int>("sunTexture").Set((int)kSunTextureUnit);
+        }
+        if (shaderBuilder.PendingCount() == 0) {
+            std::cout << "Programy shaderów gotowe (" << (float)glfwGetTime() << " s od startu), błędów: " << shaderBuilder.FailedCount() << std::endl;
+            if (programCache.IsAvailable()) {
+                std::cout << "Programy shaderów: " << programCache.Hits() << " z cache, " << programCache.Misses() << " skompilowanych" << std::endl;
+            }
+        }
+    };
+    if (shaderBuilder.Poll() > 0) onProgramsReady();
+
+    // Tekstury dekodowane w puli wątków i wysyłane przez PBO w textureLoader.Poll() (budżet na klatkę);
+    // do tego czasu każda rysowana jest z szarym placeholderem 1x1 - start nie czeka na dekodowanie PNG/JPG
+    TextureLoader textureLoader(ThreadPool::Shared());
+    // BC1/BC3 z mipmapami kodowane przy pierwszym uruchomieniu, potem mapowane z cache (bez dekodowania PNG/JPG)
+    TextureCache textureCache("cache");
+    textureLoader.SetCompressedCache(&textureCache);
+    Texture sunTexture(textureLoader, "sun_texture.png", GL_TEXTURE_2D, kSunTextureUnit, GL_UNSIGNED_BYTE);
+    // Piasek piramid, piasek terenu i kaktusy w jednej GL_TEXTURE_2D_ARRAY (rozmiar warstwy z najmniejszego źródła,
+    // BC1/BC3 z tego samego cache i przez ten sam loader co słońce) - bez przełączania tekstur między obiektami
+    std::vector<std::string> materialFiles(MATERIAL_COUNT);
+    materialFiles[MATERIAL_PYRAMID_SAND] = "sand_texture.png";
+    materialFiles[MATERIAL_GROUND_SAND] = "groundSand_texture.png";
+    materialFiles[MATERIAL_CACTUS] = "cactus_texture.jpg";
+    TextureArray materials(textureLoader, materialFiles, kMaterialTextureUnit);
 
-    
     Skybox skybox("skybox.vert", "skybox.frag"); 
-    if (!skybox.loadCubemap(skyboxFaces)) {
+    if (!skybox.loadCubemap(skyboxFaces, ThreadPool::Shared())) {
         std::cerr << "Nie udało się załadować tekstur skyboxa." << std::endl;
         
         return -1;
     }
+    // Niebo z modelu rozpraszania: tablice liczone w puli przy starcie, tablica widoku - gdy słońce przesunie się o > 0.5°
+    Atmosphere atmosphere(ThreadPool::Shared(), kSkyViewTextureUnit);
+    skybox.SetAtmosphere(&atmosphere);
 
-    Texture pyramidTexture("sand_texture.png", GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE);
-    Texture sunTexture("sun_texture.png", GL_TEXTURE_2D, 1, GL_RGBA, GL_UNSIGNED_BYTE);
-    Texture groundSandTexture("groundSand_texture.png", GL_TEXTURE_2D, 2, GL_RGBA, GL_UNSIGNED_BYTE);
-    Texture cactusTexture("cactus_texture.jpg", GL_TEXTURE_2D, 3, GL_RGBA, GL_UNSIGNED_BYTE);
-    
 
-
-    std::vector<GLfloat> groundVerticesVec;
-    std::vector<GLuint> groundIndicesVec;
     int segmentsX = 60; int segmentsZ = 60; float totalGroundWidth = 6.0f; float totalGroundDepth = 6.0f;
     float waveAmplitude = 0.25f; float waveFrequency = 0.8f; float textureTiling = 8.0f;
-    generateWavyGround(segmentsX, segmentsZ, totalGroundWidth, totalGroundDepth, waveAmplitude, waveFrequency, textureTiling, groundVerticesVec, groundIndicesVec);
     float groundGenWaveAmplitude = waveAmplitude; float groundGenWaveFrequency = waveFrequency;
 
+    // Nieskończony teren: kafle o gęstości stałego terenu generowane w tle wokół kamery
+    TerrainChunkSettings chunkSettings;
+    chunkSettings.chunkSize = totalGroundWidth;
+    chunkSettings.segments = segmentsX;
+    chunkSettings.waveAmplitude = waveAmplitude;
+    chunkSettings.waveFrequency = waveFrequency;
+    chunkSettings.textureTiling = textureTiling;
+    TerrainChunkManager terrainChunks(chunkSettings, ThreadPool::Shared());
+
+    // Teren CDLOD: stały budżet trójkątów niezależnie od rozmiaru świata
+    TerrainLODSettings lodSettings;
+    lodSettings.waveAmplitude = waveAmplitude;
+    lodSettings.waveFrequency = waveFrequency;
+    lodSettings.textureTiling = textureTiling;
+    lodSettings.textureWorldSize = totalGroundWidth;
+    TerrainLOD terrainLOD(lodSettings);
+
+    // Teren z płaskiej siatki - tylko vec2 na wierzchołek, wysokość i normalna w terrain.vert
+    terrainWaveAmplitude = waveAmplitude; terrainWaveFrequency = waveFrequency;
+    TerrainGrid terrainGrid(segmentsX);
+    std::cout << "Wierzchołki terenu: siatka CPU " << (size_t)(segmentsX + 1) * (segmentsZ + 1) * 11 * sizeof(GLfloat) << " B, siatka GPU " << terrainGrid.VertexBytes() << " B" << std::endl;
+
+    // Stały teren, piramidy i sfera w formacie PackedVertex (16 B/wierzchołek, kolor pominięty)
+    // Przed pakowaniem: kolejność trójkątów pod cache wierzchołków, kolejność wierzchołków pod odczyt VBO, indeksy 16-bit.
+    // Teren i sfera trafiają do cache/ - przy niezmienionych parametrach kolejne uruchomienia tylko mapują plik.
+    MeshCache meshCache("cache");
+    MeshCacheKey groundKey("ground");
+    groundKey.Add(segmentsX).Add(segmentsZ).Add(totalGroundWidth).Add(totalGroundDepth)
+        .Add(waveAmplitude).Add(waveFrequency).Add(textureTiling).Add(kVertexCacheSize);
+    CachedMesh groundMesh;
+    meshCache.LoadOrBuild(groundKey, [&](PackedMesh& packed, IndexData& indices, std::vector<MeshSection>&) {
+        std::vector<GLfloat> groundVerticesVec;
+        std::vector<GLuint> groundIndicesVec;
+        generateWavyGround(segmentsX, segmentsZ, totalGroundWidth, totalGroundDepth, waveAmplitude, waveFrequency, textureTiling, groundVerticesVec, groundIndicesVec, &ThreadPool::Shared());
+        size_t groundVertexCount = groundVerticesVec.size() / 11;
+        indices = optimizeMesh("teren", groundIndicesVec, groundVerticesVec.data(), groundVertexCount, 11);
+        packed = packVertices(groundVerticesVec.data(), groundVertexCount, 11, 0, 6, 8);
+    }, groundMesh);
+    GLsizei groundIndexCount = groundMesh.indexCount;
+    GLenum groundIndexType = groundMesh.indexType;
+    float groundTexCoordScale = groundMesh.texCoordScale;
+    GLsizei groundVertexCount = groundMesh.vertexCount;
     VAO groundVAO; groundVAO.Bind();
-    VBO groundVBO(groundVerticesVec.data(), groundVerticesVec.size() * sizeof(GLfloat));
-    EBO groundEBO(groundIndicesVec.data(), groundIndicesVec.size() * sizeof(GLuint));
-    groundVAO.LinkAttrib(groundVBO, 0, 3, GL_FLOAT, 11 * sizeof(float), (void*)0); // aPos
-    groundVAO.LinkAttrib(groundVBO, 1, 3, GL_FLOAT, 11 * sizeof(float), (void*)(3 * sizeof(float))); // aColor
-    groundVAO.LinkAttrib(groundVBO, 2, 2, GL_FLOAT, 11 * sizeof(float), (void*)(6 * sizeof(float))); // aTex
-    groundVAO.LinkAttrib(groundVBO, 3, 3, GL_FLOAT, 11 * sizeof(float), (void*)(8 * sizeof(float))); // aNormal
-
+    VBO groundVBO(groundMesh.vertexData, groundMesh.vertexBytes, GL_STATIC_DRAW);
+    EBO groundEBO(groundMesh.indexData, groundMesh.indexBytes, GL_STATIC_DRAW);
+    linkPackedVertexAttribs(groundVAO, groundVBO);
+    groundMesh.Release();
+
+    std::vector<GLuint> pyramidIndexList(pyramidIndices, pyramidIndices + sizeof(pyramidIndices) / sizeof(GLuint));
+    size_t pyramidVertexCount = sizeof(pyramidVertices) / (11 * sizeof(GLfloat));
+    IndexData pyramidIndexData = optimizeMesh("piramida", pyramidIndexList, pyramidVertices, pyramidVertexCount, 11);
+    PackedMesh pyramidPacked = packVertices(pyramidVertices, pyramidVertexCount, 11, 0, 6, 8);
     VAO pyramidVAO; pyramidVAO.Bind();
-    VBO pyramidVBO(pyramidVertices, sizeof(pyramidVertices));
-    EBO pyramidEBO(pyramidIndices, sizeof(pyramidIndices));
-    pyramidVAO.LinkAttrib(pyramidVBO, 0, 3, GL_FLOAT, 11 * sizeof(float), (void*)0);
-    pyramidVAO.LinkAttrib(pyramidVBO, 1, 3, GL_FLOAT, 11 * sizeof(float), (void*)(3 * sizeof(float)));
-    pyramidVAO.LinkAttrib(pyramidVBO, 2, 2, GL_FLOAT, 11 * sizeof(float), (void*)(6 * sizeof(float)));
-    pyramidVAO.LinkAttrib(pyramidVBO, 3, 3, GL_FLOAT, 11 * sizeof(float), (void*)(8 * sizeof(float)));
-
-    std::vector<GLfloat> sphereVertices; std::vector<GLuint> sphereIndices;
+    VBO pyramidVBO(pyramidPacked.vertices.data(), pyramidPacked.vertices.size() * sizeof(PackedVertex), GL_STATIC_DRAW);
+    EBO pyramidEBO(pyramidIndexData.Data(), pyramidIndexData.Bytes(), GL_STATIC_DRAW);
+    linkPackedVertexAttribs(pyramidVAO, pyramidVBO);
+
+    // Sfera dla kaktusów i słońca: łańcuch LOD we wspólnym VBO/EBO, poziom wybierany co klatkę z rozmiaru na ekranie
     float baseSphereRadius = 0.5f;
-    generateSphere(baseSphereRadius, 36, 18, sphereVertices, sphereIndices);
-    GLsizei sphereIndexCount = sphereIndices.size();
-
-    VAO cactusSphereVAO; cactusSphereVAO.Bind();
-    VBO sphereVBO(sphereVertices.data(), sphereVertices.size() * sizeof(GLfloat));
-    EBO sphereEBO(sphereIndices.data(), sphereIndices.size() * sizeof(GLuint));
-    cactusSphereVAO.LinkAttrib(sphereVBO, 0, 3, GL_FLOAT, 8 * sizeof(float), (void*)0);
-    cactusSphereVAO.LinkAttrib(sphereVBO, 1, 3, GL_FLOAT, 8 * sizeof(float), (void*)(3 * sizeof(float))); // dummy color
-    cactusSphereVAO.LinkAttrib(sphereVBO, 2, 2, GL_FLOAT, 8 * sizeof(float), (void*)(6 * sizeof(float)));
-    cactusSphereVAO.LinkAttrib(sphereVBO, 3, 3, GL_FLOAT, 8 * sizeof(float), (void*)(3 * sizeof(float))); // normal
-
-    VAO sunVAO; sunVAO.Bind();
-    sphereVBO.Bind(); sphereEBO.Bind(); // Re-bind shared VBO/EBO
-    sunVAO.LinkAttrib(sphereVBO, 0, 3, GL_FLOAT, 8 * sizeof(float), (void*)0);
-    sunVAO.LinkAttrib(sphereVBO, 1, 3, GL_FLOAT, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-    sunVAO.LinkAttrib(sphereVBO, 2, 2, GL_FLOAT, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+    pyramidVAO.Unbind(); // konstruktor wiąże własne VBO/EBO - żadne VAO nie może być wtedy aktywne
+    SphereLODChain sphereLOD(meshCache, baseSphereRadius);
+    float sphereTexCoordScale = sphereLOD.TexCoordScale();
+
+    VAO cactusSphereVAO;
+    sphereLOD.LinkAttribs(cactusSphereVAO);
+
+    VAO sunVAO;
+    sphereLOD.LinkAttribs(sunVAO);
+
+    size_t floatVertexBytes = (size_t)groundVertexCount * 11 * sizeof(GLfloat) + sizeof(pyramidVertices);
+    size_t packedVertexBytes = ((size_t)groundVertexCount + pyramidPacked.vertices.size()) * sizeof(PackedVertex);
+    std::cout << "Wierzchołki (teren, piramida): " << floatVertexBytes << " B -> " << packedVertexBytes << " B po kompresji" << std::endl;
 
     // Pozycje, skale, rotacje piramid 
     glm::vec3 pyramidPositions[] = { /* ... */ glm::vec3(0.9f, 0.0f, -0.3f), glm::vec3(-0.7f, 0.0f, 0.0f), glm::vec3(0.2f, 0.0f, -1.5f), glm::vec3(-1.5f, 0.0f, -1.0f) };
@@ -301,26 +409,99 @@ int main() {
     };
     glm::vec3 cactusPositionsXZ[] = { /* ... */ glm::vec3(1.5f, 0.0f, 0.5f), glm::vec3(-1.0f, 0.0f, 1.0f), glm::vec3(0.0f, 0.0f, -2.0f), glm::vec3(-2.0f, 0.0f, -1.5f), glm::vec3(2.0f, 0.0f, 1.5f) };
     int numCacti = sizeof(cactusPositionsXZ) / sizeof(glm::vec3);
+    // Wypieczona siatka wysokości do osadzania obiektów na terenie (zamiast pełnego getHeight na każde zapytanie)
+    HeightField groundHeightField(glm::vec2(-totalGroundWidth * 0.5f, -totalGroundDepth * 0.5f), totalGroundWidth, 256,
+        groundGenWaveAmplitude, groundGenWaveFrequency, HeightFieldLayout::Morton, &ThreadPool::Shared());
+    std::cout << "HeightField " << groundHeightField.PointsPerSide() << "x" << groundHeightField.PointsPerSide()
+              << ": maks. błąd <= " << groundHeightField.ErrorBound() << " (zmierzony " << groundHeightField.MeasureMaxError(4096) << ")" << std::endl;
     std::vector<Cactus> cacti;
     for (int i = 0; i < numCacti; ++i) {
         glm::vec3 posXZ = cactusPositionsXZ[i];
-        float groundHeight = getHeight(posXZ.x, posXZ.z, groundGenWaveAmplitude, groundGenWaveFrequency);
+        float groundHeight = groundHeightField.Sample(posXZ.x, posXZ.z);
         float randomYRotation = dist(rng);
         cacti.push_back(Cactus(glm::vec3(posXZ.x, groundHeight, posXZ.z), randomYRotation));
     }
+    // Macierze wszystkich części wszystkich kaktusów w VBO instancji podpiętym do cactusSphereVAO
+    CactusBatch cactusBatch(cactusSphereVAO, standardCactusPartsData);
 
     float dayNightCycleSpeed = 0.05f; float sunPathRadius = 5.0f; float sunMaxHeight = 3.5f;
     float sunMinHeight = -0.5f; float sunPathDepth = -3.0f; float sunRadius = 0.05f;
     glm::vec3 pyramidCenter(0.0f); if (numPyramids > 0) { for (int i = 0; i < numPyramids; ++i) { pyramidCenter += pyramidPositions[i]; } pyramidCenter /= numPyramids; }
     glm::vec3 groundOffset = glm::vec3(pyramidCenter.x, 0.0f, pyramidCenter.z);
 
+    // Benchmark mierzy gotową scenę: programy i tekstury ładowane w tle są kończone przed pierwszą klatką
+    std::unique_ptr<RenderTarget> offscreenTarget;
+    BenchmarkRecorder benchmarkRecorder;
+    if (benchmark.enabled) {
+        offscreenTarget = std::make_unique<RenderTarget>(SCR_WIDTH, SCR_HEIGHT);
+        if (!offscreenTarget->IsComplete()) { std::cerr << "Framebuffer benchmarku niekompletny" << std::endl; return -1; }
+        if (shaderBuilder.Finish() > 0) onProgramsReady();
+        textureLoader.Finish();
+        if (regression) {
+            std::cout << "Regresja (" << contextDescription << ", " << (const char*)glGetString(GL_RENDERER) << "): " << regressionGate.CaseCount()
+                      << " przypadków po " << benchmark.warmupFrames << " + " << benchmark.frames << " klatek, wzorce w " << benchmark.goldenDirectory
+                      << (benchmark.updateGolden ? " (zapis)" : "") << std::endl;
+        }
+        else {
+            std::cout << "Benchmark (" << contextDescription << ", " << (const char*)glGetString(GL_RENDERER) << "): " << benchmark.warmupFrames << " + "
+                      << benchmark.frames << " klatek, ścieżka " << benchmark.cameraPathFile << " (" << cameraPath.Duration() << " s)" << std::endl;
+        }
+    }
+    BenchmarkRecorder& recorder = regression ? regressionGate.Recorder() : benchmarkRecorder;
+    const unsigned long long benchmarkFrames = (unsigned long long)benchmark.warmupFrames + benchmark.frames;
+
+    // Pozycja słońca na ścieżce dnia i nocy w chwili time (sekundy)
+    auto sunPosition = [&](float time) {
+        float normalizedTime = fmod(time * dayNightCycleSpeed, 2.0f);
+        float pathParam = (normalizedTime < 1.0f) ? normalizedTime : (2.0f - normalizedTime);
+        float lightX = -sunPathRadius + (2.0f * sunPathRadius * pathParam);
+        float angleY = pathParam * M_PI;
+        float lightY = sin(angleY) * (sunMaxHeight - sunMinHeight) + sunMinHeight;
+        return glm::vec3(lightX, lightY, sunPathDepth);
+    };
+
     // Pętla renderowania
-    while (!glfwWindowShouldClose(window)) {
-        float currentTime = (float)glfwGetTime();
+    unsigned long long renderedFrames = 0;
+    // Czasy CPU i GPU przebiegów klatki; wyniki zapytań GPU czytane z opóźnieniem kilku klatek, bez czekania
+    Profiler profiler;
+    GLState::ResetCounters(); // tylko wywołania z pętli - bez ładowania zasobów
+    while (regression ? !regressionGate.Done() : benchmark.enabled ? renderedFrames < benchmarkFrames : !glfwWindowShouldClose(window)) {
+        const bool measuredFrame = regression ? regressionGate.IsMeasuredFrame()
+                                              : benchmark.enabled && renderedFrames >= (unsigned long long)benchmark.warmupFrames;
+        if (regression) {
+            currentLightingMode = regressionGate.LightingMode();
+            // Statystyki profilera tylko z mierzonych klatek przypadku - wyniki rozgrzewki odczytane i odrzucone
+            if (regressionGate.IsFirstMeasuredFrame()) { profiler.Flush(); profiler.ResetStats(); }
+        }
+        // Benchmark: zegar symulacji (klatka * krok) - słońce i kamera w tych samych miejscach niezależnie od szybkości maszyny
+        float currentTime = regression ? regressionGate.Pose().time
+                          : benchmark.enabled ? (float)(renderedFrames * benchmark.timeStep) : (float)glfwGetTime();
+        glm::vec3 lightPos = sunPosition(currentTime);
+        // Benchmark czeka na przeliczenie nieba (powtarzalne klatki) przed początkiem pomiaru - przeliczenie na CPU
+        // trwa dziesiątki ms co kilka klatek i zakryłoby czasy renderera
+        if (benchmark.enabled) atmosphere.Finish(lightPos);
+        if (measuredFrame) recorder.BeginFrame();
+        if (offscreenTarget) offscreenTarget->Bind();
+        profiler.BeginFrame();
+        profiler.Begin("aktualizacja");
+        if (shaderBuilder.PendingCount() > 0 && shaderBuilder.Poll() > 0) onProgramsReady();
+        if (textureLoader.PendingCount() > 0) {
+            textureLoader.Poll();
+            if (textureLoader.PendingCount() == 0) {
+                std::cout << "Tekstury gotowe (" << (float)glfwGetTime() << " s od startu), błędów: " << textureLoader.FailedCount()
+                          << ", wysłano " << textureLoader.UploadedBytes() / 1024 << " KB (RGBA8: " << textureLoader.UncompressedBytes() / 1024
+                          << " KB), klatek odłożonych: " << textureLoader.DeferredFrames() << ", z cache: " << textureCache.Hits() << std::endl;
+            }
+        }
         glClearColor(0.45f, 0.55f, 0.65f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        camera.Inputs(window);
+        if (regression) {
+            camera.Position = regressionGate.Pose().position;
+            camera.Orientation = glm::normalize(regressionGate.Pose().target - camera.Position);
+        }
+        else if (benchmark.enabled) cameraPath.Evaluate(cameraPath.StartTime() + currentTime, camera.Position, camera.Orientation);
+        else camera.Inputs(window);
        
         float FOV = 45.0f;
         float nearPlane = 0.1f;
@@ -331,81 +512,181 @@ int main() {
 
         glm::vec4 lightColor = glm::vec4(1.0f, 0.9f, 0.75f, 1.0f);
         glm::vec4 sunTintColor = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
-        float normalizedTime = fmod(currentTime * dayNightCycleSpeed, 2.0f);
-        float pathParam = (normalizedTime < 1.0f) ? normalizedTime : (2.0f - normalizedTime);
-        float lightX = -sunPathRadius + (2.0f * sunPathRadius * pathParam);
-        float angleY = pathParam * M_PI;
-        float lightY = sin(angleY) * (sunMaxHeight - sunMinHeight) + sunMinHeight;
-        float lightZ = sunPathDepth;
-        glm::vec3 lightPos = glm::vec3(lightX, lightY, lightZ);
 
+        // Kamera, światło i tryb oświetlenia - jeden zapis na klatkę, widoczny dla wszystkich programów i skyboxa
+        FrameData frameData;
+        frameData.camMatrix = combinedCamMatrix;
+        frameData.view = currentViewMatrix;
+        frameData.projection = currentProjectionMatrix;
+        frameData.lightColor = lightColor;
+        frameData.lightPos = lightPos;
+        frameData.time = currentTime;
+        frameData.camPos = camera.Position;
+        frameData.reserved = 0;
+        frameUniforms.Update(frameData);
+        // niebo nad środkiem sceny - kierunek do słońca to lightPos (benchmark: Finish przed pomiarem klatki)
+        if (!benchmark.enabled) atmosphere.Update(lightPos);
+
+        // Warianty programów dla bieżącego trybu oświetlenia (przełączany w key_callback)
+        Shader& pyramidShaderProgram = pyramidPrograms.Program();
+        Shader& packedShaderProgram = packedPrograms.Program();
+        Shader& cactusShaderProgram = cactusPrograms.Program();
+        Shader& terrainShaderProgram = terrainPrograms.Program();
+        const LitUniforms& pyramidUniforms = pyramidPrograms.Uniforms();
+        const LitUniforms& packedUniforms = packedPrograms.Uniforms();
+        const LitUniforms& cactusUniforms = cactusPrograms.Uniforms();
+        const LitUniforms& terrainUniforms = terrainPrograms.Uniforms();
+
+        profiler.End();
+
+        profiler.Begin("teren");
+        materials.Bind(); // jedna tablica dla terenu, kaktusów i piramid - dalej tylko u_layer
         pyramidShaderProgram.Activate();
-        // camera.Matrix(pyramidShaderProgram, "camMatrix"); 
-        pyramidShaderProgram.setMat4("camMatrix", combinedCamMatrix);
-        pyramidShaderProgram.setVec4("lightColor", lightColor);
-        pyramidShaderProgram.setVec3("lightPos", lightPos);
-        pyramidShaderProgram.setVec3("camPos", camera.Position);
-        pyramidShaderProgram.setInt("u_lightingMode", currentLightingMode);
-        glm::mat4 groundModel = glm::translate(glm::mat4(1.0f), groundOffset);
-        pyramidShaderProgram.setMat4("model", groundModel);
-        groundSandTexture.texUnit(pyramidShaderProgram, "tex0");
-        groundSandTexture.Bind();
-        groundVAO.Bind();
-        pyramidShaderProgram.setFloat("u_specularStrength", 0.05f);
-        glDrawElements(GL_TRIANGLES, groundIndicesVec.size(), GL_UNSIGNED_INT, 0);
-
-        cactusTexture.texUnit(pyramidShaderProgram, "tex0");
-        cactusTexture.Bind();
-        cactusSphereVAO.Bind();
-        pyramidShaderProgram.setFloat("u_specularStrength", 0.2f);
-        for (const auto& cactus_instance : cacti) { 
-            cactus_instance.Draw(pyramidShaderProgram, sphereIndexCount, standardCactusPartsData);
+        pyramidUniforms.layer.Set((int)MATERIAL_GROUND_SAND);
+        pyramidUniforms.specularStrength.Set(0.05f);
+
+        if (currentTerrainMode == TERRAIN_STREAMED) {
+            Shader& chunkShader = pyramidShaderProgram.IsReady() ? pyramidShaderProgram : fallbackShaderProgram;
+            chunkShader.Activate();
+            terrainChunks.Update(camera.Position);
+            terrainChunks.Draw(chunkShader);
+        }
+        else if (currentTerrainMode == TERRAIN_CDLOD || currentTerrainMode == TERRAIN_GPU_GRID) {
+            // Siatka terenu ma tylko vec2 (aGrid) - zastępczy program jej nie narysuje; do zlinkowania wariantu teren jest pomijany
+            if (terrainShaderProgram.IsReady()) {
+                terrainShaderProgram.Activate();
+                terrainUniforms.specularStrength.Set(0.05f);
+                terrainUniforms.layer.Set((int)MATERIAL_GROUND_SAND);
+                if (currentTerrainMode == TERRAIN_CDLOD) {
+                    terrainLOD.SetWaveParameters(terrainWaveAmplitude, terrainWaveFrequency);
+                    terrainLOD.Update(camera.Position, combinedCamMatrix);
+                    terrainLOD.Draw(terrainShaderProgram);
+                }
+                else {
+                    glm::vec2 gridOrigin(groundOffset.x - totalGroundWidth * 0.5f, groundOffset.z - totalGroundDepth * 0.5f);
+                    terrainGrid.Draw(terrainShaderProgram, gridOrigin, totalGroundWidth, terrainWaveAmplitude, terrainWaveFrequency, textureTiling / totalGroundWidth);
+                }
+            }
+        }
+        else {
+            glm::mat4 groundModel = glm::translate(glm::mat4(1.0f), groundOffset);
+            const bool packedReady = packedShaderProgram.IsReady();
+            (packedReady ? packedShaderProgram : fallbackShaderProgram).Activate();
+            packedUniforms.layer.Set((int)MATERIAL_GROUND_SAND);
+            packedUniforms.specularStrength.Set(0.05f);
+            packedUniforms.texCoordScale.Set(groundTexCoordScale);
+            (packedReady ? packedUniforms.model : fallbackModelUniform).Set(groundModel);
+            groundVAO.Bind();
+            GLState::DrawElements(GL_TRIANGLES, groundIndexCount, groundIndexType, 0);
         }
 
-        
-        pyramidTexture.texUnit(pyramidShaderProgram, "tex0");
-        pyramidTexture.Bind();
+        profiler.End();
+
+        // Kaktusy - jedno wywołanie instancjonowane dla wszystkich kaktusów i ich części
+        // (macierze są atrybutami instancji, więc bez docelowego programu kaktusy są pomijane)
+        profiler.Begin("kaktusy");
+        if (cactusShaderProgram.IsReady()) {
+            cactusShaderProgram.Activate();
+            cactusUniforms.specularStrength.Set(0.2f);
+            cactusUniforms.texCoordScale.Set(sphereTexCoordScale);
+            cactusUniforms.layer.Set((int)MATERIAL_CACTUS);
+            cactusBatch.Update(cacti, sphereLOD, combinedCamMatrix, (float)SCR_HEIGHT); // wysyła macierze tylko przy zmianie pozycji lub poziomów LOD
+            cactusSphereVAO.Bind();
+            cactusBatch.Draw(sphereLOD);
+        }
+        profiler.End();
+
+        profiler.Begin("piramidy");
+        const bool pyramidsReady = packedShaderProgram.IsReady();
+        const UniformHandle<glm::mat4>& pyramidModelUniform = pyramidsReady ? packedUniforms.model : fallbackModelUniform;
+        (pyramidsReady ? packedShaderProgram : fallbackShaderProgram).Activate();
+        packedUniforms.layer.Set((int)MATERIAL_PYRAMID_SAND);
         pyramidVAO.Bind();
-        pyramidShaderProgram.setFloat("u_specularStrength", 0.7f);
+        packedUniforms.specularStrength.Set(0.7f);
+        packedUniforms.texCoordScale.Set(pyramidPacked.texCoordScale);
         for (int i = 0; i < numPyramids; ++i) {
             glm::mat4 pyramidModel_instance = glm::mat4(1.0f); 
             pyramidModel_instance = glm::translate(pyramidModel_instance, pyramidPositions[i]);
             pyramidModel_instance = glm::rotate(pyramidModel_instance, glm::radians(pyramidYRotations[i]), glm::vec3(0.0f, 1.0f, 0.0f));
             pyramidModel_instance = glm::scale(pyramidModel_instance, glm::vec3(pyramidScales[i]));
-            pyramidShaderProgram.setMat4("model", pyramidModel_instance);
-            glDrawElements(GL_TRIANGLES, sizeof(pyramidIndices) / sizeof(GLuint), GL_UNSIGNED_INT, 0);
+            pyramidModelUniform.Set(pyramidModel_instance);
+            GLState::DrawElements(GL_TRIANGLES, pyramidIndexData.count, pyramidIndexData.type, 0);
         }
+        profiler.End();
 
+        profiler.Begin("slonce");
+        const bool sunReady = sunShaderProgram.IsReady();
+        (sunReady ? sunShaderProgram : fallbackShaderProgram).Activate();
         
-        sunShaderProgram.Activate();
-        
-        sunShaderProgram.setMat4("camMatrix", combinedCamMatrix);
         glm::mat4 sunModel_instance = glm::mat4(1.0f); 
         sunModel_instance = glm::translate(sunModel_instance, lightPos);
         sunModel_instance = glm::scale(sunModel_instance, glm::vec3(sunRadius / baseSphereRadius));
-        sunShaderProgram.setMat4("model", sunModel_instance);
-        sunShaderProgram.setVec4("sunColor", sunTintColor); 
+        (sunReady ? sunModelUniform : fallbackModelUniform).Set(sunModel_instance);
+        sunColorUniform.Set(sunTintColor);
+        sunTexCoordScaleUniform.Set(sphereTexCoordScale);
         sunTexture.Bind(); 
         sunVAO.Bind();
-        glDrawElements(GL_TRIANGLES, sphereIndexCount, GL_UNSIGNED_INT, 0);
-        glDepthFunc(GL_LEQUAL); 
-        skybox.Draw(currentViewMatrix, currentProjectionMatrix);
-        glDepthFunc(GL_LESS); //  domyślna funkcję głębokości
+        sphereLOD.Draw(sphereLOD.SelectLevel(combinedCamMatrix, lightPos, sunRadius, (float)SCR_HEIGHT));
+        profiler.End();
+
+        profiler.Begin("skybox");
+        GLState::DepthFunc(GL_LEQUAL); 
+        skybox.Draw();
+        GLState::DepthFunc(GL_LESS); //  domyślna funkcję głębokości
+        profiler.End();
+        frameUniforms.EndFrame();
+        profiler.EndFrame();
+        if (measuredFrame) recorder.EndFrame();
+        if (regression) {
+            if (regressionGate.IsLastFrame()) {
+                profiler.Flush();
+                regressionGate.CompleteCase(*offscreenTarget, profiler);
+            }
+            regressionGate.Advance();
+        }
+        ++renderedFrames;
 
-        glfwSwapBuffers(window);
+        if (profileExportRequested) {
+            profileExportRequested = false;
+            profiler.PrintSummary(std::cout);
+            const bool written = profiler.WriteCsv("profile.csv") && profiler.WriteChromeTrace("profile_trace.json");
+            std::cout << (written ? "Profil zapisany: profile.csv, profile_trace.json" : "Nie udało się zapisać profilu") << std::endl;
+        }
+
+        if (!benchmark.enabled) glfwSwapBuffers(window);
         glfwPollEvents();
     }
 
+    int exitCode = 0;
+    if (regression) {
+        if (!regressionGate.Finish(std::cout)) exitCode = 1;
+    }
+    else if (benchmark.enabled) {
+        benchmarkRecorder.PrintSummary(std::cout);
+        if (!benchmarkRecorder.WriteJson(benchmark.outputFile, benchmark, contextDescription, SCR_WIDTH, SCR_HEIGHT)) {
+            std::cerr << "Nie udało się zapisać " << benchmark.outputFile << std::endl;
+        }
+    }
+
+    if (renderedFrames > 0) {
+        std::cout << "Stan GL: " << GLState::IssuedCalls() / renderedFrames << " wywołań na klatkę, "
+            << GLState::SkippedCalls() / renderedFrames << " pominiętych jako zbędne" << std::endl;
+        profiler.PrintSummary(std::cout);
+        std::cout << "Niebo: tablica widoku przeliczona " << atmosphere.RefreshCount() << " razy w " << renderedFrames << " klatkach" << std::endl;
+    }
     
     pyramidVAO.Delete(); pyramidVBO.Delete(); pyramidEBO.Delete();
-    groundVAO.Delete(); groundVBO.Delete(); groundEBO.Delete();
-    cactusSphereVAO.Delete(); sunVAO.Delete();
-    sphereVBO.Delete(); sphereEBO.Delete(); // Współdzielone VBO/EBO usuwane raz
-    pyramidTexture.Delete(); sunTexture.Delete(); groundSandTexture.Delete(); cactusTexture.Delete();
-    pyramidShaderProgram.Delete(); sunShaderProgram.Delete();
+    groundVAO.Delete(); groundVBO.Delete(); groundEBO.Delete(); terrainChunks.Delete(); terrainLOD.Delete(); terrainGrid.Delete();
+    cactusSphereVAO.Delete(); sunVAO.Delete(); cactusBatch.Delete(); frameUniforms.Delete();
+    sphereLOD.Delete(); // Współdzielone VBO/EBO usuwane raz
+    sunTexture.Delete(); materials.Delete(); atmosphere.Delete(); profiler.Delete();
+    if (offscreenTarget) offscreenTarget->Delete();
+    pyramidPermutations.Delete(); packedPermutations.Delete(); cactusPermutations.Delete(); terrainPermutations.Delete(); sunShaderProgram.Delete();
+    fallbackShaderProgram.Delete();
+    textureLoader.Delete();
     
 
     glfwDestroyWindow(window);
     glfwTerminate();
-    return 0;
+    return exitCode;
 }
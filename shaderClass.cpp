@@ -1,4 +1,10 @@
 #include "shaderClass.h"
+#include "GLState.h"
+#include "GLExtensions.h"
+#include "ProgramBinaryCache.h"
+#include "ShaderBuilder.h"
+#include "FrameUniforms.h"
+#include <cstring>
 #include <glm/gtc/type_ptr.hpp>
 
 std::string get_file_contents(const char* filename)
@@ -22,20 +28,84 @@ std::string get_file_contents(const char* filename)
 	throw std::runtime_error("Bd odczytu pliku: " + std::string(filename));
 }
 
-Shader::Shader(const char* vertexFile, const char* fragmentFile)
+ShaderDefines& ShaderDefines::Set(const std::string& name, int value)
+{
+	values[name] = value;
+	return *this;
+}
+
+std::string ShaderDefines::Source() const
+{
+	std::string text;
+	for (std::map<std::string, int>::const_iterator it = values.begin(); it != values.end(); ++it)
+	{
+		text += "#define " + it->first + " " + std::to_string(it->second) + "\n";
+	}
+	return text;
+}
+
+std::string inject_defines(const std::string& source, const ShaderDefines& defines)
+{
+	//blok FrameData zawsze (jedna kopia ukladu std140 dla wszystkich shaderow), potem definicje wariantu
+	const std::string prelude = defines.Source() + kFrameDataBlock;
+
+	//#version musi pozostac pierwsza dyrektywa - wstawka idzie do nastepnej linii
+	size_t versionPos = source.find("#version");
+	if (versionPos == std::string::npos) return prelude + source;
+	size_t lineEnd = source.find('\n', versionPos);
+	if (lineEnd == std::string::npos) return source + "\n" + prelude;
+
+	//numer linii za #version (liczony od 1) - #line przywraca numeracje pliku w logach kompilacji
+	size_t nextLine = 2;
+	for (size_t i = 0; i < versionPos; ++i)
+	{
+		if (source[i] == '\n') ++nextLine;
+	}
+	return source.substr(0, lineEnd + 1) + prelude + "#line " + std::to_string(nextLine) + "\n" + source.substr(lineEnd + 1);
+}
+
+std::string get_file_contents(const char* filename, const ShaderDefines& defines)
+{
+	return inject_defines(get_file_contents(filename), defines);
+}
+
+ProgramBinaryCache* Shader::programCache = nullptr;
+
+void Shader::SetProgramCache(ProgramBinaryCache* cache)
+{
+	programCache = cache;
+}
+
+Shader::Shader(const char* vertexFile, const char* fragmentFile, const ShaderDefines& defines)
 {
 	ID = 0; //inicjalizowanie ID na 0 na wypadek bdu
 	std::string vertexCode;
 	std::string fragmentCode;
 	try {
-		vertexCode = get_file_contents(vertexFile);
-		fragmentCode = get_file_contents(fragmentFile);
+		vertexCode = get_file_contents(vertexFile, defines);
+		fragmentCode = get_file_contents(fragmentFile, defines);
 	}
 	catch (const std::runtime_error& e) {
 		std::cerr << "BD::SHADER: Nie udao si wczyta plikw shadera: " << e.what() << std::endl;
 		return; //przerwanie konstruktora, jeli nie mona wczyta plikw
 	}
 
+	//cieply start: binarium z poprzedniego uruchomienia zamiast kompilacji i linkowania
+	const bool useCache = programCache != nullptr && programCache->IsAvailable();
+	uint64_t cacheKey = 0;
+	if (useCache)
+	{
+		cacheKey = programCache->MakeKey(vertexCode, fragmentCode);
+		ID = glCreateProgram();
+		if (programCache->Load(cacheKey, ID))
+		{
+			cacheUniformLocations();
+			return;
+		}
+		GLState::DeleteProgram(ID); //odrzucone binarium - nowy program kompilowany ze zrodel
+		ID = 0;
+	}
+
 	const char* vertexSource = vertexCode.c_str();
 	const char* fragmentSource = fragmentCode.c_str();
 
@@ -52,11 +122,80 @@ Shader::Shader(const char* vertexFile, const char* fragmentFile)
 	ID = glCreateProgram();
 	glAttachShader(ID, vertexShader);
 	glAttachShader(ID, fragmentShader);
+	if (useCache) glExtensions.ProgramParameteri(ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 	glLinkProgram(ID);
 	compileErrors(ID, "PROGRAM");
 
+	GLint linked = GL_FALSE;
+	glGetProgramiv(ID, GL_LINK_STATUS, &linked);
+	if (useCache && linked == GL_TRUE) programCache->Store(cacheKey, ID);
+
 	glDeleteShader(vertexShader);
 	glDeleteShader(fragmentShader);
+
+	cacheUniformLocations();
+}
+
+Shader::Shader(ShaderBuilder& builder, const char* vertexFile, const char* fragmentFile, const ShaderDefines& defines)
+{
+	ID = 0;
+	builder.Submit(this, vertexFile, fragmentFile, defines);
+}
+
+void Shader::cacheUniformLocations()
+{
+	uniformLocations.clear();
+	GLint linked = GL_FALSE;
+	glGetProgramiv(ID, GL_LINK_STATUS, &linked);
+	if (linked == GL_FALSE) return;
+
+	GLint uniformCount = 0;
+	GLint maxNameLength = 0;
+	glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &uniformCount);
+	glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+	std::string name(maxNameLength > 0 ? maxNameLength : 1, '\0');
+	for (GLint i = 0; i < uniformCount; ++i)
+	{
+		GLsizei nameLength = 0;
+		GLint arraySize = 0;
+		GLenum type = 0;
+		glGetActiveUniform(ID, (GLuint)i, (GLsizei)name.size(), &nameLength, &arraySize, &type, &name[0]);
+		std::string uniformName(name.data(), nameLength);
+		GLint location = glGetUniformLocation(ID, uniformName.c_str());
+		if (location < 0) continue; //uniformy z blokow (UBO) nie maja lokalizacji
+
+		//tablice zglaszane sa jako "nazwa[0]" - rejestrujemy tez sama nazwe i kazdy element
+		size_t bracket = uniformName.find('[');
+		if (bracket != std::string::npos)
+		{
+			std::string baseName = uniformName.substr(0, bracket);
+			uniformLocations[baseName] = location;
+			for (GLint element = 0; element < arraySize; ++element)
+			{
+				std::string elementName = baseName + "[" + std::to_string(element) + "]";
+				uniformLocations[elementName] = glGetUniformLocation(ID, elementName.c_str());
+			}
+		}
+		else
+		{
+			uniformLocations[uniformName] = location;
+		}
+	}
+}
+
+bool Shader::BindUniformBlock(const char* blockName, GLuint bindingPoint)
+{
+	if (ID == 0) return false;
+	GLuint blockIndex = glGetUniformBlockIndex(ID, blockName);
+	if (blockIndex == GL_INVALID_INDEX) return false;
+	glUniformBlockBinding(ID, blockIndex, bindingPoint);
+	return true;
+}
+
+GLint Shader::UniformLocation(const std::string& name) const
+{
+	std::unordered_map<std::string, GLint>::const_iterator it = uniformLocations.find(name);
+	return it != uniformLocations.end() ? it->second : -1;
 }
 
 void Shader::Activate()
@@ -65,21 +204,22 @@ void Shader::Activate()
 		//std::cerr << "aktywacja nieprawidowego shadera (ID=0)" << std::endl;
 		return;
 	}
-	glUseProgram(ID);
+	GLState::UseProgram(ID);
 }
 
 void Shader::Delete()
 {
 	if (ID == 0) return;
-	glDeleteProgram(ID);
+	GLState::DeleteProgram(ID);
 	ID = 0;
+	uniformLocations.clear();
 }
 
 void Shader::compileErrors(unsigned int shader, const char* type)
 {
 	GLint hasCompiled;
 	char infoLog[1024];
-	if (type != "PROGRAM")
+	if (std::strcmp(type, "PROGRAM") != 0) //porownanie tresci - wskazniki literalow z roznych plikow moga sie roznic
 	{
 		glGetShaderiv(shader, GL_COMPILE_STATUS, &hasCompiled);
 		if (hasCompiled == GL_FALSE)
@@ -102,49 +242,49 @@ void Shader::compileErrors(unsigned int shader, const char* type)
 //implementacje funkcji setUniform
 void Shader::setBool(const std::string& name, bool value) const
 {
-	if (ID == 0) return; glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+	if (ID == 0) return; glUniform1i(UniformLocation(name), (int)value);
 }
 void Shader::setInt(const std::string& name, int value) const
 {
-	if (ID == 0) return; glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+	if (ID == 0) return; glUniform1i(UniformLocation(name), value);
 }
 void Shader::setFloat(const std::string& name, float value) const
 {
-	if (ID == 0) return; glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+	if (ID == 0) return; glUniform1f(UniformLocation(name), value);
 }
 void Shader::setVec2(const std::string& name, const glm::vec2& value) const
 {
-	if (ID == 0) return; glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+	if (ID == 0) return; glUniform2fv(UniformLocation(name), 1, &value[0]);
 }
 void Shader::setVec2(const std::string& name, float x, float y) const
 {
-	if (ID == 0) return; glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y);
+	if (ID == 0) return; glUniform2f(UniformLocation(name), x, y);
 }
 void Shader::setVec3(const std::string& name, const glm::vec3& value) const
 {
-	if (ID == 0) return; glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+	if (ID == 0) return; glUniform3fv(UniformLocation(name), 1, &value[0]);
 }
 void Shader::setVec3(const std::string& name, float x, float y, float z) const
 {
-	if (ID == 0) return; glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
+	if (ID == 0) return; glUniform3f(UniformLocation(name), x, y, z);
 }
 void Shader::setVec4(const std::string& name, const glm::vec4& value) const
 {
-	if (ID == 0) return; glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+	if (ID == 0) return; glUniform4fv(UniformLocation(name), 1, &value[0]);
 }
 void Shader::setVec4(const std::string& name, float x, float y, float z, float w) const
 {
-	if (ID == 0) return; glUniform4f(glGetUniformLocation(ID, name.c_str()), x, y, z, w);
+	if (ID == 0) return; glUniform4f(UniformLocation(name), x, y, z, w);
 }
 void Shader::setMat2(const std::string& name, const glm::mat2& mat) const
 {
-	if (ID == 0) return; glUniformMatrix2fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+	if (ID == 0) return; glUniformMatrix2fv(UniformLocation(name), 1, GL_FALSE, &mat[0][0]);
 }
 void Shader::setMat3(const std::string& name, const glm::mat3& mat) const
 {
-	if (ID == 0) return; glUniformMatrix3fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+	if (ID == 0) return; glUniformMatrix3fv(UniformLocation(name), 1, GL_FALSE, &mat[0][0]);
 }
 void Shader::setMat4(const std::string& name, const glm::mat4& mat) const
 {
-	if (ID == 0) return; glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+	if (ID == 0) return; glUniformMatrix4fv(UniformLocation(name), 1, GL_FALSE, &mat[0][0]);
 }
\ No newline at end of file
@@ -7,19 +7,98 @@
 #include <sstream>
 #include <iostream>
 #include <cerrno>
+#include <unordered_map>
+#include <map>
 #include <glm/glm.hpp>
 
 std::string get_file_contents(const char* filename);
 
+//zestaw #define jednego wariantu (permutacji) shadera, np. LIGHTING_SPECULAR 0
+class ShaderDefines
+{
+public:
+    ShaderDefines& Set(const std::string& name, int value);
+    //dyrektywy "#define NAZWA WARTOSC" posortowane po nazwie - ten sam zestaw zawsze daje ten sam tekst (klucz wariantu)
+    std::string Source() const;
+    bool Empty() const { return values.empty(); }
+
+private:
+    std::map<std::string, int> values;
+};
+
+//wstawia blok FrameData (kFrameDataBlock, FrameUniforms.h) i definicje zaraz za linia #version
+//(i #line, zeby numery linii w bledach zgadzaly sie z plikiem)
+std::string inject_defines(const std::string& source, const ShaderDefines& defines);
+//get_file_contents + inject_defines
+std::string get_file_contents(const char* filename, const ShaderDefines& defines);
+
+class ProgramBinaryCache;
+class ShaderBuilder;
+
+//wysylanie wartosci pod znana lokalizacje - dzialaja na aktualnie aktywnym programie
+inline void setUniformValue(GLint location, bool value) { glUniform1i(location, (int)value); }
+inline void setUniformValue(GLint location, int value) { glUniform1i(location, value); }
+inline void setUniformValue(GLint location, float value) { glUniform1f(location, value); }
+inline void setUniformValue(GLint location, const glm::vec2& value) { glUniform2fv(location, 1, &value[0]); }
+inline void setUniformValue(GLint location, const glm::vec3& value) { glUniform3fv(location, 1, &value[0]); }
+inline void setUniformValue(GLint location, const glm::vec4& value) { glUniform4fv(location, 1, &value[0]); }
+inline void setUniformValue(GLint location, const glm::mat2& value) { glUniformMatrix2fv(location, 1, GL_FALSE, &value[0][0]); }
+inline void setUniformValue(GLint location, const glm::mat3& value) { glUniformMatrix3fv(location, 1, GL_FALSE, &value[0][0]); }
+inline void setUniformValue(GLint location, const glm::mat4& value) { glUniformMatrix4fv(location, 1, GL_FALSE, &value[0][0]); }
+inline void setUniformArray(GLint location, const int* values, GLsizei count) { glUniform1iv(location, count, values); }
+inline void setUniformArray(GLint location, const float* values, GLsizei count) { glUniform1fv(location, count, values); }
+inline void setUniformArray(GLint location, const glm::vec2* values, GLsizei count) { glUniform2fv(location, count, &values[0][0]); }
+inline void setUniformArray(GLint location, const glm::vec3* values, GLsizei count) { glUniform3fv(location, count, &values[0][0]); }
+inline void setUniformArray(GLint location, const glm::vec4* values, GLsizei count) { glUniform4fv(location, count, &values[0][0]); }
+inline void setUniformArray(GLint location, const glm::mat4* values, GLsizei count) { glUniformMatrix4fv(location, count, GL_FALSE, &values[0][0][0]); }
+
+//uchwyt uniformu: nazwa rozwiazywana raz (Shader::Uniform<T>), potem Set bez napisow i bez glGetUniformLocation.
+//lokalizacja -1 (uniform nieaktywny / wyciety przez kompilator) - Set nic nie robi, tak jak glUniform* dla -1.
+//program musi byc aktywny (Activate) w chwili wywolania Set.
+template<typename T>
+class UniformHandle
+{
+public:
+    UniformHandle() : location(-1) {}
+    explicit UniformHandle(GLint location) : location(location) {}
+
+    void Set(const T& value) const { if (location >= 0) setUniformValue(location, value); }
+    //tablica uniformow od elementu [0]; count nie moze przekraczac rozmiaru tablicy w shaderze
+    void Set(const T* values, GLsizei count) const { if (location >= 0 && count > 0) setUniformArray(location, values, count); }
+
+    bool IsValid() const { return location >= 0; }
+    GLint Location() const { return location; }
+
+private:
+    GLint location;
+};
+
 class Shader
 {
 public:
     GLuint ID;
-    Shader(const char* vertexFile, const char* fragmentFile);
+    Shader(const char* vertexFile, const char* fragmentFile, const ShaderDefines& defines = ShaderDefines());
+
+    //kompilacja asynchroniczna (ShaderBuilder::Poll) - ID == 0, dopoki program nie jest zlinkowany.
+    //obiektu nie wolno kopiowac ani przenosic przed IsReady (builder trzyma wskaznik)
+    Shader(ShaderBuilder& builder, const char* vertexFile, const char* fragmentFile, const ShaderDefines& defines = ShaderDefines());
+    //true, gdy program jest zlinkowany i mozna go uzywac
+    bool IsReady() const { return ID != 0; }
+
+    //pamiec podreczna binariow programow dla kolejnych konstruktorow (nullptr - zawsze kompilacja ze zrodel)
+    static void SetProgramCache(ProgramBinaryCache* cache);
 
     void Activate();
     void Delete();
 
+    //lokalizacja z pamieci podrecznej zbudowanej przy linkowaniu (-1 dla nieznanej nazwy)
+    GLint UniformLocation(const std::string& name) const;
+    //typowany uchwyt - rozwiazywac raz (np. przy inicjalizacji), nie w kazdej klatce
+    template<typename T>
+    UniformHandle<T> Uniform(const std::string& name) const { return UniformHandle<T>(UniformLocation(name)); }
+    //przypisuje blok uniformow (UBO) do punktu wiazania; false, gdy program nie ma takiego bloku
+    bool BindUniformBlock(const char* blockName, GLuint bindingPoint);
+
     //funkcje pomocnicze do ustawiania uniformw
     void setBool(const std::string& name, bool value) const;
     void setInt(const std::string& name, int value) const;
@@ -35,7 +114,16 @@ public:
     void setMat4(const std::string& name, const glm::mat4& mat) const;
 
 private:
+    friend class ShaderBuilder;
+
     //sprawdzenie bdw kompilacji/linkowania shaderw
     void compileErrors(unsigned int shader, const char* type);
+    static ProgramBinaryCache* programCache;
+
+    //wypelnia uniformLocations wszystkimi aktywnymi uniformami (GL_ACTIVE_UNIFORMS)
+    void cacheUniformLocations();
+
+    //nazwa -> lokalizacja; tablice rejestrowane jako "nazwa", "nazwa[0]", "nazwa[1]"...
+    std::unordered_map<std::string, GLint> uniformLocations;
 };
 #endif
\ No newline at end of file
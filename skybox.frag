@@ -2,10 +2,36 @@
 out vec4 FragColor;
 
 in vec3 TexCoords;
+in vec3 SunDirection;
 
 uniform samplerCube skyboxTexture;
+uniform sampler2D skyViewLut;   //radiancja nieba (Atmosphere): x - azymut wzgledem slonca 0..pi, y - wysokosc katowa
+uniform float u_atmosphere;     //0 - tablica nie jest jeszcze policzona, rysowana sama cubemapa
+
+const float PI = 3.14159265;
+const float NIGHT_CUBEMAP_SCALE = 0.25; //cubemapa przygaszona jako tlo nocnego nieba
 
 void main()
 {
-    FragColor = texture(skyboxTexture, TexCoords);
+    vec3 direction = normalize(TexCoords);
+    vec4 cubemap = texture(skyboxTexture, TexCoords);
+    if (u_atmosphere == 0.0) {
+        FragColor = cubemap;
+        return;
+    }
+
+    //Ta sama parametryzacja co przy liczeniu tablicy (Atmosphere.cpp): kwadratowo gesciej przy horyzoncie
+    float elevation = asin(clamp(direction.y, -1.0, 1.0));
+    float v = 0.5 + 0.5 * sign(elevation) * sqrt(abs(elevation) / (0.5 * PI));
+    vec2 viewXZ = direction.xz;
+    vec2 sunXZ = SunDirection.xz;
+    float cosAzimuth = dot(viewXZ, sunXZ) * inversesqrt(max(dot(viewXZ, viewXZ) * dot(sunXZ, sunXZ), 1e-8));
+    float u = acos(clamp(cosAzimuth, -1.0, 1.0)) / PI;
+    vec2 lutSize = vec2(textureSize(skyViewLut, 0));
+    vec2 uv = (vec2(u, v) * (lutSize - 1.0) + 0.5) / lutSize; //skrajne teksele odpowiadaja brzegom zakresu
+
+    vec3 radiance = texture(skyViewLut, uv).rgb;
+    vec3 sky = pow(1.0 - exp(-radiance), vec3(1.0 / 2.2));
+    float night = 1.0 - smoothstep(-0.1, 0.05, SunDirection.y);
+    FragColor = vec4(sky + cubemap.rgb * (night * NIGHT_CUBEMAP_SCALE), 1.0);
 }
\ No newline at end of file
@@ -2,13 +2,14 @@
 layout (location = 0) in vec3 aPos;
 
 out vec3 TexCoords;
+out vec3 SunDirection; //kierunek do slonca - niebo jest w nieskonczonosci, wiec liczony od srodka sceny
 
-uniform mat4 projection;
-uniform mat4 view; // Macierz widoku bez translacji
+//blok FrameData (camMatrix, view, projection, lightPos...) wstrzykiwany za #version - kFrameDataBlock w FrameUniforms.h; z view usuwana jest translacja ponizej
 
 void main()
 {
     TexCoords = aPos;
+    SunDirection = normalize(lightPos);
     // Usuń translację z macierzy widoku przed mnożeniem
     mat4 viewNoTranslation = mat4(mat3(view));
     vec4 pos = projection * viewNoTranslation * vec4(aPos, 1.0);
@@ -1,15 +1,16 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aNormal; //normalne są w danych, ale nie używane są do oświetlenia
-layout (location = 2) in vec2 aTexCoords;
+layout (location = 1) in vec3 aNormal; //nieużywane - sfera ma tylko normalną oktaedryczną (lokacja 3), słońce jej nie potrzebuje
+layout (location = 2) in vec2 aTexCoords; //unorm16 z PackedVertex
 
 out vec2 TexCoords;
 
 uniform mat4 model;
-uniform mat4 camMatrix; //View * Projection
+//blok FrameData (camMatrix, view, projection, lightColor, lightPos, u_time, camPos) wstrzykiwany za #version - kFrameDataBlock w FrameUniforms.h
+uniform float u_texCoordScale;
 
 void main()
 {
-    TexCoords = aTexCoords;
+    TexCoords = aTexCoords * u_texCoordScale;
     gl_Position = camMatrix * model * vec4(aPos, 1.0);
 }
\ No newline at end of file
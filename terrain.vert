@@ -0,0 +1,58 @@
+#version 330 core
+// Teren liczony na GPU: VBO to tylko płaska siatka, wysokość i normalna liczone w shaderze z tej samej funkcji co getHeight.
+// Używany przez CDLOD (instancje węzłów) i przez stałą płaską siatkę (TerrainGrid, bez morphingu).
+layout (location = 0) in vec2 aGrid;           //pozycja w siatce wezla (0..1)
+layout (location = 4) in vec4 aNode;           //xy = rog wezla (XZ swiata), z = bok, w = poziom LOD (< 0: bez morphingu)
+out vec2 texCoord;
+out vec3 FragPos_world;
+out vec3 Normal_world;
+//blok FrameData (camMatrix, view, projection, lightColor, lightPos, u_time, camPos) wstrzykiwany za #version - kFrameDataBlock w FrameUniforms.h
+uniform float u_waveAmplitude;
+uniform float u_waveFrequency;
+uniform float u_texScale;                      //powtorzen tekstury na jednostke swiata
+uniform float u_gridDim;                       //liczba czworokatow siatki na bok (parzysta)
+uniform vec2 u_morphConsts[TERRAIN_MAX_LEVELS]; //dla poziomu: x = poczatek, y = koniec strefy przejscia (TerrainLOD::kMaxLevels)
+
+float terrainHeight(vec2 p)
+{
+    float a = u_waveAmplitude, f = u_waveFrequency;
+    float h = a * sin((p.x + p.y * 0.5) * f);
+    h += (a * 0.4) * cos((p.x - p.y * 0.8) * f * 1.5);
+    h += (a * 0.15) * sin((p.x * 2.5 + p.y * 1.5) * f * 2.0);
+    h += (a * 0.08) * cos((p.y * 3.0 - p.x * 0.7) * f * 3.0);
+    return h / 1.63;
+}
+
+//analityczna normalna - pochodne sumy oktaw (jak calculateAnalyticNormal w Terrain.cpp)
+vec3 terrainNormal(vec2 p)
+{
+    float f = u_waveFrequency;
+    float c1 = cos((p.x + p.y * 0.5) * f);
+    float s2 = sin((p.x - p.y * 0.8) * f * 1.5);
+    float c3 = cos((p.x * 2.5 + p.y * 1.5) * f * 2.0);
+    float s4 = sin((p.y * 3.0 - p.x * 0.7) * f * 3.0);
+    float k = u_waveAmplitude * f / 1.63;
+    float dhdx = k * (c1 - 0.6 * s2 + 0.75 * c3 + 0.168 * s4);
+    float dhdz = k * (0.5 * c1 + 0.48 * s2 + 0.45 * c3 - 0.72 * s4);
+    return normalize(vec3(-dhdx, 1.0, -dhdz));
+}
+
+void main()
+{
+    vec2 worldXZ = aNode.xy + aGrid * aNode.z;
+    if (aNode.w >= 0.0)
+    {
+        float dist = distance(camPos, vec3(worldXZ.x, terrainHeight(worldXZ), worldXZ.y));
+
+        //przejscie do siatki dwa razy rzadszej (poziomu wyzej) w strefie morphingu - brak "przeskakiwania"
+        vec2 morph = u_morphConsts[int(aNode.w)];
+        float morphK = clamp((dist - morph.x) / (morph.y - morph.x), 0.0, 1.0);
+        vec2 fracPart = fract(aGrid * u_gridDim * 0.5) * 2.0 / u_gridDim;
+        worldXZ = aNode.xy + (aGrid - fracPart * morphK) * aNode.z;
+    }
+
+    FragPos_world = vec3(worldXZ.x, terrainHeight(worldXZ), worldXZ.y);
+    gl_Position = camMatrix * vec4(FragPos_world, 1.0);
+    texCoord = worldXZ * u_texScale;
+    Normal_world = terrainNormal(worldXZ);
+}